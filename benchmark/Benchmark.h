@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_BENCHMARK_BENCHMARK_H
+#define PACKETBUFFER_BENCHMARK_BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace Benchmark {
+
+	/**
+	 * Prevents the compiler from optimizing away the computation of <tt>value</tt>.
+	 *
+	 * @tparam T    the value type
+	 * @param value the value that must be computed
+	 */
+	template<typename T>
+	inline void doNotOptimize(const T& value) {
+		asm volatile("" : : "r,m"(value) : "memory");
+	}
+
+	/**
+	 * Runs <tt>function</tt> in a number of rounds and prints the fastest
+	 * time per operation.
+	 *
+	 * @tparam Function     the benchmarked function type
+	 * @param name          the benchmark name
+	 * @param operations    the number of operations performed by each call to <tt>function</tt>
+	 * @param function      the benchmarked function
+	 *
+	 * @return the fastest time per operation, in nanoseconds
+	 */
+	template<typename Function>
+	double run(const char* name, size_t operations, Function&& function) {
+		constexpr int Rounds = 15;
+
+		double best = 1e300;
+		for(int round = 0; round < Rounds; round++) {
+			auto start = std::chrono::steady_clock::now();
+			function();
+			auto end = std::chrono::steady_clock::now();
+
+			double elapsed = std::chrono::duration<double, std::nano>(end - start).count();
+			best = std::min(best, elapsed / operations);
+		}
+
+		std::printf("%-48s %10.3f ns/op\n", name, best);
+		return best;
+	}
+
+}
+
+#endif //PACKETBUFFER_BENCHMARK_BENCHMARK_H
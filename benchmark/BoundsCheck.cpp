@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <PacketBuffer/PacketBuffer.h>
+
+#include <sstream>
+
+#include "Benchmark.h"
+
+using namespace PacketBuffer;
+
+namespace {
+
+	struct Quote {
+		uint64_t timestamp;
+		uint32_t instrument;
+		int64_t price;
+		uint32_t quantity;
+		uint8_t side;
+		bool last;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(timestamp, instrument, price, quantity, side, last);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			unpacker(timestamp, instrument, price, quantity, side, last);
+		}
+	};
+
+	template<Bounds Checking>
+	void unpackAll(const GrowableBuffer<>& buffer, size_t count) {
+		SpanReader reader(buffer.data(), buffer.size());
+		Unpacker<SpanReader, boost::endian::order::little, IntegerEncoding::Fixed, Checking> unpacker(reader);
+
+		Quote quote;
+		for(size_t i = 0; i < count; i++) {
+			unpacker.unpack(quote);
+			Benchmark::doNotOptimize(quote);
+		}
+		Benchmark::doNotOptimize(unpacker.good());
+	}
+
+}
+
+int main() {
+	constexpr size_t Count = 1000000;
+	constexpr size_t Fields = 6;
+
+	GrowableBuffer<> buffer;
+	Packer<GrowableBuffer<>> packer(buffer);
+	for(size_t i = 0; i < Count; i++) {
+		packer.pack(Quote{i, uint32_t(i % 1000), int64_t(i * 3), uint32_t(i % 7), uint8_t(i & 1), false});
+	}
+
+	std::string packed(buffer.data(), buffer.size());
+	Benchmark::run("Unpacker<std::istream>", Count * Fields, [&] {
+		std::istringstream stream(packed);
+		Unpacker<std::istream> unpacker(stream);
+
+		Quote quote;
+		for(size_t i = 0; i < Count; i++) {
+			unpacker.unpack(quote);
+			Benchmark::doNotOptimize(quote);
+		}
+	});
+	double unchecked = Benchmark::run("Unpacker<SpanReader> (unchecked)", Count * Fields, [&] {
+		unpackAll<Bounds::Unchecked>(buffer, Count);
+	});
+	double checked = Benchmark::run("Unpacker<SpanReader> (Bounds::Checked)", Count * Fields, [&] {
+		unpackAll<Bounds::Checked>(buffer, Count);
+	});
+
+	std::printf("checked / unchecked: %.3f\n", checked / unchecked);
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <PacketBuffer/PacketBuffer.h>
+
+#include <vector>
+
+#include "Benchmark.h"
+
+using namespace PacketBuffer;
+
+namespace {
+
+	template<typename T>
+	void run(const char* type) {
+		constexpr size_t Count = 10000;
+		constexpr size_t Repetitions = 200;
+		using BigPacker = Packer<SpanWriter, boost::endian::order::big>;
+		using BigUnpacker = Unpacker<SpanReader, boost::endian::order::big>;
+
+		std::vector<T> values(Count);
+		for(size_t i = 0; i < Count; i++) {
+			values[i] = static_cast<T>(i * 31);
+		}
+		std::vector<char> storage(Count * sizeof(T));
+		std::vector<T> unpacked(Count);
+
+		std::printf("%s\n", type);
+		Benchmark::run("  pack element by element", Count * Repetitions, [&] {
+			for(size_t r = 0; r < Repetitions; r++) {
+				SpanWriter writer(storage.data(), storage.size());
+				BigPacker packer(writer);
+				for(size_t i = 0; i < Count; i++) {
+					packer.pack(values[i]);
+				}
+				Benchmark::doNotOptimize(storage.data());
+			}
+		});
+		Benchmark::run("  pack with packArray()", Count * Repetitions, [&] {
+			for(size_t r = 0; r < Repetitions; r++) {
+				SpanWriter writer(storage.data(), storage.size());
+				BigPacker packer(writer);
+				packer.packArray(values.data(), values.size());
+				Benchmark::doNotOptimize(storage.data());
+			}
+		});
+		Benchmark::run("  unpack element by element", Count * Repetitions, [&] {
+			for(size_t r = 0; r < Repetitions; r++) {
+				SpanReader reader(storage.data(), storage.size());
+				BigUnpacker unpacker(reader);
+				for(size_t i = 0; i < Count; i++) {
+					unpacker.unpack(unpacked[i]);
+				}
+				Benchmark::doNotOptimize(unpacked.data());
+			}
+		});
+		Benchmark::run("  unpack with unpackArray()", Count * Repetitions, [&] {
+			for(size_t r = 0; r < Repetitions; r++) {
+				SpanReader reader(storage.data(), storage.size());
+				BigUnpacker unpacker(reader);
+				unpacker.unpackArray(unpacked.data(), unpacked.size());
+				Benchmark::doNotOptimize(unpacked.data());
+			}
+		});
+	}
+
+}
+
+int main() {
+	run<uint16_t>("uint16_t");
+	run<uint32_t>("uint32_t");
+	run<uint64_t>("uint64_t");
+	run<float>("float");
+	run<double>("double");
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <PacketBuffer/PacketBuffer.h>
+
+#include <vector>
+
+#include "Benchmark.h"
+
+using namespace PacketBuffer;
+
+namespace {
+
+	template<IntegerEncoding Encoding>
+	void run(const char* name) {
+		constexpr size_t Count = 1000000;
+		using SumUnpacker = Unpacker<SpanReader, boost::endian::order::little, Encoding, Bounds::Checked>;
+
+		std::vector<uint32_t> values(Count);
+		for(size_t i = 0; i < Count; i++) {
+			values[i] = static_cast<uint32_t>(i % 5000);
+		}
+
+		GrowableBuffer<> buffer;
+		Packer<GrowableBuffer<>, boost::endian::order::little, Encoding> packer(buffer);
+		packer.pack(values);
+
+		std::printf("%s\n", name);
+		Benchmark::run("  unpack a std::vector, then sum", Count, [&] {
+			SpanReader reader(buffer.data(), buffer.size());
+			SumUnpacker unpacker(reader);
+			std::vector<uint32_t> unpacked;
+			unpacker.unpack(unpacked);
+			uint64_t sum = 0;
+			for(uint32_t value : unpacked) {
+				sum += value;
+			}
+			Benchmark::doNotOptimize(sum);
+		});
+		Benchmark::run("  sum through an ElementStream", Count, [&] {
+			SpanReader reader(buffer.data(), buffer.size());
+			SumUnpacker unpacker(reader);
+			ElementStream<std::vector<uint32_t>, SumUnpacker> stream(unpacker);
+			uint64_t sum = 0;
+			for(uint32_t value : stream) {
+				sum += value;
+			}
+			Benchmark::doNotOptimize(sum);
+		});
+		Benchmark::run("  sum with unpackEach()", Count, [&] {
+			SpanReader reader(buffer.data(), buffer.size());
+			SumUnpacker unpacker(reader);
+			uint64_t sum = 0;
+			unpackEach<std::vector<uint32_t>>(unpacker, [&](uint32_t value) {
+				sum += value;
+			});
+			Benchmark::doNotOptimize(sum);
+		});
+	}
+
+}
+
+int main() {
+	run<IntegerEncoding::Fixed>("1M uint32_t, fixed size");
+	run<IntegerEncoding::Varint>("1M uint32_t, StreamVByte");
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <PacketBuffer/PacketBuffer.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+
+using namespace PacketBuffer;
+
+namespace {
+
+	struct Packet {
+		uint64_t timestamp;
+		uint32_t instrument;
+		double price;
+		std::string venue;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(timestamp, instrument, price, venue);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			unpacker(timestamp, instrument, price, venue);
+		}
+	};
+
+	/**
+	 * The usual hand-written reassembler: every fragment is appended to a
+	 * receive buffer and every frame is copied out into its own allocation.
+	 */
+	class NaiveReassembler {
+	private:
+		std::vector<char> received;
+		size_t offset = 0;
+
+	public:
+		void feed(const char* data, size_t length) {
+			received.erase(received.begin(), received.begin() + offset);
+			offset = 0;
+			received.insert(received.end(), data, data + length);
+		}
+
+		bool next(std::vector<char>& frame) {
+			uint64_t type;
+			uint64_t length;
+			size_t headerLength;
+			if(FrameHeader::decode(received.data() + offset, received.size() - offset, type, length,
+								   headerLength) != UnpackError::None ||
+			   received.size() - offset - headerLength < length) {
+				return false;
+			}
+			const char* payload = received.data() + offset + headerLength;
+			frame = std::vector<char>(payload, payload + length);
+			offset += headerLength + length;
+			return true;
+		}
+	};
+
+}
+
+int main() {
+	constexpr size_t Count = 100000;
+	constexpr size_t FragmentLength = 4096;
+
+	GrowableBuffer<> stream;
+	FramePacker<GrowableBuffer<>> framer(stream);
+	for(size_t i = 0; i < Count; i++) {
+		framer.pack(1 + i % 8, Packet{i, static_cast<uint32_t>(i % 500), 100.0 + i % 7, "XNAS"});
+	}
+
+	Benchmark::run("FrameReassembler, 4 KiB fragments", Count, [&] {
+		FrameReassembler<> reassembler;
+		Packet packet;
+		for(size_t offset = 0; offset < stream.size(); offset += FragmentLength) {
+			reassembler.feed(stream.data() + offset, std::min(FragmentLength, stream.size() - offset));
+			Frame frame;
+			while(reassembler.next(frame) == UnpackStatus::Complete) {
+				SpanReader reader(frame.payload.data(), frame.payload.size());
+				Unpacker<SpanReader> unpacker(reader);
+				unpacker.unpack(packet);
+			}
+		}
+		Benchmark::doNotOptimize(packet);
+	});
+	Benchmark::run("copy per frame, 4 KiB fragments", Count, [&] {
+		NaiveReassembler reassembler;
+		Packet packet;
+		std::vector<char> frame;
+		for(size_t offset = 0; offset < stream.size(); offset += FragmentLength) {
+			reassembler.feed(stream.data() + offset, std::min(FragmentLength, stream.size() - offset));
+			while(reassembler.next(frame)) {
+				SpanReader reader(frame.data(), frame.size());
+				Unpacker<SpanReader> unpacker(reader);
+				unpacker.unpack(packet);
+			}
+		}
+		Benchmark::doNotOptimize(packet);
+	});
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <PacketBuffer/PacketBuffer.h>
+
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+
+using namespace PacketBuffer;
+
+namespace {
+
+	struct Attribute {
+		std::string key;
+		std::string value;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(key, value);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			unpacker(key, value);
+		}
+	};
+
+	struct Record {
+		uint64_t id;
+		std::string name;
+		std::vector<Attribute> attributes;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(indexed(id, name, indexedArray(attributes)));
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			auto fields = indexed(id, name, indexedArray(attributes));
+			unpacker(fields);
+		}
+	};
+
+}
+
+int main() {
+	constexpr size_t Attributes = 1000;
+	constexpr size_t Repetitions = 1000;
+	using RecordUnpacker = Unpacker<SpanReader, boost::endian::order::little, IntegerEncoding::VarintLength, Bounds::Checked>;
+
+	Record record{1, "record", {}};
+	for(size_t i = 0; i < Attributes; i++) {
+		record.attributes.push_back({"attribute" + std::to_string(i), std::string(i % 32, 'v')});
+	}
+
+	GrowableBuffer<> buffer;
+	Packer<GrowableBuffer<>, boost::endian::order::little, IntegerEncoding::VarintLength> packer(buffer);
+	packer.pack(record);
+
+	std::printf("reading attribute %zu of a record with %zu attributes\n", Attributes - 1, Attributes);
+	Benchmark::run("  unpack the record", Repetitions, [&] {
+		for(size_t r = 0; r < Repetitions; r++) {
+			SpanReader reader(buffer.data(), buffer.size());
+			RecordUnpacker unpacker(reader);
+			Record unpacked;
+			unpacker.unpack(unpacked);
+			Benchmark::doNotOptimize(unpacked.attributes.back().value.size());
+		}
+	});
+	Benchmark::run("  read through an IndexedView", Repetitions, [&] {
+		for(size_t r = 0; r < Repetitions; r++) {
+			SpanReader reader(buffer.data(), buffer.size());
+			RecordUnpacker unpacker(reader);
+			IndexedView<boost::endian::order::little, IntegerEncoding::VarintLength> view;
+			IndexedView<boost::endian::order::little, IntegerEncoding::VarintLength> attributes;
+			Attribute attribute;
+			unpacker.unpack(view);
+			view.get(2, attributes);
+			attributes.get(Attributes - 1, attribute);
+			Benchmark::doNotOptimize(attribute.value.size());
+		}
+	});
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <PacketBuffer/PacketBuffer.h>
+#include <PacketBuffer/Buffer/MappedFileReader.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "Benchmark.h"
+
+using namespace PacketBuffer;
+
+namespace {
+
+	struct Packet {
+		uint64_t timestamp;
+		uint32_t instrument;
+		double price;
+		std::string venue;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(timestamp, instrument, price, venue);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			unpacker(timestamp, instrument, price, venue);
+		}
+	};
+
+}
+
+int main() {
+	constexpr size_t Count = 1000000;
+	const char* path = "/tmp/PacketBuffer.Benchmark.MappedFile";
+
+	{
+		std::ofstream file(path, std::ios::binary);
+		Packer<std::ostream> packer(file);
+		for(size_t i = 0; i < Count; i++) {
+			packer.pack(Packet{i, static_cast<uint32_t>(i % 500), 100.0 + i % 7, "XNAS"});
+		}
+	}
+
+	Benchmark::run("unpack from std::ifstream", Count, [&] {
+		std::ifstream file(path, std::ios::binary);
+		Unpacker<std::istream> unpacker(file);
+		Packet packet;
+		for(size_t i = 0; i < Count; i++) {
+			unpacker.unpack(packet);
+		}
+		Benchmark::doNotOptimize(packet);
+	});
+	Benchmark::run("unpack from MappedFileReader", Count, [&] {
+		MappedFileReader reader(path);
+		Unpacker<MappedFileReader> unpacker(reader);
+		Packet packet;
+		for(size_t i = 0; i < Count; i++) {
+			unpacker.unpack(packet);
+		}
+		Benchmark::doNotOptimize(packet);
+	});
+
+	std::remove(path);
+}
\ No newline at end of file
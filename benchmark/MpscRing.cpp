@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <PacketBuffer/PacketBuffer.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.h"
+
+using namespace PacketBuffer;
+
+namespace {
+
+	struct Packet {
+		uint64_t timestamp;
+		uint32_t instrument;
+		double price;
+		uint32_t quantity;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(timestamp, instrument, price, quantity);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			unpacker(timestamp, instrument, price, quantity);
+		}
+	};
+
+	/**
+	 * A queue of packed messages guarded by a mutex, the baseline MpscRing
+	 * is measured against.
+	 */
+	class MutexQueue {
+	private:
+		std::mutex mutex;
+		std::condition_variable available;
+		std::deque<std::string> messages;
+
+	public:
+		void push(std::string message) {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				messages.push_back(std::move(message));
+			}
+			available.notify_one();
+		}
+
+		std::string pop() {
+			std::unique_lock<std::mutex> lock(mutex);
+			available.wait(lock, [this] { return !messages.empty(); });
+			std::string message = std::move(messages.front());
+			messages.pop_front();
+			return message;
+		}
+	};
+
+	/**
+	 * Runs <tt>producer</tt> on <tt>producers</tt> threads, each sending
+	 * <tt>count</tt> messages, while the calling thread consumes them.
+	 */
+	template<typename Producer, typename Consumer>
+	void spawn(unsigned int producers, size_t count, Producer producer, Consumer consumer) {
+		std::vector<std::thread> threads;
+		for(unsigned int p = 0; p < producers; p++) {
+			threads.emplace_back(producer, count);
+		}
+		consumer(producers * count);
+		for(std::thread& thread : threads) {
+			thread.join();
+		}
+	}
+
+}
+
+int main() {
+	constexpr size_t Count = 1 << 18;
+	constexpr size_t Slots = 4096;
+	constexpr size_t SlotSize = 64;
+	const unsigned int cores = std::max(2u, std::thread::hardware_concurrency());
+
+	std::vector<uint64_t> memory(MpscRing::footprint(Slots, SlotSize) / sizeof(uint64_t));
+
+	for(unsigned int producers = 1; producers < cores; producers++) {
+		const size_t count = Count / producers;
+		char name[64];
+
+		std::snprintf(name, sizeof(name), "MpscRing, %u producers", producers);
+		Benchmark::run(name, count * producers, [&] {
+			MpscRing* ring = MpscRing::create(memory.data(), Slots, SlotSize);
+			spawn(producers, count, [ring](size_t count) {
+				MpscRing::Producer producer(*ring);
+				for(size_t i = 0; i < count; i++) {
+					producer.reserve();
+					Packer<MpscRing::Producer> packer(producer);
+					packer.pack(Packet{i, static_cast<uint32_t>(i % 500), 100.0 + i % 7, 100});
+					producer.commit();
+				}
+			}, [ring](size_t total) {
+				MpscRing::Consumer consumer(*ring);
+				Packet packet;
+				for(size_t i = 0; i < total; i++) {
+					while(!consumer.next()) {
+						std::this_thread::yield();
+					}
+					Unpacker<MpscRing::Consumer> unpacker(consumer);
+					unpacker.unpack(packet);
+					consumer.release();
+				}
+				Benchmark::doNotOptimize(packet);
+			});
+		});
+
+		std::snprintf(name, sizeof(name), "mutex queue, %u producers", producers);
+		Benchmark::run(name, count * producers, [&] {
+			MutexQueue queue;
+			spawn(producers, count, [&queue](size_t count) {
+				for(size_t i = 0; i < count; i++) {
+					char data[SlotSize];
+					SpanWriter writer(data);
+					Packer<SpanWriter> packer(writer);
+					packer.pack(Packet{i, static_cast<uint32_t>(i % 500), 100.0 + i % 7, 100});
+					queue.push(std::string(data, writer.size()));
+				}
+			}, [&queue](size_t total) {
+				Packet packet;
+				for(size_t i = 0; i < total; i++) {
+					const std::string message = queue.pop();
+					SpanReader reader(message.data(), message.size());
+					Unpacker<SpanReader> unpacker(reader);
+					unpacker.unpack(packet);
+				}
+				Benchmark::doNotOptimize(packet);
+			});
+		});
+	}
+}
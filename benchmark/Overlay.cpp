@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <PacketBuffer/PacketBuffer.h>
+
+#include <array>
+#include <vector>
+
+#include "Benchmark.h"
+
+using namespace PacketBuffer;
+
+namespace {
+
+	/**
+	 * A 64 byte order entry header.
+	 */
+	struct OrderHeader {
+		uint64_t sequence;
+		uint64_t timestamp;
+		uint64_t clientOrderId;
+		uint32_t instrument;
+		uint32_t quantity;
+		int64_t price;
+		uint16_t type;
+		uint8_t side;
+		uint8_t flags;
+		uint32_t session;
+		std::array<char, 16> account;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(sequence, timestamp, clientOrderId, instrument, quantity, price, type, side, flags, session, account);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			unpacker(sequence, timestamp, clientOrderId, instrument, quantity, price, type, side, flags, session, account);
+		}
+	};
+
+}
+
+namespace PacketBuffer {
+	template<IntegerEncoding Encoding>
+	struct MaxPackedSize<OrderHeader, Encoding> : MaxPackedSizeOf<Encoding,
+			uint64_t, uint64_t, uint64_t, uint32_t, uint32_t, int64_t, uint16_t, uint8_t, uint8_t, uint32_t,
+			std::array<char, 16>> {
+	};
+}
+
+int main() {
+	constexpr size_t Count = 256;
+	constexpr size_t Repetitions = 4000;
+	using BigPacker = Packer<GrowableBuffer<>, boost::endian::order::big>;
+	using BigUnpacker = Unpacker<SpanReader, boost::endian::order::big, IntegerEncoding::Fixed, Bounds::Checked>;
+	using HeaderOverlay = Overlay<OrderHeader, boost::endian::order::big>;
+	static_assert(HeaderOverlay::size() == 64, "the header must take 64 bytes");
+
+	GrowableBuffer<> buffer;
+	BigPacker packer(buffer);
+	for(size_t i = 0; i < Count; i++) {
+		OrderHeader header = {i, i * 3, i * 7, static_cast<uint32_t>(i % 97), 100, static_cast<int64_t>(i) * 25,
+							  1, static_cast<uint8_t>(i & 1), 0, 42, {}};
+		packer.pack(header);
+	}
+
+	std::printf("reading instrument, price and quantity from a 64 byte header\n");
+	Benchmark::run("  unpack the header", Count * Repetitions, [&] {
+		for(size_t r = 0; r < Repetitions; r++) {
+			uint64_t sum = 0;
+			SpanReader reader(buffer.data(), buffer.size());
+			BigUnpacker unpacker(reader);
+			for(size_t i = 0; i < Count; i++) {
+				OrderHeader header;
+				unpacker.unpack(header);
+				sum += header.instrument + header.price + header.quantity;
+			}
+			Benchmark::doNotOptimize(sum);
+		}
+	});
+	Benchmark::run("  read fields through an Overlay", Count * Repetitions, [&] {
+		for(size_t r = 0; r < Repetitions; r++) {
+			uint64_t sum = 0;
+			for(size_t i = 0; i < Count; i++) {
+				const HeaderOverlay header(buffer.data() + i * HeaderOverlay::size());
+				sum += header.get<3>() + header.get<5>() + header.get<4>();
+			}
+			Benchmark::doNotOptimize(sum);
+		}
+	});
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <PacketBuffer/PacketBuffer.h>
+
+#include <map>
+
+#include "Benchmark.h"
+
+using namespace PacketBuffer;
+
+int main() {
+	constexpr size_t Count = 100000;
+	constexpr size_t Lookups = 5;
+	constexpr size_t Reloads = 10;
+	using TableUnpacker = Unpacker<SpanReader, boost::endian::order::little, IntegerEncoding::Fixed, Bounds::Checked>;
+
+	std::map<uint64_t, double> table;
+	for(size_t i = 0; i < Count; i++) {
+		table[i * 7] = static_cast<double>(i) / 4;
+	}
+
+	GrowableBuffer<> buffer;
+	Packer<GrowableBuffer<>> packer(buffer);
+	packer.pack(table);
+
+	std::printf("reloading a %zu entry map and looking up %zu keys\n", Count, Lookups);
+	Benchmark::run("  unpack the std::map", Reloads, [&] {
+		for(size_t r = 0; r < Reloads; r++) {
+			SpanReader reader(buffer.data(), buffer.size());
+			TableUnpacker unpacker(reader);
+			std::map<uint64_t, double> unpacked;
+			unpacker.unpack(unpacked);
+			double sum = 0;
+			for(size_t i = 0; i < Lookups; i++) {
+				sum += unpacked.find(i * 7 * 9973)->second;
+			}
+			Benchmark::doNotOptimize(sum);
+		}
+	});
+	Benchmark::run("  look up through a PackedMapView", Reloads, [&] {
+		for(size_t r = 0; r < Reloads; r++) {
+			SpanReader reader(buffer.data(), buffer.size());
+			TableUnpacker unpacker(reader);
+			PackedMapView<uint64_t, double> view;
+			unpacker.unpack(view);
+			double sum = 0;
+			for(size_t i = 0; i < Lookups; i++) {
+				sum += (*view.find(i * 7 * 9973)).second;
+			}
+			Benchmark::doNotOptimize(sum);
+		}
+	});
+}
\ No newline at end of file
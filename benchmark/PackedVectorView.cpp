@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <PacketBuffer/PacketBuffer.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "Benchmark.h"
+
+using namespace PacketBuffer;
+
+int main() {
+	constexpr size_t Count = 1000000;
+	constexpr size_t Lookups = 1000;
+	using BigUnpacker = Unpacker<SpanReader, boost::endian::order::big, IntegerEncoding::Fixed, Bounds::Checked>;
+
+	std::vector<uint64_t> timestamps(Count);
+	for(size_t i = 0; i < Count; i++) {
+		timestamps[i] = i * 10;
+	}
+
+	GrowableBuffer<> buffer;
+	Packer<GrowableBuffer<>, boost::endian::order::big> packer(buffer);
+	packer.pack(timestamps);
+
+	std::printf("%zu binary searches in a packed vector of %zu uint64_t\n", Lookups, Count);
+	Benchmark::run("  unpack the vector, then search", Lookups, [&] {
+		SpanReader reader(buffer.data(), buffer.size());
+		BigUnpacker unpacker(reader);
+		std::vector<uint64_t> unpacked;
+		unpacker.unpack(unpacked);
+		size_t found = 0;
+		for(size_t i = 0; i < Lookups; i++) {
+			found += std::lower_bound(unpacked.begin(), unpacked.end(), i * 9973) - unpacked.begin();
+		}
+		Benchmark::doNotOptimize(found);
+	});
+	Benchmark::run("  search through a PackedVectorView", Lookups, [&] {
+		SpanReader reader(buffer.data(), buffer.size());
+		BigUnpacker unpacker(reader);
+		PackedVectorView<uint64_t, boost::endian::order::big> view;
+		unpacker.unpack(view);
+		size_t found = 0;
+		for(size_t i = 0; i < Lookups; i++) {
+			found += std::lower_bound(view.begin(), view.end(), i * 9973) - view.begin();
+		}
+		Benchmark::doNotOptimize(found);
+	});
+}
\ No newline at end of file
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <PacketBuffer/PacketBuffer.h>
+
+#include <vector>
+
+#include "Benchmark.h"
+
+using namespace PacketBuffer;
+
+namespace {
+
+	constexpr size_t Count = 10000;
+	constexpr size_t Repetitions = 200;
+
+	/**
+	 * A message made of scalars, whose fields are packed one by one
+	 */
+	struct Message {
+		uint64_t id;
+		uint32_t sequence;
+		int16_t delta;
+		uint16_t flags;
+		double value;
+
+		Message() = default;
+		explicit Message(size_t i) : id(i), sequence(static_cast<uint32_t>(i)), delta(static_cast<int16_t>(i)),
+									 flags(static_cast<uint16_t>(i)), value(static_cast<double>(i)) {}
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(id, sequence, delta, flags, value);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			unpacker(id, sequence, delta, flags, value);
+		}
+	};
+
+	template<typename Packer>
+	void setEndianess(Packer& packer, boost::endian::order endianess, std::true_type) {
+		packer.setEndianess(endianess);
+	}
+
+	template<typename Packer>
+	void setEndianess(Packer&, boost::endian::order, std::false_type) {
+	}
+
+	template<typename Policy, typename T>
+	void run(const char* name, boost::endian::order endianess, const std::vector<T>& values) {
+		using BenchmarkPacker = BasicPacker<SpanWriter, Policy>;
+		using BenchmarkUnpacker = BasicUnpacker<SpanReader, Policy>;
+		using IsRuntime = std::integral_constant<bool, Policy::runtimeEndianess>;
+
+		// packed bytes may alias anything, so the loops read the values through a pointer that
+		// is not reloaded from the vector after every store
+		const T* source = values.data();
+		std::vector<char> storage(Count * sizeof(T));
+		std::vector<T> unpacked(Count);
+
+		std::printf("  %s\n", name);
+		Benchmark::run("    pack element by element", Count * Repetitions, [&] {
+			for(size_t r = 0; r < Repetitions; r++) {
+				SpanWriter writer(storage.data(), storage.size());
+				BenchmarkPacker packer(writer);
+				setEndianess(packer, endianess, IsRuntime());
+				for(size_t i = 0; i < Count; i++) {
+					packer.pack(source[i]);
+				}
+				Benchmark::doNotOptimize(storage.data());
+			}
+		});
+		Benchmark::run("    pack with withEndianess()", Count * Repetitions, [&] {
+			for(size_t r = 0; r < Repetitions; r++) {
+				SpanWriter writer(storage.data(), storage.size());
+				BenchmarkPacker packer(writer);
+				setEndianess(packer, endianess, IsRuntime());
+				packer.withEndianess([&](auto& packer) {
+					for(size_t i = 0; i < Count; i++) {
+						packer.pack(source[i]);
+					}
+				});
+				Benchmark::doNotOptimize(storage.data());
+			}
+		});
+		Benchmark::run("    pack with packArray()", Count * Repetitions, [&] {
+			for(size_t r = 0; r < Repetitions; r++) {
+				SpanWriter writer(storage.data(), storage.size());
+				BenchmarkPacker packer(writer);
+				setEndianess(packer, endianess, IsRuntime());
+				packer.packArray(source, Count);
+				Benchmark::doNotOptimize(storage.data());
+			}
+		});
+		Benchmark::run("    unpack element by element", Count * Repetitions, [&] {
+			for(size_t r = 0; r < Repetitions; r++) {
+				SpanReader reader(storage.data(), storage.size());
+				BenchmarkUnpacker unpacker(reader);
+				setEndianess(unpacker, endianess, IsRuntime());
+				for(size_t i = 0; i < Count; i++) {
+					unpacker.unpack(unpacked[i]);
+				}
+				Benchmark::doNotOptimize(unpacked.data());
+			}
+		});
+		Benchmark::run("    unpack with withEndianess()", Count * Repetitions, [&] {
+			for(size_t r = 0; r < Repetitions; r++) {
+				SpanReader reader(storage.data(), storage.size());
+				BenchmarkUnpacker unpacker(reader);
+				setEndianess(unpacker, endianess, IsRuntime());
+				unpacker.withEndianess([&](auto& unpacker) {
+					for(size_t i = 0; i < Count; i++) {
+						unpacker.unpack(unpacked[i]);
+					}
+				});
+				Benchmark::doNotOptimize(unpacked.data());
+			}
+		});
+		Benchmark::run("    unpack with unpackArray()", Count * Repetitions, [&] {
+			for(size_t r = 0; r < Repetitions; r++) {
+				SpanReader reader(storage.data(), storage.size());
+				BenchmarkUnpacker unpacker(reader);
+				setEndianess(unpacker, endianess, IsRuntime());
+				unpacker.unpackArray(unpacked.data(), unpacked.size());
+				Benchmark::doNotOptimize(unpacked.data());
+			}
+		});
+	}
+
+	template<typename T>
+	void run(const char* type) {
+		std::vector<T> values(Count);
+		for(size_t i = 0; i < Count; i++) {
+			values[i] = static_cast<T>(i * 31);
+		}
+
+		std::printf("%s\n", type);
+		run<PackingPolicy<boost::endian::order::little>>("static little endian", boost::endian::order::little, values);
+		run<RuntimeEndianPolicy<>>("runtime little endian", boost::endian::order::little, values);
+		run<PackingPolicy<boost::endian::order::big>>("static big endian", boost::endian::order::big, values);
+		run<RuntimeEndianPolicy<>>("runtime big endian", boost::endian::order::big, values);
+	}
+
+}
+
+int main() {
+	run<uint16_t>("uint16_t");
+	run<uint32_t>("uint32_t");
+	run<uint64_t>("uint64_t");
+	run<double>("double");
+	run<Message>("Message");
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <PacketBuffer/PacketBuffer.h>
+
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+
+using namespace PacketBuffer;
+
+namespace {
+
+	template<IntegerEncoding Encoding>
+	void run(const char* name, const std::vector<uint32_t>& values, bool elementWise) {
+		constexpr size_t Repetitions = 200;
+		using VarintPacker = Packer<SpanWriter, boost::endian::order::little, Encoding>;
+		using VarintUnpacker = Unpacker<SpanReader, boost::endian::order::little, Encoding, Bounds::Unchecked>;
+
+		std::vector<char> storage(values.size() * 5 + 16);
+		SpanWriter writer(storage.data(), storage.size());
+		VarintPacker packer(writer);
+		if(elementWise) {
+			for(uint32_t value : values) {
+				packer.pack(value);
+			}
+		} else {
+			packer.packArray(values.data(), values.size());
+		}
+
+		std::vector<uint32_t> unpacked(values.size());
+		std::printf("%s (%.2f bytes/value)\n", name, double(writer.size()) / values.size());
+		Benchmark::run("  unpack", values.size() * Repetitions, [&] {
+			for(size_t r = 0; r < Repetitions; r++) {
+				SpanReader reader(storage.data(), writer.size());
+				VarintUnpacker unpacker(reader);
+				if(elementWise) {
+					for(uint32_t& value : unpacked) {
+						unpacker.unpack(value);
+					}
+				} else {
+					unpacker.unpackArray(unpacked.data(), unpacked.size());
+				}
+				Benchmark::doNotOptimize(unpacked.data());
+			}
+		});
+	}
+
+}
+
+int main() {
+	constexpr size_t Count = 100000;
+
+	/*
+	 * Mostly small identifiers: 80% below 2^8, 15% below 2^16, the rest
+	 * spread over the whole range.
+	 */
+	std::mt19937 random(42);
+	std::vector<uint32_t> values(Count);
+	for(uint32_t& value : values) {
+		const uint32_t kind = random() % 100;
+		value = kind < 80 ? random() % 0x100 : kind < 95 ? random() % 0x10000 : random();
+	}
+
+	run<IntegerEncoding::Fixed>("fixed size", values, false);
+	run<IntegerEncoding::Varint>("LEB128 varint", values, true);
+	run<IntegerEncoding::Varint>("StreamVByte", values, false);
+}
\ No newline at end of file
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_BUFFER_ARENAALLOCATOR_H
+#define PACKETBUFFER_BUFFER_ARENAALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace PacketBuffer {
+
+	/**
+	 * A bump allocator over a caller-provided memory region.
+	 *
+	 * Memory is handed out linearly and is only given back when the most
+	 * recent allocation is released or when the whole arena is reset().
+	 * The arena does not own the memory region.
+	 */
+	class Arena {
+	private:
+		/**
+		 * The first byte of the memory region
+		 */
+		char* const first;
+
+		/**
+		 * The next free byte
+		 */
+		char* current;
+
+		/**
+		 * One past the last byte of the memory region
+		 */
+		char* const last;
+
+	public:
+		/**
+		 * Creates a new Arena over the memory region starting at
+		 * <tt>data</tt> with <tt>size</tt> bytes.
+		 *
+		 * @param data  the memory region to allocate from
+		 * @param size  the memory region size
+		 */
+		Arena(char* data, size_t size) : first(data), current(data), last(data + size) {};
+
+		/**
+		 * Deleted copy constructor.
+		 */
+		Arena(const Arena& other) = delete;
+
+		/**
+		 * Deleted copy assignment operator.
+		 */
+		Arena& operator=(const Arena& other) = delete;
+
+	public:
+		/**
+		 * Allocates <tt>size</tt> bytes aligned to <tt>alignment</tt>.
+		 *
+		 * @param size      the number of bytes to allocate
+		 * @param alignment the required alignment
+		 *
+		 * @return the allocated memory or <tt>nullptr</tt> if the arena is exhausted
+		 */
+		void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) noexcept {
+			auto address = reinterpret_cast<uintptr_t>(current);
+			auto padding = static_cast<size_t>(-address & (alignment - 1));
+			if(padding + size > static_cast<size_t>(last - current)) {
+				return nullptr;
+			}
+			char* memory = current + padding;
+			current = memory + size;
+			return memory;
+		}
+
+		/**
+		 * Releases a previous allocation. Only the most recent allocation is
+		 * actually given back to the arena.
+		 *
+		 * @param memory    the memory returned by allocate()
+		 * @param size      the size given to allocate()
+		 */
+		void deallocate(void* memory, size_t size) noexcept {
+			if(static_cast<char*>(memory) + size == current) {
+				current = static_cast<char*>(memory);
+			}
+		}
+
+		/**
+		 * Grows a previous allocation in place. Only the most recent
+		 * allocation can grow.
+		 *
+		 * @param memory    the memory returned by allocate()
+		 * @param size      the size given to allocate()
+		 * @param required  the new allocation size
+		 *
+		 * @return true if the allocation has grown to <tt>required</tt> bytes
+		 */
+		bool extend(void* memory, size_t size, size_t required) noexcept {
+			char* end = static_cast<char*>(memory) + size;
+			if(end != current || required < size || required - size > static_cast<size_t>(last - current)) {
+				return false;
+			}
+			current = static_cast<char*>(memory) + required;
+			return true;
+		}
+
+		/**
+		 * Releases every allocation at once.
+		 */
+		void reset() noexcept {
+			current = first;
+		}
+
+		/**
+		 * @return the number of bytes currently in use
+		 */
+		size_t used() const noexcept {
+			return static_cast<size_t>(current - first);
+		}
+
+		/**
+		 * @return the memory region size
+		 */
+		size_t capacity() const noexcept {
+			return static_cast<size_t>(last - first);
+		}
+
+	};
+
+	/**
+	 * A standard allocator that obtains its memory from an Arena.
+	 *
+	 * Copies of the allocator share the same arena. Allocations that do not
+	 * fit in the arena throw <tt>std::bad_alloc</tt>.
+	 *
+	 * @tparam T the allocated type
+	 */
+	template<typename T>
+	class ArenaAllocator {
+	public:
+		using value_type = T;
+
+	private:
+		template<typename U>
+		friend class ArenaAllocator;
+
+		/**
+		 * The arena memory is obtained from
+		 */
+		Arena* arena;
+
+	public:
+		/**
+		 * Creates a new ArenaAllocator that allocates from <tt>arena</tt>.
+		 *
+		 * @param arena the arena to allocate from
+		 */
+		ArenaAllocator(Arena& arena) noexcept : arena(&arena) {};
+
+		/**
+		 * Creates a new ArenaAllocator that shares the arena of <tt>other</tt>.
+		 *
+		 * @param other the allocator to share the arena with
+		 */
+		template<typename U>
+		ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {};
+
+	public:
+		T* allocate(size_t n) {
+			void* memory = arena->allocate(n * sizeof(T), alignof(T));
+			if(!memory) {
+#if defined(__cpp_exceptions)
+				throw std::bad_alloc();
+#else
+				std::abort();
+#endif
+			}
+			return static_cast<T*>(memory);
+		}
+
+		void deallocate(T* memory, size_t n) noexcept {
+			arena->deallocate(memory, n * sizeof(T));
+		}
+
+		/**
+		 * Grows a previous allocation in place, if it is the most recent
+		 * one in the arena. A GrowableBuffer tries this before moving to a
+		 * new allocation, which the arena could not reclaim.
+		 *
+		 * @param memory    the memory returned by allocate()
+		 * @param n         the number of objects given to allocate()
+		 * @param required  the new number of objects
+		 *
+		 * @return true if the allocation has grown
+		 */
+		bool extend(T* memory, size_t n, size_t required) noexcept {
+			return arena->extend(memory, n * sizeof(T), required * sizeof(T));
+		}
+
+		template<typename U>
+		bool operator==(const ArenaAllocator<U>& other) const noexcept {
+			return arena == other.arena;
+		}
+
+		template<typename U>
+		bool operator!=(const ArenaAllocator<U>& other) const noexcept {
+			return arena != other.arena;
+		}
+
+	};
+
+}
+
+#endif //PACKETBUFFER_BUFFER_ARENAALLOCATOR_H
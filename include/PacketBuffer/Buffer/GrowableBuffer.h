@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_BUFFER_GROWABLEBUFFER_H
+#define PACKETBUFFER_BUFFER_GROWABLEBUFFER_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+namespace PacketBuffer {
+
+	/**
+	 * The size that <tt>Allocator</tt> rounds allocations up to, given by
+	 * its <tt>Granularity</tt> member if it has one, such as
+	 * HugePageAllocator.
+	 *
+	 * @tparam Allocator the allocator type
+	 */
+	template<typename Allocator, typename = void>
+	struct AllocationGranularity : std::integral_constant<size_t, 1> {
+	};
+
+	template<typename Allocator>
+	struct AllocationGranularity<Allocator, decltype(void(Allocator::Granularity))> :
+			std::integral_constant<size_t, Allocator::Granularity> {
+	};
+
+	/**
+	 * Tells whether <tt>Allocator</tt> can grow an allocation in place with
+	 * an <tt>extend(pointer, size, required)</tt> method, such as
+	 * ArenaAllocator.
+	 *
+	 * @tparam Allocator the allocator type
+	 */
+	template<typename Allocator, typename = void>
+	struct CanExtendInPlace : std::false_type {
+	};
+
+	template<typename Allocator>
+	struct CanExtendInPlace<Allocator, decltype(void(std::declval<Allocator&>().extend(
+			std::declval<typename Allocator::value_type*>(), size_t(), size_t())))> : std::true_type {
+	};
+
+	/**
+	 * A Packer buffer that owns a contiguous, geometrically growing memory
+	 * region.
+	 *
+	 * Calling reset() rewinds the buffer without releasing its memory, so a
+	 * buffer reused across messages stops allocating once it has grown to
+	 * the largest message size.
+	 *
+	 * Memory is obtained from an allocator of type <tt>Allocator</tt>. Besides
+	 * <tt>std::allocator</tt>, an ArenaAllocator can be used to draw memory
+	 * from a caller-provided region and a HugePageAllocator to back the
+	 * buffer with transparent huge pages.
+	 *
+	 * @code
+	 *  GrowableBuffer<> buffer(4096);
+	 *  Packer<GrowableBuffer<>> packer(buffer);
+	 *  for(auto& message : messages) {
+	 *      buffer.reset();
+	 *      packer.pack(message);
+	 *      send(buffer.data(), buffer.size());
+	 *  }
+	 * @endcode
+	 *
+	 * @tparam Allocator the allocator used to obtain memory
+	 */
+	template<typename Allocator = std::allocator<char>>
+	class GrowableBuffer {
+	public:
+		/**
+		 * The allocator type, rebound to <tt>char</tt>
+		 */
+		using AllocatorType = typename std::allocator_traits<Allocator>::template rebind_alloc<char>;
+
+	private:
+		using AllocatorTraits = std::allocator_traits<AllocatorType>;
+
+		/**
+		 * The size that allocations are rounded up to
+		 */
+		static constexpr size_t Granularity = AllocationGranularity<AllocatorType>::value;
+
+		/**
+		 * The minimum number of bytes allocated on the first growth. With a
+		 * HugePageAllocator, that is a whole huge page.
+		 */
+		static constexpr size_t MinimumCapacity = Granularity > 64 ? Granularity : 64;
+
+		/**
+		 * The allocator used to obtain memory
+		 */
+		AllocatorType allocator;
+
+		/**
+		 * The first byte of the memory region
+		 */
+		char* first = nullptr;
+
+		/**
+		 * The number of bytes written so far
+		 */
+		size_t used = 0;
+
+		/**
+		 * The number of bytes allocated
+		 */
+		size_t allocated = 0;
+
+	public:
+		/**
+		 * Creates a new GrowableBuffer.
+		 *
+		 * @param capacity  the number of bytes to allocate upfront
+		 * @param allocator the allocator used to obtain memory
+		 */
+		explicit GrowableBuffer(size_t capacity = 0, const Allocator& allocator = Allocator()) :
+				allocator(allocator) {
+			reserve(capacity);
+		}
+
+		/**
+		 * Deleted copy constructor.
+		 */
+		GrowableBuffer(const GrowableBuffer& other) = delete;
+
+		/**
+		 * Deleted copy assignment operator.
+		 */
+		GrowableBuffer& operator=(const GrowableBuffer& other) = delete;
+
+		/**
+		 * Move constructor. The moved-from buffer is left empty.
+		 */
+		GrowableBuffer(GrowableBuffer&& other) noexcept :
+				allocator(std::move(other.allocator)),
+				first(other.first), used(other.used), allocated(other.allocated) {
+			other.first = nullptr;
+			other.used = 0;
+			other.allocated = 0;
+		}
+
+		/**
+		 * Deleted move assignment operator.
+		 */
+		GrowableBuffer& operator=(GrowableBuffer&& other) = delete;
+
+		/**
+		 * Releases the memory region.
+		 */
+		~GrowableBuffer() {
+			if(first) {
+				AllocatorTraits::deallocate(allocator, first, allocated);
+			}
+		}
+
+	public: // Buffer interface
+		/**
+		 * Appends <tt>length</tt> bytes from <tt>data</tt> to the buffer,
+		 * growing it if necessary.
+		 *
+		 * @param data      the data to be written
+		 * @param length    the number of bytes to be written
+		 */
+		inline void write(const char* data, size_t length) {
+			if(length == 0) {
+				return;
+			}
+			if(length > allocated - used) {
+				grow(used + length);
+			}
+			std::memcpy(first + used, data, length);
+			used += length;
+		}
+
+		/**
+		 * Appends <tt>length</tt> bytes from <tt>data</tt> to the buffer,
+		 * growing it if necessary.
+		 *
+		 * @param data      the data to be written
+		 * @param length    the number of bytes to be written
+		 */
+		inline void write(const unsigned char* data, size_t length) {
+			write(reinterpret_cast<const char*>(data), length);
+		}
+
+	public:
+		/**
+		 * Ensures that at least <tt>capacity</tt> bytes are allocated.
+		 *
+		 * @param capacity the number of bytes to reserve
+		 */
+		void reserve(size_t capacity) {
+			if(capacity > allocated) {
+				reallocate(capacity);
+			}
+		}
+
+		/**
+		 * Ensures that at least <tt>length</tt> bytes can be written past the
+		 * written data without growing, so that they can be filled directly,
+		 * for instance by <tt>recv()</tt>.
+		 *
+		 * @param length the number of bytes to be written
+		 *
+		 * @return the first byte past the written data
+		 */
+		char* prepare(size_t length) {
+			if(length > allocated - used) {
+				grow(used + length);
+			}
+			return first + used;
+		}
+
+		/**
+		 * Appends <tt>length</tt> bytes previously filled through prepare()
+		 * to the written data.
+		 *
+		 * @param length the number of bytes filled
+		 */
+		void commit(size_t length) noexcept {
+			assert(length <= allocated - used && "GrowableBuffer commit past the prepared bytes");
+			used += length;
+		}
+
+		/**
+		 * Discards the first <tt>length</tt> bytes of the written data and
+		 * moves the remaining bytes to the start of the buffer.
+		 *
+		 * @param length the number of bytes to be discarded
+		 */
+		void consume(size_t length) noexcept {
+			assert(length <= used && "GrowableBuffer consume past the written data");
+			if(length == 0) {
+				return;
+			}
+			std::memmove(first, first + length, used - length);
+			used -= length;
+		}
+
+		/**
+		 * Discards the written data but keeps the allocated memory for reuse.
+		 */
+		void reset() noexcept {
+			used = 0;
+		}
+
+		/**
+		 * @return the first byte of the written data
+		 */
+		char* data() const noexcept {
+			return first;
+		}
+
+		/**
+		 * @return the number of bytes written so far
+		 */
+		size_t size() const noexcept {
+			return used;
+		}
+
+		/**
+		 * @return the number of bytes allocated
+		 */
+		size_t capacity() const noexcept {
+			return allocated;
+		}
+
+		/**
+		 * @return the allocator used to obtain memory
+		 */
+		const AllocatorType& getAllocator() const noexcept {
+			return allocator;
+		}
+
+	private:
+		/**
+		 * Grows the buffer geometrically so that it fits at least
+		 * <tt>required</tt> bytes.
+		 *
+		 * @param required the minimum number of bytes required
+		 */
+		void grow(size_t required) {
+			size_t capacity = allocated ? allocated * 2 : size_t(MinimumCapacity);
+			reallocate(std::max(required, capacity));
+		}
+
+		/**
+		 * Moves the written data into a new memory region with at least
+		 * <tt>capacity</tt> bytes, rounded up to the allocator granularity.
+		 * Allocators that can grow the current region in place do so instead.
+		 *
+		 * @param capacity the new memory region size
+		 */
+		void reallocate(size_t capacity) {
+			if(Granularity > 1) {
+				capacity = (capacity + Granularity - 1) / Granularity * Granularity;
+			}
+			if(first && extend(capacity, CanExtendInPlace<AllocatorType>())) {
+				allocated = capacity;
+				return;
+			}
+
+			char* region = AllocatorTraits::allocate(allocator, capacity);
+			if(first) {
+				std::memcpy(region, first, used);
+				AllocatorTraits::deallocate(allocator, first, allocated);
+			}
+			first = region;
+			allocated = capacity;
+		}
+
+		bool extend(size_t capacity, std::true_type) noexcept {
+			return allocator.extend(first, allocated, capacity);
+		}
+
+		bool extend(size_t, std::false_type) noexcept {
+			return false;
+		}
+
+	};
+
+}
+
+#endif //PACKETBUFFER_BUFFER_GROWABLEBUFFER_H
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_BUFFER_HUGEPAGEALLOCATOR_H
+#define PACKETBUFFER_BUFFER_HUGEPAGEALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include <sys/mman.h>
+
+namespace PacketBuffer {
+
+	/**
+	 * A standard allocator that maps anonymous memory directly from the
+	 * kernel and, where supported, asks for it to be backed by transparent
+	 * huge pages with <tt>madvise(MADV_HUGEPAGE)</tt>.
+	 *
+	 * Allocations are rounded up to a multiple of the huge page size, so this
+	 * allocator is only worthwhile for large, long-lived regions such as the
+	 * storage of a reused GrowableBuffer.
+	 *
+	 * @note This allocator requires a POSIX system and is not included by
+	 * <tt>PacketBuffer.h</tt>.
+	 *
+	 * @tparam T the allocated type
+	 */
+	template<typename T>
+	class HugePageAllocator {
+	public:
+		using value_type = T;
+
+		/**
+		 * The granularity in which memory is mapped
+		 */
+		static constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+		/**
+		 * The size that allocations are rounded up to. A GrowableBuffer
+		 * grows in multiples of it, so that no mapped memory goes unused.
+		 */
+		static constexpr size_t Granularity = HugePageSize;
+
+	public:
+		HugePageAllocator() noexcept = default;
+
+		template<typename U>
+		HugePageAllocator(const HugePageAllocator<U>&) noexcept {};
+
+	public:
+		T* allocate(size_t n) {
+			const size_t size = roundUp(n * sizeof(T));
+
+			/*
+			 * mmap() only guarantees page alignment. A huge page more than
+			 * needed is mapped, and the unaligned head and tail are unmapped,
+			 * so that every huge page of the region can be backed by one.
+			 */
+			void* memory = mmap(nullptr, size + HugePageSize, PROT_READ | PROT_WRITE,
+								MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if(memory == MAP_FAILED) {
+#if defined(__cpp_exceptions)
+				throw std::bad_alloc();
+#else
+				std::abort();
+#endif
+			}
+
+			char* mapped = static_cast<char*>(memory);
+			char* aligned = reinterpret_cast<char*>(roundUp(reinterpret_cast<uintptr_t>(mapped)));
+			if(aligned != mapped) {
+				munmap(mapped, static_cast<size_t>(aligned - mapped));
+			}
+			const size_t tail = HugePageSize - static_cast<size_t>(aligned - mapped);
+			if(tail != 0) {
+				munmap(aligned + size, tail);
+			}
+#if defined(MADV_HUGEPAGE)
+			madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+			return reinterpret_cast<T*>(aligned);
+		}
+
+		void deallocate(T* memory, size_t n) noexcept {
+			munmap(memory, roundUp(n * sizeof(T)));
+		}
+
+		template<typename U>
+		bool operator==(const HugePageAllocator<U>&) const noexcept {
+			return true;
+		}
+
+		template<typename U>
+		bool operator!=(const HugePageAllocator<U>&) const noexcept {
+			return false;
+		}
+
+	private:
+		static uintptr_t roundUp(uintptr_t size) noexcept {
+			return (size + HugePageSize - 1) & ~(HugePageSize - 1);
+		}
+
+	};
+
+}
+
+#endif //PACKETBUFFER_BUFFER_HUGEPAGEALLOCATOR_H
@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_BUFFER_IOVECBUFFER_H
+#define PACKETBUFFER_BUFFER_IOVECBUFFER_H
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include "GrowableBuffer.h"
+
+namespace PacketBuffer {
+
+	/**
+	 * A Packer buffer that gathers packed data into an <tt>iovec</tt> array,
+	 * ready for <tt>writev()</tt> or <tt>sendmsg()</tt>.
+	 *
+	 * Small writes, such as integers and headers, are copied into a staging
+	 * region owned by the buffer. Writes of at least <tt>threshold</tt>
+	 * bytes, such as large strings and byte vectors, are referenced in place
+	 * instead of being copied. The packed objects must therefore stay alive
+	 * and unmodified until the <tt>iovec</tt> array has been written, which
+	 * rules out packing temporaries, such as a string returned by value.
+	 * Serializers must in turn pack the elements of a container through
+	 * references, never through copies.
+	 *
+	 * writeTo() writes the packed data with as many <tt>writev()</tt> calls
+	 * as needed: a large container easily packs to more vectors than the
+	 * IOV_MAX a single call accepts, and a socket may accept only part of
+	 * the data. On a non-blocking socket, writeTo() can be called again
+	 * once writable to continue where it stopped.
+	 *
+	 * @code
+	 *  IovecBuffer<> buffer;
+	 *  Packer<IovecBuffer<>> packer(buffer);
+	 *  packer.pack(header, payload);
+	 *  if(!buffer.writeTo(socket) && errno != EAGAIN) {
+	 *      // the connection failed
+	 *  }
+	 * @endcode
+	 *
+	 * @note This buffer requires a POSIX system and is not included by
+	 * <tt>PacketBuffer.h</tt>.
+	 *
+	 * @tparam Allocator the allocator used for the staging region
+	 */
+	template<typename Allocator = std::allocator<char>>
+	class IovecBuffer {
+	public:
+		/**
+		 * The default size from which writes are referenced instead of copied
+		 */
+		static constexpr size_t DefaultThreshold = 16 * 1024;
+
+		/**
+		 * The smallest accepted threshold. The Packer writes converted data
+		 * from its own stack buffers in pieces of at most 4096 bytes, which
+		 * must always be copied.
+		 */
+		static constexpr size_t MinimumThreshold = 4096 + 1;
+
+		/**
+		 * The maximum number of vectors given to a single <tt>writev()</tt>
+		 */
+#if defined(IOV_MAX)
+		static constexpr size_t MaxVectors = IOV_MAX;
+#else
+		static constexpr size_t MaxVectors = 1024;
+#endif
+
+	private:
+		/**
+		 * A piece of the packed data. Staged segments have no
+		 * <tt>data</tt> and start at <tt>offset</tt> in the staging region.
+		 */
+		struct Segment {
+			const char* data;
+			size_t offset;
+			size_t length;
+		};
+
+		/**
+		 * The copies of small writes
+		 */
+		GrowableBuffer<Allocator> staging;
+
+		/**
+		 * The pieces of the packed data, in order
+		 */
+		std::vector<Segment> segments;
+
+		/**
+		 * The <tt>iovec</tt> array built by vectors()
+		 */
+		std::vector<struct iovec> iovecs;
+
+		/**
+		 * The size from which writes are referenced instead of copied
+		 */
+		size_t threshold;
+
+		/**
+		 * The total number of bytes written
+		 */
+		size_t written = 0;
+
+		/**
+		 * The number of bytes already written out by writeTo()
+		 */
+		size_t sent = 0;
+
+	public:
+		/**
+		 * Creates a new IovecBuffer.
+		 *
+		 * @param threshold the size from which writes are referenced instead of copied
+		 * @param allocator the allocator used for the staging region
+		 */
+		explicit IovecBuffer(size_t threshold = DefaultThreshold, const Allocator& allocator = Allocator()) :
+				staging(0, allocator), threshold(threshold < MinimumThreshold ? MinimumThreshold : threshold) {}
+
+	public: // Buffer interface
+		/**
+		 * Appends <tt>length</tt> bytes from <tt>data</tt>, copying them if
+		 * they are fewer than the threshold and referencing them otherwise.
+		 *
+		 * @param data      the data to be written
+		 * @param length    the number of bytes to be written
+		 */
+		inline void write(const char* data, size_t length) {
+			if(length >= threshold) {
+				segments.push_back(Segment{data, 0, length});
+			} else if(!segments.empty() && segments.back().data == nullptr) {
+				staging.write(data, length);
+				segments.back().length += length;
+			} else {
+				segments.push_back(Segment{nullptr, staging.size(), length});
+				staging.write(data, length);
+			}
+			written += length;
+		}
+
+		/**
+		 * Appends <tt>length</tt> bytes from <tt>data</tt>, copying them if
+		 * they are fewer than the threshold and referencing them otherwise.
+		 *
+		 * @param data      the data to be written
+		 * @param length    the number of bytes to be written
+		 */
+		inline void write(const unsigned char* data, size_t length) {
+			write(reinterpret_cast<const char*>(data), length);
+		}
+
+	public:
+		/**
+		 * Builds the <tt>iovec</tt> array of the packed data. The array is
+		 * invalidated by further writes and by reset(). A single
+		 * <tt>writev()</tt> or <tt>sendmsg()</tt> accepts at most MaxVectors
+		 * of them; writeTo() takes care of splitting the array.
+		 *
+		 * @return the first <tt>iovec</tt> of the array
+		 */
+		const struct iovec* vectors() {
+			iovecs.resize(segments.size());
+			for(size_t i = 0; i < segments.size(); i++) {
+				const Segment& segment = segments[i];
+				const char* base = segment.data ? segment.data : staging.data() + segment.offset;
+				iovecs[i].iov_base = const_cast<char*>(base);
+				iovecs[i].iov_len = segment.length;
+			}
+			return iovecs.data();
+		}
+
+		/**
+		 * Writes the packed data that was not written out yet to the file
+		 * descriptor <tt>fd</tt>, in batches of at most MaxVectors vectors.
+		 * Short writes are continued and interrupted calls are restarted.
+		 *
+		 * @param fd the file descriptor, such as a connected socket
+		 *
+		 * @return true once all the packed data has been written, or false
+		 * if <tt>writev()</tt> failed, with <tt>errno</tt> set. After
+		 * <tt>EAGAIN</tt>, calling writeTo() again resumes the write.
+		 */
+		bool writeTo(int fd) {
+			vectors();
+			size_t first = 0;
+			size_t skipped = sent;
+			while(sent < written) {
+				while(skipped >= iovecs[first].iov_len) {
+					skipped -= iovecs[first].iov_len;
+					first++;
+				}
+				iovecs[first].iov_base = static_cast<char*>(iovecs[first].iov_base) + skipped;
+				iovecs[first].iov_len -= skipped;
+
+				const size_t batch = std::min(iovecs.size() - first, MaxVectors);
+				const ssize_t result = ::writev(fd, iovecs.data() + first, static_cast<int>(batch));
+				if(result < 0) {
+					if(errno == EINTR) {
+						skipped = 0;
+						continue;
+					}
+					return false;
+				}
+				sent += static_cast<size_t>(result);
+				skipped = static_cast<size_t>(result);
+			}
+			return true;
+		}
+
+		/**
+		 * @return the number of bytes that writeTo() did not write out yet
+		 */
+		size_t pending() const noexcept {
+			return written - sent;
+		}
+
+		/**
+		 * @return the number of <tt>iovec</tt> in the array built by vectors(),
+		 * which may exceed MaxVectors
+		 */
+		size_t count() const noexcept {
+			return segments.size();
+		}
+
+		/**
+		 * @return the total number of bytes written
+		 */
+		size_t size() const noexcept {
+			return written;
+		}
+
+		/**
+		 * Discards the written data but keeps the allocated memory for reuse.
+		 */
+		void reset() noexcept {
+			staging.reset();
+			segments.clear();
+			written = 0;
+			sent = 0;
+		}
+
+	};
+
+	template<typename Allocator>
+	constexpr size_t IovecBuffer<Allocator>::DefaultThreshold;
+
+	template<typename Allocator>
+	constexpr size_t IovecBuffer<Allocator>::MinimumThreshold;
+
+	template<typename Allocator>
+	constexpr size_t IovecBuffer<Allocator>::MaxVectors;
+
+}
+
+#endif //PACKETBUFFER_BUFFER_IOVECBUFFER_H
@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_BUFFER_MAPPEDFILEREADER_H
+#define PACKETBUFFER_BUFFER_MAPPEDFILEREADER_H
+
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace PacketBuffer {
+
+	/**
+	 * A Unpacker buffer that reads a whole file through a read-only memory
+	 * mapping.
+	 *
+	 * The Unpacker reads straight out of the page cache: there is no
+	 * intermediate copy into user space and no stream machinery. The kernel
+	 * is told that the file will be read sequentially and soon
+	 * (<tt>MADV_SEQUENTIAL</tt> and <tt>MADV_WILLNEED</tt>), so it reads
+	 * ahead aggressively and drops pages behind the reader.
+	 *
+	 * Like SpanReader, the reader is bounded and contiguous, so it can be
+	 * used by a bounds checked Unpacker and to borrow StringView and ByteSpan
+	 * values, which stay valid as long as the reader.
+	 *
+	 * @code
+	 *  MappedFileReader reader("capture.bin");
+	 *  Unpacker<MappedFileReader, boost::endian::order::little, IntegerEncoding::Fixed, Bounds::Checked> unpacker(reader);
+	 *  while(reader.remaining() != 0 && unpacker.good()) {
+	 *      unpacker.unpack(packet);
+	 *  }
+	 * @endcode
+	 *
+	 * @note This buffer requires a POSIX system and is not included by
+	 * <tt>PacketBuffer.h</tt>.
+	 */
+	class MappedFileReader {
+	private:
+		/**
+		 * The first byte of the mapping
+		 */
+		char* first = nullptr;
+
+		/**
+		 * The next byte to be read
+		 */
+		const char* current = nullptr;
+
+		/**
+		 * One past the last byte of the mapping
+		 */
+		const char* last = nullptr;
+
+	public:
+		/**
+		 * Maps the file at <tt>path</tt>.
+		 *
+		 * @param path the path of the file to be read
+		 *
+		 * @throws std::system_error if the file cannot be opened or mapped
+		 */
+		explicit MappedFileReader(const char* path) {
+			int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+			if(fd < 0) {
+				failed(path, errno);
+			}
+
+			struct stat status;
+			if(::fstat(fd, &status) != 0) {
+				const int error = errno;
+				::close(fd);
+				failed(path, error);
+			}
+
+			const size_t length = static_cast<size_t>(status.st_size);
+			if(length != 0) {
+				void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+				if(mapping == MAP_FAILED) {
+					const int error = errno;
+					::close(fd);
+					failed(path, error);
+				}
+				::madvise(mapping, length, MADV_SEQUENTIAL);
+				::madvise(mapping, length, MADV_WILLNEED);
+				first = static_cast<char*>(mapping);
+			}
+			::close(fd);
+
+			current = first;
+			last = first + length;
+		}
+
+		/**
+		 * Maps the file at <tt>path</tt>.
+		 *
+		 * @param path the path of the file to be read
+		 *
+		 * @throws std::system_error if the file cannot be opened or mapped
+		 */
+		explicit MappedFileReader(const std::string& path) : MappedFileReader(path.c_str()) {}
+
+		/**
+		 * Deleted copy constructor.
+		 */
+		MappedFileReader(const MappedFileReader& other) = delete;
+
+		/**
+		 * Deleted copy assignment operator.
+		 */
+		MappedFileReader& operator=(const MappedFileReader& other) = delete;
+
+		/**
+		 * Move constructor. The moved-from reader is left empty.
+		 */
+		MappedFileReader(MappedFileReader&& other) noexcept :
+				first(other.first), current(other.current), last(other.last) {
+			other.first = nullptr;
+			other.current = nullptr;
+			other.last = nullptr;
+		}
+
+		/**
+		 * Deleted move assignment operator.
+		 */
+		MappedFileReader& operator=(MappedFileReader&& other) = delete;
+
+		/**
+		 * Unmaps the file.
+		 */
+		~MappedFileReader() {
+			if(first) {
+				::munmap(first, size());
+			}
+		}
+
+	public: // Buffer interface
+		/**
+		 * Reads <tt>length</tt> bytes from the file into <tt>data</tt>.
+		 *
+		 * @param data      the destination of the bytes being read
+		 * @param length    the number of bytes to be read
+		 */
+		inline void read(char* data, size_t length) noexcept {
+			assert(length <= remaining() && "MappedFileReader read past the end");
+			std::memcpy(data, current, length);
+			current += length;
+		}
+
+		/**
+		 * Reads <tt>length</tt> bytes from the file into <tt>data</tt>.
+		 *
+		 * @param data      the destination of the bytes being read
+		 * @param length    the number of bytes to be read
+		 */
+		inline void read(unsigned char* data, size_t length) noexcept {
+			read(reinterpret_cast<char*>(data), length);
+		}
+
+		/**
+		 * Skips <tt>length</tt> bytes without reading them.
+		 *
+		 * @param length    the number of bytes to be skipped
+		 */
+		inline void skip(size_t length) noexcept {
+			assert(length <= remaining() && "MappedFileReader skip past the end");
+			current += length;
+		}
+
+	public:
+		/**
+		 * @return the next byte to be read
+		 */
+		const char* data() const noexcept {
+			return current;
+		}
+
+		/**
+		 * @return the number of bytes already read
+		 */
+		size_t position() const noexcept {
+			return static_cast<size_t>(current - first);
+		}
+
+		/**
+		 * @return the file size
+		 */
+		size_t size() const noexcept {
+			return static_cast<size_t>(last - first);
+		}
+
+		/**
+		 * @return the number of bytes that can still be read
+		 */
+		size_t remaining() const noexcept {
+			return static_cast<size_t>(last - current);
+		}
+
+		/**
+		 * Rewinds the reader to the start of the file.
+		 */
+		void reset() noexcept {
+			current = first;
+		}
+
+	private:
+		/**
+		 * Reports a system error for the file at <tt>path</tt>.
+		 *
+		 * @param path  the path of the file
+		 * @param error the <tt>errno</tt> value, saved before any cleanup
+		 */
+		[[noreturn]] static void failed(const char* path, int error) {
+#if defined(__cpp_exceptions)
+			throw std::system_error(error, std::generic_category(), path);
+#else
+			std::abort();
+#endif
+		}
+
+	};
+
+}
+
+#endif //PACKETBUFFER_BUFFER_MAPPEDFILEREADER_H
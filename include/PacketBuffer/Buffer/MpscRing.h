@@ -0,0 +1,471 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_BUFFER_MPSCRING_H
+#define PACKETBUFFER_BUFFER_MPSCRING_H
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <thread>
+
+namespace PacketBuffer {
+
+	/**
+	 * A lock-free multiple producer, single consumer ring of messages.
+	 *
+	 * The ring is divided in a power of two number of fixed size slots. A
+	 * producer claims the next slot with a single atomic fetch-add, packs
+	 * its message directly into it and publishes it by storing the slot
+	 * sequence number. The consumer takes slots in order, once their
+	 * sequence number tells they are committed, and hands them back to the
+	 * producers of the next lap by bumping it again.
+	 *
+	 * Slots are padded to cache lines, so producers packing into adjacent
+	 * slots do not share cache lines. A message cannot be larger than the
+	 * slot size.
+	 *
+	 * Since slots are consumed in order, a producer stalled between reserve()
+	 * and commit() delays the messages claimed after its own. When every slot
+	 * is taken, reserve() waits for the consumer, while tryReserve() gives up.
+	 *
+	 * Like SpscRing, the ring holds no pointers and is created in
+	 * caller-provided memory of footprint() bytes, aligned to at least 8
+	 * bytes.
+	 *
+	 * @code
+	 *  std::vector<uint64_t> memory(MpscRing::footprint(1024, 256) / sizeof(uint64_t));
+	 *  MpscRing* ring = MpscRing::create(memory.data(), 1024, 256);
+	 *
+	 *  // any producer thread
+	 *  MpscRing::Producer producer(*ring);
+	 *  producer.reserve();
+	 *  Packer<MpscRing::Producer> packer(producer);
+	 *  packer.pack(record);
+	 *  producer.commit();
+	 *
+	 *  // the consumer thread
+	 *  MpscRing::Consumer consumer(*ring);
+	 *  while(consumer.next()) {
+	 *      Unpacker<MpscRing::Consumer> unpacker(consumer);
+	 *      unpacker.unpack(record);
+	 *      consumer.release();
+	 *  }
+	 * @endcode
+	 */
+	class MpscRing {
+	public:
+		/**
+		 * The size of a cache line, used to keep slots and indexes apart
+		 */
+		static constexpr size_t CacheLineSize = 64;
+
+		class Producer;
+		class Consumer;
+
+	private:
+		static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "MpscRing requires lock-free 64-bit atomics");
+
+		/**
+		 * The header of every slot
+		 */
+		struct Slot {
+			/**
+			 * The ticket of the producer that can write into the slot, or that
+			 * ticket plus one once its message is committed
+			 */
+			std::atomic<uint64_t> sequence;
+
+			/**
+			 * The length of the committed message
+			 */
+			uint32_t length;
+		};
+
+		/**
+		 * The number of bytes preceding the message of every slot
+		 */
+		static constexpr size_t HeaderSize = 16;
+
+		/**
+		 * The next ticket to be claimed by a producer
+		 */
+		std::atomic<uint64_t> head;
+
+		char headPadding[CacheLineSize - sizeof(std::atomic<uint64_t>)];
+
+		/**
+		 * The ticket of the next slot to be consumed, so that a new Consumer
+		 * resumes where the previous one stopped
+		 */
+		std::atomic<uint64_t> tail;
+
+		char tailPadding[CacheLineSize - sizeof(std::atomic<uint64_t>)];
+
+		/**
+		 * The number of slots, a power of two
+		 */
+		const uint64_t slots;
+
+		/**
+		 * The maximum message length of a slot
+		 */
+		const uint64_t slotSize;
+
+		/**
+		 * The distance between two consecutive slots
+		 */
+		const uint64_t stride;
+
+		char slotsPadding[CacheLineSize - 3 * sizeof(uint64_t)];
+
+		/**
+		 * Creates a new empty ring.
+		 *
+		 * @param slots     the number of slots
+		 * @param slotSize  the maximum message length of a slot
+		 */
+		MpscRing(size_t slots, size_t slotSize) noexcept :
+				head(0), tail(0), slots(slots), slotSize(slotSize), stride(strideOf(slotSize)) {
+			for(uint64_t i = 0; i < slots; i++) {
+				new(slot(i)) Slot{{i}, 0};
+			}
+		}
+
+	public:
+		/**
+		 * @return the number of bytes of memory required by a ring of
+		 * <tt>slots</tt> slots of <tt>slotSize</tt> bytes
+		 */
+		static constexpr size_t footprint(size_t slots, size_t slotSize) noexcept {
+			return sizeof(MpscRing) + slots * strideOf(slotSize);
+		}
+
+		/**
+		 * Creates a new empty ring in <tt>memory</tt>.
+		 *
+		 * @param memory    the memory of the ring, at least footprint() bytes
+		 * @param slots     the number of slots, a power of two
+		 * @param slotSize  the maximum message length of a slot
+		 *
+		 * @return the ring
+		 */
+		static MpscRing* create(void* memory, size_t slots, size_t slotSize) noexcept {
+			assert(slots != 0 && (slots & (slots - 1)) == 0 && "MpscRing slot count must be a power of two");
+			assert(reinterpret_cast<uintptr_t>(memory) % 8 == 0 && "MpscRing memory must be aligned to 8 bytes");
+			return new(memory) MpscRing(slots, slotSize);
+		}
+
+		/**
+		 * @return the ring previously created in <tt>memory</tt>
+		 */
+		static MpscRing* attach(void* memory) noexcept {
+			return static_cast<MpscRing*>(memory);
+		}
+
+		/**
+		 * @return the largest message that fits in a slot
+		 */
+		size_t maxMessageSize() const noexcept {
+			return static_cast<size_t>(slotSize);
+		}
+
+	private:
+		/**
+		 * @return the header of the slot taken by <tt>ticket</tt>
+		 */
+		Slot* slot(uint64_t ticket) noexcept {
+			return reinterpret_cast<Slot*>(reinterpret_cast<char*>(this + 1) + (ticket & (slots - 1)) * stride);
+		}
+
+		/**
+		 * @return the distance between two consecutive slots of <tt>slotSize</tt> bytes
+		 */
+		static constexpr size_t strideOf(size_t slotSize) noexcept {
+			return (HeaderSize + slotSize + CacheLineSize - 1) & ~(CacheLineSize - 1);
+		}
+
+		/**
+		 * Waits until the sequence of <tt>slot</tt> reaches <tt>sequence</tt>.
+		 */
+		static void await(const Slot* slot, uint64_t sequence) noexcept {
+			for(unsigned int spins = 0; slot->sequence.load(std::memory_order_acquire) != sequence; spins++) {
+				if(spins >= 64) {
+					std::this_thread::yield();
+				}
+			}
+		}
+
+	};
+
+	/**
+	 * A producer of a MpscRing. Each producer thread uses its own Producer.
+	 *
+	 * A message is packed between reserve() and commit().
+	 */
+	class MpscRing::Producer {
+	private:
+		/**
+		 * The ring messages are written to
+		 */
+		MpscRing& ring;
+
+		/**
+		 * The header of the reserved slot
+		 */
+		Slot* reserved = nullptr;
+
+		/**
+		 * The ticket of the reserved slot
+		 */
+		uint64_t ticket = 0;
+
+		/**
+		 * The first byte of the reserved slot message
+		 */
+		char* first = nullptr;
+
+		/**
+		 * The next byte to be written
+		 */
+		char* current = nullptr;
+
+	public:
+		/**
+		 * Creates a producer of <tt>ring</tt>.
+		 *
+		 * @param ring the ring messages are written to
+		 */
+		explicit Producer(MpscRing& ring) noexcept : ring(ring) {}
+
+		/**
+		 * Claims the next slot, waiting for the consumer to hand it back if
+		 * the ring is full. Every reserved slot must be committed.
+		 */
+		void reserve() noexcept {
+			ticket = ring.head.fetch_add(1, std::memory_order_relaxed);
+			reserved = ring.slot(ticket);
+			await(reserved, ticket);
+			first = reinterpret_cast<char*>(reserved) + HeaderSize;
+			current = first;
+		}
+
+		/**
+		 * Claims the next slot if the consumer has handed it back, without
+		 * waiting. Every slot reserved this way must be committed.
+		 *
+		 * @return false if every slot is taken
+		 */
+		bool tryReserve() noexcept {
+			uint64_t claimed = ring.head.load(std::memory_order_relaxed);
+			for(;;) {
+				Slot* slot = ring.slot(claimed);
+				const auto lag = static_cast<int64_t>(slot->sequence.load(std::memory_order_acquire) - claimed);
+				if(lag < 0) {
+					return false;
+				}
+				if(lag > 0) {
+					claimed = ring.head.load(std::memory_order_relaxed);
+				} else if(ring.head.compare_exchange_weak(claimed, claimed + 1, std::memory_order_relaxed)) {
+					ticket = claimed;
+					reserved = slot;
+					first = reinterpret_cast<char*>(reserved) + HeaderSize;
+					current = first;
+					return true;
+				}
+			}
+		}
+
+		/**
+		 * Publishes the message of the reserved slot to the consumer.
+		 */
+		void commit() noexcept {
+			reserved->length = static_cast<uint32_t>(current - first);
+			reserved->sequence.store(ticket + 1, std::memory_order_release);
+		}
+
+	public: // Buffer interface
+		/**
+		 * Writes <tt>length</tt> bytes from <tt>data</tt> into the reserved slot.
+		 *
+		 * @param data      the data to be written
+		 * @param length    the number of bytes to be written
+		 */
+		inline void write(const char* data, size_t length) noexcept {
+			assert(length <= ring.slotSize - size() && "MpscRing message exceeds the slot size");
+			std::memcpy(current, data, length);
+			current += length;
+		}
+
+		/**
+		 * Writes <tt>length</tt> bytes from <tt>data</tt> into the reserved slot.
+		 *
+		 * @param data      the data to be written
+		 * @param length    the number of bytes to be written
+		 */
+		inline void write(const unsigned char* data, size_t length) noexcept {
+			write(reinterpret_cast<const char*>(data), length);
+		}
+
+	public:
+		/**
+		 * @return the number of bytes written into the reserved slot
+		 */
+		size_t size() const noexcept {
+			return static_cast<size_t>(current - first);
+		}
+	};
+
+	/**
+	 * The consumer of a MpscRing. Only one Consumer may be used at a time.
+	 *
+	 * A message is unpacked between next() and release().
+	 */
+	class MpscRing::Consumer {
+	private:
+		/**
+		 * The ring messages are read from
+		 */
+		MpscRing& ring;
+
+		/**
+		 * The ticket of the next slot to be consumed
+		 */
+		uint64_t tail;
+
+		/**
+		 * The first byte of the current message
+		 */
+		const char* first = nullptr;
+
+		/**
+		 * The next byte to be read
+		 */
+		const char* current = nullptr;
+
+		/**
+		 * One past the last byte of the current message
+		 */
+		const char* last = nullptr;
+
+	public:
+		/**
+		 * Creates the consumer of <tt>ring</tt>.
+		 *
+		 * @param ring the ring messages are read from
+		 */
+		explicit Consumer(MpscRing& ring) noexcept : ring(ring), tail(ring.tail.load(std::memory_order_relaxed)) {}
+
+		/**
+		 * Acquires the next message.
+		 *
+		 * @return false if the next message is not committed yet
+		 */
+		bool next() noexcept {
+			Slot* slot = ring.slot(tail);
+			if(slot->sequence.load(std::memory_order_acquire) != tail + 1) {
+				return false;
+			}
+			first = reinterpret_cast<const char*>(slot) + HeaderSize;
+			current = first;
+			last = first + slot->length;
+			return true;
+		}
+
+		/**
+		 * Releases the current message, handing its slot back to the producers.
+		 */
+		void release() noexcept {
+			ring.slot(tail)->sequence.store(tail + ring.slots, std::memory_order_release);
+			tail++;
+			ring.tail.store(tail, std::memory_order_relaxed);
+		}
+
+	public: // Buffer interface
+		/**
+		 * Reads <tt>length</tt> bytes from the current message into <tt>data</tt>.
+		 *
+		 * @param data      the destination of the bytes being read
+		 * @param length    the number of bytes to be read
+		 */
+		inline void read(char* data, size_t length) noexcept {
+			assert(length <= remaining() && "MpscRing read past the end of the message");
+			std::memcpy(data, current, length);
+			current += length;
+		}
+
+		/**
+		 * Reads <tt>length</tt> bytes from the current message into <tt>data</tt>.
+		 *
+		 * @param data      the destination of the bytes being read
+		 * @param length    the number of bytes to be read
+		 */
+		inline void read(unsigned char* data, size_t length) noexcept {
+			read(reinterpret_cast<char*>(data), length);
+		}
+
+		/**
+		 * Skips <tt>length</tt> bytes of the current message without reading them.
+		 *
+		 * @param length    the number of bytes to be skipped
+		 */
+		inline void skip(size_t length) noexcept {
+			assert(length <= remaining() && "MpscRing skip past the end of the message");
+			current += length;
+		}
+
+	public:
+		/**
+		 * @return the next byte to be read
+		 */
+		const char* data() const noexcept {
+			return current;
+		}
+
+		/**
+		 * @return the length of the current message
+		 */
+		size_t size() const noexcept {
+			return static_cast<size_t>(last - first);
+		}
+
+		/**
+		 * @return the number of bytes of the current message that can still be read
+		 */
+		size_t remaining() const noexcept {
+			return static_cast<size_t>(last - current);
+		}
+	};
+
+}
+
+#endif //PACKETBUFFER_BUFFER_MPSCRING_H
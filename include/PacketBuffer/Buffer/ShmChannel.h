@@ -0,0 +1,582 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_BUFFER_SHMCHANNEL_H
+#define PACKETBUFFER_BUFFER_SHMCHANNEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "SpscRing.h"
+
+namespace PacketBuffer {
+
+	/**
+	 * A channel of messages between two local processes, over POSIX shared
+	 * memory.
+	 *
+	 * The shared memory object holds a SpscRing preceded by a small control
+	 * block. Messages are packed straight into the shared ring by a Producer
+	 * and unpacked in place by a Consumer, using the regular Packer and
+	 * Unpacker and therefore the same ObjectSerializer specializations as
+	 * any other buffer. Passing a message involves no system call.
+	 *
+	 * A Consumer that runs out of messages can either poll next() or block
+	 * in wait(). A waiting consumer first spins for a short while and only
+	 * then goes to sleep on a futex. The producer checks a flag after every
+	 * commit and only issues a wake-up system call when the consumer is
+	 * actually asleep.
+	 *
+	 * @code
+	 *  // decoder process
+	 *  ShmChannel channel = ShmChannel::create("/market-data", 1 << 20);
+	 *  ShmChannel::Producer producer(channel);
+	 *  if(producer.reserve(packedSize(quote))) {
+	 *      Packer<ShmChannel::Producer> packer(producer);
+	 *      packer.pack(quote);
+	 *      producer.commit();
+	 *  }
+	 *
+	 *  // strategy process
+	 *  ShmChannel channel = ShmChannel::open("/market-data");
+	 *  ShmChannel::Consumer consumer(channel);
+	 *  while(consumer.wait()) {
+	 *      Unpacker<ShmChannel::Consumer> unpacker(consumer);
+	 *      unpacker.unpack(quote);
+	 *      consumer.release();
+	 *  }
+	 * @endcode
+	 *
+	 * Sleeping and waking use a futex on Linux. On other POSIX systems, a
+	 * waiting consumer falls back to polling with short sleeps.
+	 *
+	 * @note This channel requires a POSIX system and is not included by
+	 * <tt>PacketBuffer.h</tt>.
+	 */
+	class ShmChannel {
+	public:
+		class Producer;
+		class Consumer;
+
+	private:
+		static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "ShmChannel requires plain 32-bit atomics");
+
+		/**
+		 * The value stored in the control block once the channel is ready
+		 */
+		static constexpr uint32_t Magic = 0x50424348;
+
+		/**
+		 * The shared state preceding the ring
+		 */
+		struct Control {
+			/**
+			 * Magic once the ring is created
+			 */
+			std::atomic<uint32_t> ready;
+
+			/**
+			 * The futex word, bumped by the producer to wake the consumer up
+			 */
+			std::atomic<uint32_t> signal;
+
+			/**
+			 * Non-zero while the consumer is about to sleep, or sleeping
+			 */
+			std::atomic<uint32_t> sleeping;
+
+			char padding[SpscRing::CacheLineSize - 3 * sizeof(std::atomic<uint32_t>)];
+		};
+
+		/**
+		 * The shared memory mapping
+		 */
+		void* mapping = nullptr;
+
+		/**
+		 * The mapping size
+		 */
+		size_t length = 0;
+
+		/**
+		 * The name of the shared memory object, if owned by this channel
+		 */
+		std::string owned;
+
+		/**
+		 * Creates a channel over an existing mapping.
+		 *
+		 * @param mapping   the shared memory mapping
+		 * @param length    the mapping size
+		 * @param owned     the name to be unlinked when the channel is destroyed
+		 */
+		ShmChannel(void* mapping, size_t length, std::string owned) noexcept :
+				mapping(mapping), length(length), owned(std::move(owned)) {}
+
+	public:
+		/**
+		 * @return the size of the shared memory object of a channel of
+		 * <tt>capacity</tt> bytes
+		 */
+		static constexpr size_t footprint(size_t capacity) noexcept {
+			return sizeof(Control) + SpscRing::footprint(capacity);
+		}
+
+		/**
+		 * Creates a new shared memory object named <tt>name</tt> holding an
+		 * empty channel. The object is unlinked when the returned channel is
+		 * destroyed; processes that already opened it keep their mapping.
+		 *
+		 * @param name      the name of the shared memory object, starting with a slash
+		 * @param capacity  the number of bytes of the ring, a power of two of at least 64
+		 *
+		 * @return the channel
+		 *
+		 * @throws std::system_error if the object already exists or cannot be created
+		 */
+		static ShmChannel create(const std::string& name, size_t capacity) {
+			int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+			if(fd < 0) {
+				failed(errno, name);
+			}
+
+			const size_t length = footprint(capacity);
+			if(::ftruncate(fd, static_cast<off_t>(length)) != 0) {
+				const int error = errno;
+				::close(fd);
+				::shm_unlink(name.c_str());
+				failed(error, name);
+			}
+
+			void* mapping = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			const int error = errno;
+			::close(fd);
+			if(mapping == MAP_FAILED) {
+				::shm_unlink(name.c_str());
+				failed(error, name);
+			}
+
+			Control* control = new(mapping) Control();
+			SpscRing::create(control + 1, capacity);
+			control->ready.store(Magic, std::memory_order_release);
+			return ShmChannel(mapping, length, name);
+		}
+
+		/**
+		 * Opens the channel previously created under <tt>name</tt>, usually
+		 * by another process.
+		 *
+		 * @param name the name of the shared memory object
+		 *
+		 * @return the channel
+		 *
+		 * @throws std::system_error if the object does not exist, cannot be
+		 * mapped or does not hold a ready channel yet
+		 */
+		static ShmChannel open(const std::string& name) {
+			int fd = ::shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+			if(fd < 0) {
+				failed(errno, name);
+			}
+
+			struct stat status;
+			if(::fstat(fd, &status) != 0) {
+				const int error = errno;
+				::close(fd);
+				failed(error, name);
+			}
+
+			const size_t length = static_cast<size_t>(status.st_size);
+			if(length < footprint(64)) {
+				::close(fd);
+				failed(EAGAIN, name);
+			}
+
+			void* mapping = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			const int error = errno;
+			::close(fd);
+			if(mapping == MAP_FAILED) {
+				failed(error, name);
+			}
+
+			ShmChannel channel(mapping, length, std::string());
+			if(channel.control()->ready.load(std::memory_order_acquire) != Magic ||
+			   footprint(channel.ring()->getCapacity()) != length) {
+				failed(EAGAIN, name);
+			}
+			return channel;
+		}
+
+		/**
+		 * Deleted copy constructor.
+		 */
+		ShmChannel(const ShmChannel& other) = delete;
+
+		/**
+		 * Deleted copy assignment operator.
+		 */
+		ShmChannel& operator=(const ShmChannel& other) = delete;
+
+		/**
+		 * Move constructor. The moved-from channel is left empty.
+		 */
+		ShmChannel(ShmChannel&& other) noexcept :
+				mapping(other.mapping), length(other.length), owned(std::move(other.owned)) {
+			other.mapping = nullptr;
+			other.length = 0;
+			other.owned.clear();
+		}
+
+		/**
+		 * Deleted move assignment operator.
+		 */
+		ShmChannel& operator=(ShmChannel&& other) = delete;
+
+		/**
+		 * Unmaps the channel, and unlinks its shared memory object if it was
+		 * created by this channel.
+		 */
+		~ShmChannel() {
+			if(mapping) {
+				::munmap(mapping, length);
+			}
+			if(!owned.empty()) {
+				::shm_unlink(owned.c_str());
+			}
+		}
+
+		/**
+		 * @return the ring shared by the two processes
+		 */
+		SpscRing* ring() const noexcept {
+			return SpscRing::attach(control() + 1);
+		}
+
+	private:
+		/**
+		 * @return the shared control block
+		 */
+		Control* control() const noexcept {
+			return static_cast<Control*>(mapping);
+		}
+
+		/**
+		 * Puts the calling thread to sleep while <tt>word</tt> holds <tt>expected</tt>,
+		 * for at most <tt>timeout</tt>.
+		 */
+		static void sleep(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::nanoseconds timeout) noexcept {
+#if defined(__linux__)
+			struct timespec relative;
+			relative.tv_sec = static_cast<time_t>(timeout.count() / 1000000000);
+			relative.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+			::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected,
+					  timeout == std::chrono::nanoseconds::max() ? nullptr : &relative, nullptr, 0);
+#else
+			if(word.load(std::memory_order_relaxed) == expected) {
+				std::this_thread::sleep_for(std::min(timeout, std::chrono::nanoseconds(50000)));
+			}
+#endif
+		}
+
+		/**
+		 * Wakes up the thread sleeping on <tt>word</tt>, if any.
+		 */
+		static void wake(std::atomic<uint32_t>& word) noexcept {
+#if defined(__linux__)
+			::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+#else
+			(void) word;
+#endif
+		}
+
+		/**
+		 * Reports the system error <tt>error</tt> for the object named <tt>name</tt>.
+		 */
+		[[noreturn]] static void failed(int error, const std::string& name) {
+#if defined(__cpp_exceptions)
+			throw std::system_error(error, std::generic_category(), name);
+#else
+			(void) error;
+			(void) name;
+			std::abort();
+#endif
+		}
+
+	};
+
+	/**
+	 * The producer side of a ShmChannel. Only one Producer may be used at a
+	 * time, across all processes.
+	 *
+	 * A message is packed between reserve() and commit(), exactly as with a
+	 * SpscRing::Producer.
+	 */
+	class ShmChannel::Producer {
+	private:
+		/**
+		 * The control block shared with the consumer
+		 */
+		Control& control;
+
+		/**
+		 * The producer of the shared ring
+		 */
+		SpscRing::Producer producer;
+
+	public:
+		/**
+		 * Creates the producer of <tt>channel</tt>.
+		 *
+		 * @param channel the channel messages are sent to
+		 */
+		explicit Producer(ShmChannel& channel) noexcept :
+				control(*channel.control()), producer(*channel.ring()) {}
+
+		/**
+		 * Reserves room for a message of up to <tt>length</tt> bytes.
+		 *
+		 * @param length the maximum message length, up to SpscRing::maxMessageSize()
+		 *
+		 * @return false if the channel is full
+		 */
+		bool reserve(size_t length) noexcept {
+			return producer.reserve(length);
+		}
+
+		/**
+		 * Publishes the reserved message, waking the consumer up if it is
+		 * asleep.
+		 */
+		void commit() noexcept {
+			producer.commit();
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if(control.sleeping.load(std::memory_order_relaxed) != 0) {
+				control.signal.fetch_add(1, std::memory_order_release);
+				wake(control.signal);
+			}
+		}
+
+	public: // Buffer interface
+		/**
+		 * Writes <tt>length</tt> bytes from <tt>data</tt> into the reserved message.
+		 *
+		 * @param data      the data to be written
+		 * @param length    the number of bytes to be written
+		 */
+		inline void write(const char* data, size_t length) noexcept {
+			producer.write(data, length);
+		}
+
+		/**
+		 * Writes <tt>length</tt> bytes from <tt>data</tt> into the reserved message.
+		 *
+		 * @param data      the data to be written
+		 * @param length    the number of bytes to be written
+		 */
+		inline void write(const unsigned char* data, size_t length) noexcept {
+			producer.write(data, length);
+		}
+
+	public:
+		/**
+		 * @return the number of bytes written into the reserved message
+		 */
+		size_t size() const noexcept {
+			return producer.size();
+		}
+	};
+
+	/**
+	 * The consumer side of a ShmChannel. Only one Consumer may be used at a
+	 * time, across all processes.
+	 *
+	 * A message is unpacked between next() or wait() and release(), exactly
+	 * as with a SpscRing::Consumer.
+	 */
+	class ShmChannel::Consumer {
+	private:
+		/**
+		 * The control block shared with the producer
+		 */
+		Control& control;
+
+		/**
+		 * The consumer of the shared ring
+		 */
+		SpscRing::Consumer consumer;
+
+		/**
+		 * The number of times wait() polls the ring before going to sleep
+		 */
+		unsigned int spins;
+
+	public:
+		/**
+		 * Creates the consumer of <tt>channel</tt>.
+		 *
+		 * @param channel   the channel messages are received from
+		 * @param spins     the number of times wait() polls the ring before going to sleep
+		 */
+		explicit Consumer(ShmChannel& channel, unsigned int spins = 1000) noexcept :
+				control(*channel.control()), consumer(*channel.ring()), spins(spins) {}
+
+		/**
+		 * Acquires the next message, without blocking.
+		 *
+		 * @return false if the channel is empty
+		 */
+		bool next() noexcept {
+			return consumer.next();
+		}
+
+		/**
+		 * Acquires the next message, sleeping until the producer commits one
+		 * if the channel stays empty. Signals and spurious wake-ups put the
+		 * consumer back to sleep for the rest of the timeout.
+		 *
+		 * @param timeout the maximum time to sleep for
+		 *
+		 * @return false if the timeout expired before a message was available
+		 */
+		bool wait(std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max()) noexcept {
+			for(unsigned int i = 0; i < spins; i++) {
+				if(consumer.next()) {
+					return true;
+				}
+			}
+
+			using Clock = std::chrono::steady_clock;
+			const Clock::time_point start = Clock::now();
+			const bool forever = timeout >= Clock::time_point::max() - start;
+			const Clock::time_point deadline = forever ? Clock::time_point::max() :
+											   start + std::chrono::duration_cast<Clock::duration>(timeout);
+			for(;;) {
+				const uint32_t signal = control.signal.load(std::memory_order_acquire);
+				control.sleeping.store(1, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if(consumer.next()) {
+					control.sleeping.store(0, std::memory_order_relaxed);
+					return true;
+				}
+
+				std::chrono::nanoseconds left = std::chrono::nanoseconds::max();
+				if(!forever) {
+					left = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - Clock::now());
+					if(left.count() <= 0) {
+						control.sleeping.store(0, std::memory_order_relaxed);
+						return false;
+					}
+				}
+				sleep(control.signal, signal, left);
+			}
+		}
+
+		/**
+		 * Releases the current message, making its room available to the producer.
+		 */
+		void release() noexcept {
+			consumer.release();
+		}
+
+	public: // Buffer interface
+		/**
+		 * Reads <tt>length</tt> bytes from the current message into <tt>data</tt>.
+		 *
+		 * @param data      the destination of the bytes being read
+		 * @param length    the number of bytes to be read
+		 */
+		inline void read(char* data, size_t length) noexcept {
+			consumer.read(data, length);
+		}
+
+		/**
+		 * Reads <tt>length</tt> bytes from the current message into <tt>data</tt>.
+		 *
+		 * @param data      the destination of the bytes being read
+		 * @param length    the number of bytes to be read
+		 */
+		inline void read(unsigned char* data, size_t length) noexcept {
+			consumer.read(data, length);
+		}
+
+		/**
+		 * Skips <tt>length</tt> bytes of the current message without reading them.
+		 *
+		 * @param length    the number of bytes to be skipped
+		 */
+		inline void skip(size_t length) noexcept {
+			consumer.skip(length);
+		}
+
+	public:
+		/**
+		 * @return the next byte to be read
+		 */
+		const char* data() const noexcept {
+			return consumer.data();
+		}
+
+		/**
+		 * @return the length of the current message
+		 */
+		size_t size() const noexcept {
+			return consumer.size();
+		}
+
+		/**
+		 * @return the number of bytes of the current message that can still be read
+		 */
+		size_t remaining() const noexcept {
+			return consumer.remaining();
+		}
+	};
+
+}
+
+#endif //PACKETBUFFER_BUFFER_SHMCHANNEL_H
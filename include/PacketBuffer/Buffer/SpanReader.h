@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_BUFFER_SPANREADER_H
+#define PACKETBUFFER_BUFFER_SPANREADER_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
+namespace PacketBuffer {
+
+	/**
+	 * A Unpacker buffer that reads from a caller-owned contiguous memory
+	 * region of known length.
+	 *
+	 * Unlike <tt>std::istream</tt>, reads are not virtual and carry no
+	 * sentry or locale bookkeeping: each read is a <tt>memcpy</tt> of a
+	 * (usually compile-time constant) length followed by a cursor bump,
+	 * which the compiler lowers to a single unaligned load.
+	 *
+	 * @note No bounds checking is performed on release builds. The caller
+	 * must guarantee that the region holds enough data for the objects
+	 * being unpacked.
+	 *
+	 * @code
+	 *  SpanReader reader(datagram, length);
+	 *  Unpacker<SpanReader> unpacker(reader);
+	 *  uint32_t value = unpacker.unpack<uint32_t>();
+	 * @endcode
+	 */
+	class SpanReader {
+	private:
+		/**
+		 * The first byte of the memory region
+		 */
+		const char* const first;
+
+		/**
+		 * The next byte to be read
+		 */
+		const char* current;
+
+		/**
+		 * One past the last byte of the memory region
+		 */
+		const char* const last;
+
+	public:
+		/**
+		 * Creates a new SpanReader over the memory region starting at
+		 * <tt>data</tt> with <tt>length</tt> bytes.
+		 *
+		 * @param data      the memory region to read from
+		 * @param length    the memory region size
+		 */
+		SpanReader(const char* data, size_t length) :
+				first(data), current(data), last(data + length) {};
+
+		/**
+		 * Creates a new SpanReader over the memory region starting at
+		 * <tt>data</tt> with <tt>length</tt> bytes.
+		 *
+		 * @param data      the memory region to read from
+		 * @param length    the memory region size
+		 */
+		SpanReader(const unsigned char* data, size_t length) :
+				SpanReader(reinterpret_cast<const char*>(data), length) {};
+
+	public: // Buffer interface
+		/**
+		 * Reads <tt>length</tt> bytes from the region into <tt>data</tt>.
+		 *
+		 * @param data      the destination of the bytes being read
+		 * @param length    the number of bytes to be read
+		 */
+		inline void read(char* data, size_t length) noexcept {
+			assert(length <= remaining() && "SpanReader read past the end");
+			std::memcpy(data, current, length);
+			current += length;
+		}
+
+		/**
+		 * Reads <tt>length</tt> bytes from the region into <tt>data</tt>.
+		 *
+		 * @param data      the destination of the bytes being read
+		 * @param length    the number of bytes to be read
+		 */
+		inline void read(unsigned char* data, size_t length) noexcept {
+			read(reinterpret_cast<char*>(data), length);
+		}
+
+		/**
+		 * Skips <tt>length</tt> bytes without reading them.
+		 *
+		 * @param length    the number of bytes to be skipped
+		 */
+		inline void skip(size_t length) noexcept {
+			assert(length <= remaining() && "SpanReader skip past the end");
+			current += length;
+		}
+
+	public:
+		/**
+		 * @return the next byte to be read
+		 */
+		const char* data() const noexcept {
+			return current;
+		}
+
+		/**
+		 * @return the number of bytes already read
+		 */
+		size_t position() const noexcept {
+			return static_cast<size_t>(current - first);
+		}
+
+		/**
+		 * @return the memory region size
+		 */
+		size_t size() const noexcept {
+			return static_cast<size_t>(last - first);
+		}
+
+		/**
+		 * @return the number of bytes that can still be read
+		 */
+		size_t remaining() const noexcept {
+			return static_cast<size_t>(last - current);
+		}
+
+		/**
+		 * Rewinds the reader to the start of the memory region.
+		 */
+		void reset() noexcept {
+			current = first;
+		}
+
+	};
+
+}
+
+#endif //PACKETBUFFER_BUFFER_SPANREADER_H
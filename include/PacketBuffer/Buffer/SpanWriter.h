@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_BUFFER_SPANWRITER_H
+#define PACKETBUFFER_BUFFER_SPANWRITER_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
+namespace PacketBuffer {
+
+	/**
+	 * A Packer buffer that writes into a fixed-capacity, caller-owned
+	 * contiguous memory region.
+	 *
+	 * Unlike <tt>std::ostream</tt>, writes are not virtual and carry no
+	 * sentry or locale bookkeeping: each write is a <tt>memcpy</tt> of a
+	 * (usually compile-time constant) length followed by a cursor bump,
+	 * which the compiler lowers to a single unaligned store.
+	 *
+	 * @note No bounds checking is performed on release builds. The caller
+	 * must guarantee that the region is large enough for the data being
+	 * packed.
+	 *
+	 * @code
+	 *  char storage[64];
+	 *  SpanWriter writer(storage);
+	 *  Packer<SpanWriter> packer(writer);
+	 *  packer.pack(uint32_t(100));
+	 * @endcode
+	 */
+	class SpanWriter {
+	private:
+		/**
+		 * The first byte of the memory region
+		 */
+		char* const first;
+
+		/**
+		 * The next byte to be written
+		 */
+		char* current;
+
+		/**
+		 * One past the last byte of the memory region
+		 */
+		char* const last;
+
+	public:
+		/**
+		 * Creates a new SpanWriter over the memory region starting at
+		 * <tt>data</tt> with <tt>capacity</tt> bytes.
+		 *
+		 * @param data      the memory region to write to
+		 * @param capacity  the memory region size
+		 */
+		SpanWriter(char* data, size_t capacity) :
+				first(data), current(data), last(data + capacity) {};
+
+		/**
+		 * Creates a new SpanWriter over a statically sized char array.
+		 *
+		 * @tparam S    the array size
+		 * @param data  the array to write to
+		 */
+		template<size_t S>
+		explicit SpanWriter(char (& data)[S]) : SpanWriter(data, S) {};
+
+	public: // Buffer interface
+		/**
+		 * Writes <tt>length</tt> bytes from <tt>data</tt> into the region.
+		 *
+		 * @param data      the data to be written
+		 * @param length    the number of bytes to be written
+		 */
+		inline void write(const char* data, size_t length) noexcept {
+			assert(length <= remaining() && "SpanWriter capacity exceeded");
+			std::memcpy(current, data, length);
+			current += length;
+		}
+
+		/**
+		 * Writes <tt>length</tt> bytes from <tt>data</tt> into the region.
+		 *
+		 * @param data      the data to be written
+		 * @param length    the number of bytes to be written
+		 */
+		inline void write(const unsigned char* data, size_t length) noexcept {
+			write(reinterpret_cast<const char*>(data), length);
+		}
+
+	public:
+		/**
+		 * Returns the next <tt>length</tt> bytes of the region so that they
+		 * can be filled directly. They are appended to the written data by
+		 * commit().
+		 *
+		 * @param length the number of bytes to be written
+		 *
+		 * @return the first byte past the written data
+		 */
+		char* prepare(size_t length) noexcept {
+			(void) length;
+			assert(length <= remaining() && "SpanWriter capacity exceeded");
+			return current;
+		}
+
+		/**
+		 * Appends <tt>length</tt> bytes previously filled through prepare()
+		 * to the written data.
+		 *
+		 * @param length the number of bytes filled
+		 */
+		void commit(size_t length) noexcept {
+			assert(length <= remaining() && "SpanWriter capacity exceeded");
+			current += length;
+		}
+
+		/**
+		 * @return the first byte of the memory region
+		 */
+		char* data() const noexcept {
+			return first;
+		}
+
+		/**
+		 * @return the number of bytes written so far
+		 */
+		size_t size() const noexcept {
+			return static_cast<size_t>(current - first);
+		}
+
+		/**
+		 * @return the memory region size
+		 */
+		size_t capacity() const noexcept {
+			return static_cast<size_t>(last - first);
+		}
+
+		/**
+		 * @return the number of bytes that can still be written
+		 */
+		size_t remaining() const noexcept {
+			return static_cast<size_t>(last - current);
+		}
+
+		/**
+		 * Rewinds the writer to the start of the memory region so that it
+		 * can be reused for another message.
+		 */
+		void reset() noexcept {
+			current = first;
+		}
+
+	};
+
+}
+
+#endif //PACKETBUFFER_BUFFER_SPANWRITER_H
@@ -0,0 +1,465 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_BUFFER_SPSCRING_H
+#define PACKETBUFFER_BUFFER_SPSCRING_H
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+namespace PacketBuffer {
+
+	/**
+	 * A lock-free single producer, single consumer ring of messages.
+	 *
+	 * Messages are packed in place into the ring by a Producer, which is a
+	 * Packer buffer, and unpacked in place by a Consumer, which is a bounded
+	 * and contiguous Unpacker buffer, like SpanReader. Neither side allocates
+	 * or locks: each side only publishes its own index with a release store
+	 * and reads the other side index when it runs out of room or messages.
+	 *
+	 * A message is stored contiguously, after an 8 byte header holding its
+	 * length, and padded to 8 bytes. A message that does not fit before the
+	 * end of the ring is moved to its start, leaving a wrap marker behind.
+	 *
+	 * The ring holds no pointers, so it can be placed in memory shared
+	 * between processes. It is created in caller-provided memory of
+	 * footprint() bytes, which must be aligned to at least 8 bytes (ideally
+	 * to a cache line).
+	 *
+	 * @code
+	 *  std::vector<char> memory(SpscRing::footprint(1 << 20));
+	 *  SpscRing* ring = SpscRing::create(memory.data(), 1 << 20);
+	 *
+	 *  // producer thread
+	 *  SpscRing::Producer producer(*ring);
+	 *  if(producer.reserve(packedSize(message))) {
+	 *      Packer<SpscRing::Producer> packer(producer);
+	 *      packer.pack(message);
+	 *      producer.commit();
+	 *  }
+	 *
+	 *  // consumer thread
+	 *  SpscRing::Consumer consumer(*ring);
+	 *  while(consumer.next()) {
+	 *      Unpacker<SpscRing::Consumer> unpacker(consumer);
+	 *      unpacker.unpack(message);
+	 *      consumer.release();
+	 *  }
+	 * @endcode
+	 */
+	class SpscRing {
+	public:
+		/**
+		 * The size of a cache line, used to keep the indexes of the
+		 * producer and the consumer apart
+		 */
+		static constexpr size_t CacheLineSize = 64;
+
+		/**
+		 * The number of bytes preceding every message
+		 */
+		static constexpr size_t HeaderSize = 8;
+
+		class Producer;
+		class Consumer;
+
+	private:
+		static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "SpscRing requires lock-free 64-bit atomics");
+
+		/**
+		 * The length stored in a header to tell the consumer to continue
+		 * from the start of the ring
+		 */
+		static constexpr uint32_t WrapMarker = 0xFFFFFFFF;
+
+		/**
+		 * The number of bytes written by the producer, since the ring was created
+		 */
+		std::atomic<uint64_t> head;
+
+		char headPadding[CacheLineSize - sizeof(std::atomic<uint64_t>)];
+
+		/**
+		 * The number of bytes released by the consumer, since the ring was created
+		 */
+		std::atomic<uint64_t> tail;
+
+		char tailPadding[CacheLineSize - sizeof(std::atomic<uint64_t>)];
+
+		/**
+		 * The number of bytes of the ring, a power of two
+		 */
+		const uint64_t capacity;
+
+		char capacityPadding[CacheLineSize - sizeof(uint64_t)];
+
+		/**
+		 * Creates a new empty ring.
+		 *
+		 * @param capacity the number of bytes of the ring
+		 */
+		explicit SpscRing(size_t capacity) noexcept : head(0), tail(0), capacity(capacity) {}
+
+	public:
+		/**
+		 * @return the number of bytes of memory required by a ring of
+		 * <tt>capacity</tt> bytes
+		 */
+		static constexpr size_t footprint(size_t capacity) noexcept {
+			return sizeof(SpscRing) + capacity;
+		}
+
+		/**
+		 * Creates a new empty ring in <tt>memory</tt>.
+		 *
+		 * @param memory    the memory of the ring, at least footprint() bytes
+		 * @param capacity  the number of bytes of the ring, a power of two of at least 64
+		 *
+		 * @return the ring
+		 */
+		static SpscRing* create(void* memory, size_t capacity) noexcept {
+			assert(capacity >= 64 && (capacity & (capacity - 1)) == 0 && "SpscRing capacity must be a power of two");
+			assert(reinterpret_cast<uintptr_t>(memory) % 8 == 0 && "SpscRing memory must be aligned to 8 bytes");
+			return new(memory) SpscRing(capacity);
+		}
+
+		/**
+		 * @return the ring previously created in <tt>memory</tt>, for instance by another process
+		 */
+		static SpscRing* attach(void* memory) noexcept {
+			return static_cast<SpscRing*>(memory);
+		}
+
+		/**
+		 * @return the number of bytes of the ring
+		 */
+		size_t getCapacity() const noexcept {
+			return static_cast<size_t>(capacity);
+		}
+
+		/**
+		 * @return the largest message that can always be reserved in the ring
+		 */
+		size_t maxMessageSize() const noexcept {
+			return static_cast<size_t>(capacity / 2 - HeaderSize);
+		}
+
+	private:
+		/**
+		 * @return the first byte of the ring
+		 */
+		char* bytes() noexcept {
+			return reinterpret_cast<char*>(this + 1);
+		}
+
+		/**
+		 * @return the number of ring bytes taken by a message of <tt>length</tt> bytes
+		 */
+		static uint64_t footprintOf(uint64_t length) noexcept {
+			return HeaderSize + ((length + 7) & ~uint64_t(7));
+		}
+
+	};
+
+	/**
+	 * The producer side of a SpscRing. Only one Producer may be used at a time.
+	 *
+	 * A message is packed between reserve() and commit(). Until committed,
+	 * it is not visible to the consumer.
+	 */
+	class SpscRing::Producer {
+	private:
+		/**
+		 * The ring messages are written to
+		 */
+		SpscRing& ring;
+
+		/**
+		 * The producer index, published on commit()
+		 */
+		uint64_t head;
+
+		/**
+		 * The last consumer index read from the ring
+		 */
+		uint64_t cachedTail;
+
+		/**
+		 * The ring index of the header of the reserved message
+		 */
+		uint64_t start = 0;
+
+		/**
+		 * The first byte of the reserved message
+		 */
+		char* first = nullptr;
+
+		/**
+		 * The next byte to be written
+		 */
+		char* current = nullptr;
+
+		/**
+		 * One past the last reserved byte
+		 */
+		char* last = nullptr;
+
+	public:
+		/**
+		 * Creates the producer of <tt>ring</tt>.
+		 *
+		 * @param ring the ring messages are written to
+		 */
+		explicit Producer(SpscRing& ring) noexcept :
+				ring(ring), head(ring.head.load(std::memory_order_relaxed)),
+				cachedTail(ring.tail.load(std::memory_order_acquire)) {}
+
+		/**
+		 * Reserves room for a message of up to <tt>length</tt> bytes.
+		 *
+		 * @param length the maximum message length, up to maxMessageSize()
+		 *
+		 * @return false if the ring is full
+		 */
+		bool reserve(size_t length) noexcept {
+			assert(length <= ring.maxMessageSize() && "SpscRing message is too large");
+
+			const uint64_t mask = ring.capacity - 1;
+			const uint64_t required = footprintOf(length);
+			const uint64_t contiguous = ring.capacity - (head & mask);
+			const uint64_t padding = required > contiguous ? contiguous : 0;
+
+			if(head + padding + required - cachedTail > ring.capacity) {
+				cachedTail = ring.tail.load(std::memory_order_acquire);
+				if(head + padding + required - cachedTail > ring.capacity) {
+					return false;
+				}
+			}
+
+			if(padding != 0) {
+				const uint32_t marker = WrapMarker;
+				std::memcpy(ring.bytes() + (head & mask), &marker, sizeof(marker));
+			}
+			start = head + padding;
+			first = ring.bytes() + (start & mask) + HeaderSize;
+			current = first;
+			last = first + length;
+			return true;
+		}
+
+		/**
+		 * Publishes the reserved message to the consumer.
+		 */
+		void commit() noexcept {
+			const uint32_t length = static_cast<uint32_t>(current - first);
+			std::memcpy(first - HeaderSize, &length, sizeof(length));
+			head = start + footprintOf(length);
+			ring.head.store(head, std::memory_order_release);
+		}
+
+	public: // Buffer interface
+		/**
+		 * Writes <tt>length</tt> bytes from <tt>data</tt> into the reserved message.
+		 *
+		 * @param data      the data to be written
+		 * @param length    the number of bytes to be written
+		 */
+		inline void write(const char* data, size_t length) noexcept {
+			assert(length <= static_cast<size_t>(last - current) && "SpscRing message exceeds its reservation");
+			std::memcpy(current, data, length);
+			current += length;
+		}
+
+		/**
+		 * Writes <tt>length</tt> bytes from <tt>data</tt> into the reserved message.
+		 *
+		 * @param data      the data to be written
+		 * @param length    the number of bytes to be written
+		 */
+		inline void write(const unsigned char* data, size_t length) noexcept {
+			write(reinterpret_cast<const char*>(data), length);
+		}
+
+	public:
+		/**
+		 * @return the number of bytes written into the reserved message
+		 */
+		size_t size() const noexcept {
+			return static_cast<size_t>(current - first);
+		}
+	};
+
+	/**
+	 * The consumer side of a SpscRing. Only one Consumer may be used at a time.
+	 *
+	 * A message is unpacked between next() and release(). Its bytes stay in
+	 * the ring until released, so values borrowed from it are valid until
+	 * then.
+	 */
+	class SpscRing::Consumer {
+	private:
+		/**
+		 * The ring messages are read from
+		 */
+		SpscRing& ring;
+
+		/**
+		 * The consumer index, published on release()
+		 */
+		uint64_t tail;
+
+		/**
+		 * The last producer index read from the ring
+		 */
+		uint64_t cachedHead;
+
+		/**
+		 * The first byte of the current message
+		 */
+		const char* first = nullptr;
+
+		/**
+		 * The next byte to be read
+		 */
+		const char* current = nullptr;
+
+		/**
+		 * One past the last byte of the current message
+		 */
+		const char* last = nullptr;
+
+	public:
+		/**
+		 * Creates the consumer of <tt>ring</tt>.
+		 *
+		 * @param ring the ring messages are read from
+		 */
+		explicit Consumer(SpscRing& ring) noexcept :
+				ring(ring), tail(ring.tail.load(std::memory_order_relaxed)),
+				cachedHead(ring.head.load(std::memory_order_acquire)) {}
+
+		/**
+		 * Acquires the next message.
+		 *
+		 * @return false if the ring is empty
+		 */
+		bool next() noexcept {
+			if(tail == cachedHead) {
+				cachedHead = ring.head.load(std::memory_order_acquire);
+				if(tail == cachedHead) {
+					return false;
+				}
+			}
+
+			const uint64_t mask = ring.capacity - 1;
+			uint32_t length;
+			std::memcpy(&length, ring.bytes() + (tail & mask), sizeof(length));
+			if(length == WrapMarker) {
+				tail += ring.capacity - (tail & mask);
+				std::memcpy(&length, ring.bytes() + (tail & mask), sizeof(length));
+			}
+
+			first = ring.bytes() + (tail & mask) + HeaderSize;
+			current = first;
+			last = first + length;
+			return true;
+		}
+
+		/**
+		 * Releases the current message, making its room available to the producer.
+		 */
+		void release() noexcept {
+			tail += footprintOf(static_cast<uint64_t>(last - first));
+			ring.tail.store(tail, std::memory_order_release);
+		}
+
+	public: // Buffer interface
+		/**
+		 * Reads <tt>length</tt> bytes from the current message into <tt>data</tt>.
+		 *
+		 * @param data      the destination of the bytes being read
+		 * @param length    the number of bytes to be read
+		 */
+		inline void read(char* data, size_t length) noexcept {
+			assert(length <= remaining() && "SpscRing read past the end of the message");
+			std::memcpy(data, current, length);
+			current += length;
+		}
+
+		/**
+		 * Reads <tt>length</tt> bytes from the current message into <tt>data</tt>.
+		 *
+		 * @param data      the destination of the bytes being read
+		 * @param length    the number of bytes to be read
+		 */
+		inline void read(unsigned char* data, size_t length) noexcept {
+			read(reinterpret_cast<char*>(data), length);
+		}
+
+		/**
+		 * Skips <tt>length</tt> bytes of the current message without reading them.
+		 *
+		 * @param length    the number of bytes to be skipped
+		 */
+		inline void skip(size_t length) noexcept {
+			assert(length <= remaining() && "SpscRing skip past the end of the message");
+			current += length;
+		}
+
+	public:
+		/**
+		 * @return the next byte to be read
+		 */
+		const char* data() const noexcept {
+			return current;
+		}
+
+		/**
+		 * @return the length of the current message
+		 */
+		size_t size() const noexcept {
+			return static_cast<size_t>(last - first);
+		}
+
+		/**
+		 * @return the number of bytes of the current message that can still be read
+		 */
+		size_t remaining() const noexcept {
+			return static_cast<size_t>(last - current);
+		}
+	};
+
+}
+
+#endif //PACKETBUFFER_BUFFER_SPSCRING_H
@@ -0,0 +1,498 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_BUFFEREDUNPACKER_H
+#define PACKETBUFFER_BUFFEREDUNPACKER_H
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "Buffer/GrowableBuffer.h"
+#include "Buffer/SpanReader.h"
+#include "ElementStream.h"
+#include "PackedSize.h"
+#include "StreamVByte.h"
+#include "Unpacker.h"
+
+namespace PacketBuffer {
+
+	/**
+	 * The outcome of BufferedUnpacker::unpack().
+	 */
+	enum class UnpackStatus {
+		/**
+		 * A value was unpacked and its bytes were consumed
+		 */
+		Complete,
+
+		/**
+		 * The received bytes do not hold a complete value yet
+		 */
+		NeedMoreData,
+
+		/**
+		 * The input is invalid. The error is given by BufferedUnpacker::error().
+		 */
+		Failed
+	};
+
+	/**
+	 * Tells whether a BufferedUnpacker resumes unpacking values of type <tt>T</tt> element by
+	 * element. Containers packed as a length followed by their elements qualify.
+	 *
+	 * @tparam T the value type
+	 */
+	template<typename T>
+	struct IsResumableContainer : std::false_type {
+	};
+
+	template<typename T, typename Allocator>
+	struct IsResumableContainer<std::vector<T, Allocator>> : std::true_type {
+	};
+
+	template<typename T, typename Allocator>
+	struct IsResumableContainer<std::list<T, Allocator>> : std::true_type {
+	};
+
+	template<typename T, typename Compare, typename Allocator>
+	struct IsResumableContainer<std::set<T, Compare, Allocator>> : std::true_type {
+	};
+
+	template<typename T, typename Hash, typename Predicate, typename Allocator>
+	struct IsResumableContainer<std::unordered_set<T, Hash, Predicate, Allocator>> : std::true_type {
+	};
+
+	template<typename K, typename V, typename Compare, typename Allocator>
+	struct IsResumableContainer<std::map<K, V, Compare, Allocator>> : std::true_type {
+	};
+
+	template<typename K, typename V, typename Hash, typename Predicate, typename Allocator>
+	struct IsResumableContainer<std::unordered_map<K, V, Hash, Predicate, Allocator>> : std::true_type {
+	};
+
+	template<typename T, typename Traits, typename Allocator>
+	struct IsResumableContainer<std::basic_string<T, Traits, Allocator>> : std::true_type {
+	};
+
+	/**
+	 * Tells whether the elements of a resumable container of type <tt>T</tt> are packed with
+	 * Packer::packArray(), so that they can be unpacked in place in chunks.
+	 *
+	 * @tparam T the container type
+	 */
+	template<typename T>
+	struct IsPackedAsArray : std::false_type {
+	};
+
+	template<typename T, typename Allocator>
+	struct IsPackedAsArray<std::vector<T, Allocator>> : std::integral_constant<bool, !std::is_same<T, bool>::value> {
+	};
+
+	template<>
+	struct IsPackedAsArray<std::string> : std::true_type {
+	};
+
+	/**
+	 * The BufferedUnpacker template class unpacks values from a stream that is received in
+	 * arbitrary fragments, such as a TCP connection, without ever blocking.
+	 *
+	 * Received bytes are appended to a receive buffer owned by the BufferedUnpacker, ideally by
+	 * reading from the socket straight into it with prepare() and commit(). unpack() then either
+	 * unpacks the next value, or unpacks as much of it as was received and tells that more data
+	 * is needed. Consumed bytes are discarded on the next call to prepare() or feed().
+	 *
+	 * Containers packed as a length followed by their elements, such as std::vector, std::list,
+	 * std::set, std::map and std::string, are resumed: their length is unpacked once, and each
+	 * call then unpacks the elements that were fully received into the container and consumes
+	 * their bytes. Only the incomplete element is kept buffered, and finished elements are never
+	 * unpacked again, so a large container costs no more memory than its largest element on top
+	 * of the container itself. Elements packed with Packer::packArray() are unpacked in place, in
+	 * bulk. The container length is checked against the Limits only, not against the received
+	 * bytes, and the container grows as its elements arrive.
+	 *
+	 * Other values are unpacked whole: an attempt that runs out of bytes is dropped and the value
+	 * is unpacked again from its first byte once the bytes it was missing have been received.
+	 * Values with a fixed packed size are only attempted once fully received, and elements are
+	 * attempted the same way. A large message made of fields of a struct should be sent as a
+	 * frame instead, see FrameReassembler.
+	 *
+	 * StringView and ByteSpan values point into the receive buffer and stay valid until the next
+	 * call to prepare() or feed().
+	 *
+	 * @code
+	 *  BufferedUnpacker<> stream;
+	 *  std::vector<Sample> samples;
+	 *  for(;;) {
+	 *      ssize_t received = recv(socket, stream.prepare(4096), 4096, 0);
+	 *      stream.commit(received);
+	 *
+	 *      while(stream.unpack(samples) == UnpackStatus::Complete) {
+	 *          handle(samples);
+	 *      }
+	 *  }
+	 * @endcode
+	 *
+	 * @tparam Endianess    the endianess used to decode integer types
+	 * @tparam Encoding     the encoding used for integer types and container lengths
+	 * @tparam Allocator    the allocator used for the receive buffer
+	 */
+	template<boost::endian::order Endianess = boost::endian::order::little,
+			IntegerEncoding Encoding = IntegerEncoding::Fixed, typename Allocator = std::allocator<char>>
+	class BufferedUnpacker {
+	private:
+		/**
+		 * The Unpacker type used to unpack buffered values
+		 */
+		using StreamUnpacker = Unpacker<SpanReader, Endianess, Encoding, Bounds::Checked>;
+
+		/**
+		 * The received bytes that were not consumed yet, preceded by
+		 * <tt>offset</tt> consumed bytes
+		 */
+		GrowableBuffer<Allocator> input;
+
+		/**
+		 * The number of consumed bytes at the start of <tt>input</tt>
+		 */
+		size_t offset = 0;
+
+		/**
+		 * The number of unconsumed bytes required before the next attempt
+		 */
+		size_t needed = 0;
+
+		/**
+		 * The maximum number of unconsumed bytes that can be buffered
+		 */
+		size_t maxBuffered;
+
+		/**
+		 * The limits applied to containers of each unpacked value
+		 */
+		Limits limits;
+
+		/**
+		 * What is left of the limits of the container being resumed
+		 */
+		Limits budget;
+
+		/**
+		 * Whether the length of a container was unpacked but some of its elements were not
+		 */
+		bool resuming = false;
+
+		/**
+		 * The number of elements of the container being resumed that were not unpacked yet
+		 */
+		uint64_t left = 0;
+
+		/**
+		 * The error that failed the stream
+		 */
+		UnpackError state = UnpackError::None;
+
+	public:
+		/**
+		 * Creates a new BufferedUnpacker.
+		 *
+		 * @param maxBuffered   the maximum size of a value, or of an element of a resumed
+		 *                      container, in bytes. One that needs more is failed with
+		 *                      UnpackError::LimitExceeded instead of being buffered.
+		 * @param limits        the limits applied to containers of each unpacked value
+		 * @param allocator     the allocator used for the receive buffer
+		 */
+		explicit BufferedUnpacker(size_t maxBuffered = std::numeric_limits<size_t>::max(),
+								   const Limits& limits = Limits(), const Allocator& allocator = Allocator()) :
+				input(0, allocator), maxBuffered(maxBuffered), limits(limits) {}
+
+	public: // Receive buffer
+		/**
+		 * Makes room for <tt>length</tt> received bytes at the end of the receive buffer. Consumed
+		 * bytes are discarded first.
+		 *
+		 * @param length the maximum number of bytes to be received
+		 *
+		 * @return the first byte where received bytes must be written
+		 */
+		char* prepare(size_t length) {
+			input.consume(offset);
+			offset = 0;
+			return input.prepare(length);
+		}
+
+		/**
+		 * Appends <tt>length</tt> bytes written through prepare() to the received bytes.
+		 *
+		 * @param length the number of bytes received
+		 */
+		void commit(size_t length) noexcept {
+			input.commit(length);
+		}
+
+		/**
+		 * Copies <tt>length</tt> received bytes from <tt>data</tt> into the receive buffer.
+		 *
+		 * @param data      the received bytes
+		 * @param length    the number of bytes received
+		 */
+		void feed(const char* data, size_t length) {
+			std::memcpy(prepare(length), data, length);
+			commit(length);
+		}
+
+		/**
+		 * @return the number of received bytes that were not consumed yet
+		 */
+		size_t buffered() const noexcept {
+			return input.size() - offset;
+		}
+
+	public: // Unpacking
+		/**
+		 * Unpacks the next value from the received bytes.
+		 *
+		 * A resumable container is cleared once its length has been received, and the elements
+		 * received so far are kept in it until it is complete: the same container must be given
+		 * to the following calls. Any other value is reset to a default constructed value before
+		 * each attempt and is left in an unspecified state if it is not complete yet.
+		 *
+		 * @tparam T        the type of the value to be unpacked
+		 * @param value     the value to unpack to
+		 *
+		 * @return whether the value was unpacked, needs more data or failed
+		 */
+		template<typename T>
+		UnpackStatus unpack(T& value) {
+			if(state != UnpackError::None) {
+				return UnpackStatus::Failed;
+			}
+			return unpack(value, IsResumableContainer<T>());
+		}
+
+		/**
+		 * @return whether a container was partially unpacked and waits for more elements
+		 */
+		bool pending() const noexcept {
+			return resuming;
+		}
+
+		/**
+		 * @return the error that failed the stream
+		 */
+		UnpackError error() const noexcept {
+			return state;
+		}
+
+		/**
+		 * Discards all buffered bytes, abandons the container being resumed and clears the error,
+		 * keeping the receive buffer memory.
+		 */
+		void reset() noexcept {
+			input.reset();
+			offset = 0;
+			needed = 0;
+			resuming = false;
+			left = 0;
+			state = UnpackError::None;
+		}
+
+	private:
+		/**
+		 * Unpacks a whole value, or none of it.
+		 */
+		template<typename T>
+		UnpackStatus unpack(T& value, std::false_type) {
+			const size_t available = buffered();
+			if(available < std::max(needed, minimumSizeOf<T>(nullptr))) {
+				return UnpackStatus::NeedMoreData;
+			}
+
+			SpanReader reader(input.data() + offset, available);
+			StreamUnpacker unpacker(reader, limits);
+			value = T();
+			unpacker.unpack(value);
+			if(!unpacker.good()) {
+				return retry(unpacker, available);
+			}
+
+			offset += reader.position();
+			needed = 0;
+			return UnpackStatus::Complete;
+		}
+
+		/**
+		 * Unpacks the length of a container, if not done yet, followed by as many of its
+		 * elements as were received.
+		 */
+		template<typename T>
+		UnpackStatus unpack(T& container, std::true_type) {
+			const size_t available = buffered();
+			if(available < needed) {
+				return UnpackStatus::NeedMoreData;
+			}
+			if(!resuming) {
+				budget = limits;
+			}
+
+			SpanReader reader(input.data() + offset, available);
+			StreamUnpacker unpacker(reader, budget);
+			size_t consumed = 0;
+
+			if(!resuming) {
+				uint64_t items;
+				unpacker.unpackLength(items);
+				if(!unpacker.good() || !unpacker.checkLimits(container, items)) {
+					return retry(unpacker, available);
+				}
+				container.clear();
+				left = items;
+				resuming = true;
+				consumed = reader.position();
+				budget = unpacker.getLimits();
+			}
+
+			while(left != 0 && unpackElements(unpacker, container, IsPackedAsArray<T>())) {
+				consumed = reader.position();
+				budget = unpacker.getLimits();
+			}
+
+			offset += consumed;
+			if(left != 0) {
+				return retry(unpacker, available - consumed);
+			}
+			resuming = false;
+			needed = 0;
+			return UnpackStatus::Complete;
+		}
+
+		/**
+		 * Unpacks the next elements of a container packed with Packer::packArray() in place: all
+		 * the received ones when their packed size is fixed, a StreamVByte block or a single
+		 * element otherwise.
+		 *
+		 * @return whether the elements were unpacked
+		 */
+		template<typename T>
+		bool unpackElements(StreamUnpacker& unpacker, T& container, std::true_type) {
+			using Element = typename T::value_type;
+			constexpr ArrayLayout Layout = ArrayLayoutOf<Element, Endianess, Encoding>::value;
+
+			uint64_t items = 1;
+			if(Layout == ArrayLayout::Bitwise || Layout == ArrayLayout::ByteSwapped) {
+				items = std::max<uint64_t>(1, std::min<uint64_t>(left, unpacker.remaining() / sizeof(Element)));
+			} else if(Layout == ArrayLayout::StreamVByte) {
+				items = std::min<uint64_t>(left, StreamVByte::BlockLength);
+			}
+
+			const size_t done = container.size();
+			container.resize(done + static_cast<size_t>(items));
+			unpacker.unpackArray(&container[done], static_cast<size_t>(items));
+			if(!unpacker.good()) {
+				container.resize(done);
+				return false;
+			}
+			left -= items;
+			return true;
+		}
+
+		/**
+		 * Unpacks the next element of a container and inserts it at its end.
+		 *
+		 * @return whether the element was unpacked
+		 */
+		template<typename T>
+		bool unpackElements(StreamUnpacker& unpacker, T& container, std::false_type) {
+			typename StreamElement<typename T::value_type>::type element{};
+			unpacker.unpack(element);
+			if(!unpacker.good()) {
+				return false;
+			}
+			container.insert(container.end(), std::move(element));
+			left--;
+			return true;
+		}
+
+		/**
+		 * Waits for the bytes a failed attempt was missing, or fails the stream if the input is
+		 * invalid.
+		 *
+		 * @param unpacker  the failed unpacker
+		 * @param pending   the number of unconsumed bytes the attempt was given
+		 */
+		UnpackStatus retry(const StreamUnpacker& unpacker, size_t pending) {
+			switch(unpacker.error()) {
+				case UnpackError::Truncated:
+				case UnpackError::LengthTooLarge:
+					if(unpacker.missing() > maxBuffered - std::min(pending, maxBuffered)) {
+						state = UnpackError::LimitExceeded;
+						return UnpackStatus::Failed;
+					}
+					needed = pending + unpacker.missing();
+					return UnpackStatus::NeedMoreData;
+
+				default:
+					state = unpacker.error();
+					return UnpackStatus::Failed;
+			}
+		}
+
+		/**
+		 * @return the packed size of a value of type <tt>T</tt>, which has a fixed packed size
+		 */
+		template<typename T>
+		static constexpr size_t minimumSizeOf(
+				typename std::enable_if<Encoding != IntegerEncoding::Varint,
+						EnableIfMaxPackedSize<Encoding, T>>::type* = nullptr) noexcept {
+			return MaxPackedSize<T, Encoding>::value;
+		}
+
+		/**
+		 * @return zero, as the packed size of a value of type <tt>T</tt> is not known upfront
+		 */
+		template<typename T>
+		static constexpr size_t minimumSizeOf(...) noexcept {
+			return 0;
+		}
+
+	};
+
+}
+
+#endif //PACKETBUFFER_BUFFEREDUNPACKER_H
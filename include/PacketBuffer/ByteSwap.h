@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_BYTESWAP_H
+#define PACKETBUFFER_BYTESWAP_H
+
+#include <boost/endian/conversion.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "ObjectSerializer.h"
+#include "Policy.h"
+
+#if !defined(PACKETBUFFER_NO_SIMD) && (defined(__GNUC__) || defined(__clang__)) && \
+		(defined(__x86_64__) || defined(__i386__))
+#define PACKETBUFFER_BYTESWAP_X86 1
+#include <immintrin.h>
+#endif
+
+namespace PacketBuffer {
+
+	/**
+	 * Tells whether values of type <tt>T</tt> can be converted between byte
+	 * orders by reversing their bytes in bulk with ByteSwap::reverse().
+	 *
+	 * @tparam T the value type
+	 */
+	template<typename T>
+	struct IsByteSwappable : std::integral_constant<bool,
+			(std::is_arithmetic<T>::value || std::is_enum<T>::value) && !std::is_same<T, long double>::value &&
+			(sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)> {
+	};
+
+	/**
+	 * Bulk byte order conversion kernels.
+	 *
+	 * On x86, SSSE3 and AVX2 kernels reverse 16 or 32 bytes per instruction
+	 * with <tt>pshufb</tt>. The fastest kernel supported by the running CPU
+	 * is selected on first use. Defining <tt>PACKETBUFFER_NO_SIMD</tt>
+	 * restricts the conversion to the scalar kernel.
+	 */
+	namespace ByteSwap {
+
+		/**
+		 * A kernel that reverses the bytes of <tt>count</tt> elements read
+		 * from <tt>source</tt> and writes them to <tt>destination</tt>. Both
+		 * pointers may be equal, but the ranges must not partially overlap.
+		 */
+		using Kernel = void (*)(char* destination, const char* source, size_t count);
+
+		/**
+		 * The unsigned integer type with <tt>Width</tt> bytes.
+		 */
+		template<size_t Width>
+		using UnsignedOf = typename std::conditional<Width == 2, uint16_t,
+				typename std::conditional<Width == 4, uint32_t, uint64_t>::type>::type;
+
+		/**
+		 * Reverses the bytes of <tt>count</tt> elements of <tt>Width</tt>
+		 * bytes one element at a time.
+		 */
+		template<size_t Width>
+		inline void reverseScalar(char* destination, const char* source, size_t count) {
+			for(size_t i = 0; i < count; i++) {
+				UnsignedOf<Width> value;
+				std::memcpy(&value, source + i * Width, Width);
+				value = boost::endian::endian_reverse(value);
+				std::memcpy(destination + i * Width, &value, Width);
+			}
+		}
+
+#if defined(PACKETBUFFER_BYTESWAP_X86)
+		/**
+		 * @return a pshufb mask that reverses every <tt>Width</tt> byte
+		 * element of a 16 byte lane
+		 */
+		template<size_t Width>
+		__attribute__((target("ssse3")))
+		inline __m128i reverseMask() {
+			alignas(16) char mask[16];
+			for(int i = 0; i < 16; i++) {
+				mask[i] = static_cast<char>(i / Width * Width + (Width - 1 - i % Width));
+			}
+			return _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+		}
+
+		/**
+		 * Reverses the bytes of <tt>count</tt> elements of <tt>Width</tt>
+		 * bytes, 16 bytes at a time.
+		 */
+		template<size_t Width>
+		__attribute__((target("ssse3")))
+		inline void reverseSSSE3(char* destination, const char* source, size_t count) {
+			const __m128i mask = reverseMask<Width>();
+			const size_t bytes = count * Width;
+
+			size_t i = 0;
+			for(; i + 16 <= bytes; i += 16) {
+				__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_shuffle_epi8(block, mask));
+			}
+			reverseScalar<Width>(destination + i, source + i, (bytes - i) / Width);
+		}
+
+		/**
+		 * Reverses the bytes of <tt>count</tt> elements of <tt>Width</tt>
+		 * bytes, 64 bytes at a time.
+		 */
+		template<size_t Width>
+		__attribute__((target("avx2")))
+		inline void reverseAVX2(char* destination, const char* source, size_t count) {
+			const __m128i lane = reverseMask<Width>();
+			const __m256i mask = _mm256_broadcastsi128_si256(lane);
+			const size_t bytes = count * Width;
+
+			size_t i = 0;
+			for(; i + 64 <= bytes; i += 64) {
+				__m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+				__m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i + 32));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), _mm256_shuffle_epi8(first, mask));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i + 32), _mm256_shuffle_epi8(second, mask));
+			}
+			for(; i + 16 <= bytes; i += 16) {
+				__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_shuffle_epi8(block, lane));
+			}
+			reverseScalar<Width>(destination + i, source + i, (bytes - i) / Width);
+		}
+#endif
+
+		/**
+		 * @return the fastest kernel supported by the running CPU
+		 */
+		template<size_t Width>
+		inline Kernel selectKernel() {
+#if defined(PACKETBUFFER_BYTESWAP_X86)
+			__builtin_cpu_init();
+			if(__builtin_cpu_supports("avx2")) {
+				return &reverseAVX2<Width>;
+			}
+			if(__builtin_cpu_supports("ssse3")) {
+				return &reverseSSSE3<Width>;
+			}
+#endif
+			return &reverseScalar<Width>;
+		}
+
+		/**
+		 * Reverses the bytes of <tt>count</tt> elements of <tt>Width</tt>
+		 * bytes read from <tt>source</tt> and writes them to
+		 * <tt>destination</tt>, using the fastest kernel supported by the
+		 * running CPU.
+		 *
+		 * @tparam Width        the element width, either 2, 4 or 8 bytes
+		 * @param destination   the converted elements
+		 * @param source        the elements to be converted
+		 * @param count         the number of elements
+		 */
+		template<size_t Width>
+		inline void reverse(char* destination, const char* source, size_t count) {
+			static_assert(Width == 2 || Width == 4 || Width == 8, "Width must be 2, 4 or 8 bytes");
+			if(count * Width < 32) {
+				reverseScalar<Width>(destination, source, count);
+				return;
+			}
+			static const Kernel kernel = selectKernel<Width>();
+			kernel(destination, source, count);
+		}
+
+	}
+
+	/**
+	 * How a contiguous range of values is packed and unpacked.
+	 */
+	enum class ArrayLayout {
+		/**
+		 * Each element is packed individually
+		 */
+		ElementWise,
+
+		/**
+		 * The range is copied as is, with a single write or read
+		 */
+		Bitwise,
+
+		/**
+		 * The range is copied with a single write or read and its elements
+		 * are byte swapped in bulk
+		 */
+		ByteSwapped,
+
+		/**
+		 * The range is varint encoded in blocks, with the StreamVByte format
+		 */
+		StreamVByte
+	};
+
+	/**
+	 * Selects the ArrayLayout for a range of values of type <tt>T</tt>
+	 * packed with <tt>Endianess</tt>, <tt>Encoding</tt> and <tt>Floats</tt>.
+	 *
+	 * With FloatEncoding::Single, doubles and bitwise packable structs,
+	 * which may hold doubles, are packed element-wise.
+	 *
+	 * @tparam T            the element type
+	 * @tparam Endianess    the wire endianess
+	 * @tparam Encoding     the integer encoding
+	 * @tparam Floats       the floating point encoding
+	 */
+	template<typename T, boost::endian::order Endianess, IntegerEncoding Encoding = IntegerEncoding::Fixed,
+			FloatEncoding Floats = FloatEncoding::Exact>
+	struct ArrayLayoutOf : std::integral_constant<ArrayLayout,
+			!IsBitwisePackable<T>::value ? ArrayLayout::ElementWise :
+			(Floats == FloatEncoding::Single && (std::is_same<T, double>::value || std::is_class<T>::value)) ?
+			ArrayLayout::ElementWise :
+			(Encoding == IntegerEncoding::Varint && std::is_same<T, uint32_t>::value) ? ArrayLayout::StreamVByte :
+			(Encoding == IntegerEncoding::Varint && sizeof(T) != 1 && !std::is_floating_point<T>::value) ?
+			ArrayLayout::ElementWise :
+			(sizeof(T) == 1 || Endianess == boost::endian::order::native) ? ArrayLayout::Bitwise :
+			IsByteSwappable<T>::value ? ArrayLayout::ByteSwapped : ArrayLayout::ElementWise> {
+	};
+
+}
+
+#endif //PACKETBUFFER_BYTESWAP_H
@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_DISPATCHER_H
+#define PACKETBUFFER_DISPATCHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace PacketBuffer {
+
+	/**
+	 * Registers the message type <tt>T</tt> under the numeric id <tt>Id</tt> in a MessageRegistry.
+	 *
+	 * @tparam Id   the message id, sent ahead of the message
+	 * @tparam T    the message type
+	 */
+	template<uint64_t Id, typename T>
+	struct MessageType {
+		/**
+		 * The message id
+		 */
+		static constexpr uint64_t id = Id;
+
+		/**
+		 * The message type
+		 */
+		using Type = T;
+	};
+
+	/**
+	 * A compile-time registry of message types, each given as a MessageType.
+	 *
+	 * Ids must be unique and should be dense: a Dispatcher has one jump table entry per id from
+	 * zero up to the largest registered id. A message type may be registered under several ids,
+	 * in which case idOf() gives the first one.
+	 *
+	 * @code
+	 *  using Messages = MessageRegistry<
+	 *      MessageType<1, Login>,
+	 *      MessageType<2, Move>,
+	 *      MessageType<3, Chat>
+	 *  >;
+	 *
+	 *  framer.pack(Messages::idOf<Move>(), move);
+	 * @endcode
+	 *
+	 * @tparam Registrations the registered MessageType
+	 */
+	template<typename... Registrations>
+	struct MessageRegistry {
+	private:
+		static constexpr uint64_t ids[] = {Registrations::id...};
+
+		static constexpr uint64_t findMaxId() noexcept {
+			uint64_t max = 0;
+			for(uint64_t id : ids) {
+				max = id > max ? id : max;
+			}
+			return max;
+		}
+
+		static constexpr bool unique() noexcept {
+			for(size_t i = 0; i < sizeof...(Registrations); i++) {
+				for(size_t j = i + 1; j < sizeof...(Registrations); j++) {
+					if(ids[i] == ids[j]) {
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+
+		template<typename T>
+		static constexpr uint64_t findId() noexcept {
+			const bool matches[] = {std::is_same<T, typename Registrations::Type>::value...};
+			for(size_t i = 0; i < sizeof...(Registrations); i++) {
+				if(matches[i]) {
+					return ids[i];
+				}
+			}
+			return ~uint64_t(0);
+		}
+
+		static_assert(sizeof...(Registrations) != 0, "A MessageRegistry must register at least one message type");
+		static_assert(unique(), "Every message type of a MessageRegistry must have a distinct id");
+
+	public:
+		/**
+		 * The number of registered message types
+		 */
+		static constexpr size_t size = sizeof...(Registrations);
+
+		/**
+		 * The largest registered id
+		 */
+		static constexpr uint64_t maxId = findMaxId();
+
+		/**
+		 * @tparam T a registered message type
+		 *
+		 * @return the id of the message type <tt>T</tt>
+		 */
+		template<typename T>
+		static constexpr uint64_t idOf() noexcept {
+			static_assert(findId<T>() != ~uint64_t(0), "The message type T is not registered");
+			return findId<T>();
+		}
+	};
+
+	template<typename... Registrations>
+	constexpr uint64_t MessageRegistry<Registrations...>::ids[];
+
+	template<typename Registry, typename Unpacker, typename Handler>
+	class Dispatcher;
+
+	/**
+	 * The Dispatcher template class unpacks a message whose type is only known at runtime, from
+	 * its id, and hands it to a typed handler.
+	 *
+	 * The id selects an entry of a dense jump table built at compile time: dispatching costs one
+	 * bounds check and one indirect call, whatever the number of registered types. Each registered
+	 * id has a slot in the Dispatcher, which every message of that id is unpacked over. Containers
+	 * in the slot are cleared rather than freed, so strings and vectors keep their capacity and a
+	 * std::list keeps its nodes from one message to the next.
+	 *
+	 * The handler is called with the unpacked message as a <tt>T&</tt>, so it is usually a struct
+	 * overloading <tt>operator()</tt> for each message type. It is only called when the message
+	 * was unpacked without error.
+	 *
+	 * @code
+	 *  struct Session {
+	 *      void operator()(const Login& login);
+	 *      void operator()(const Move& move);
+	 *      void operator()(const Chat& chat);
+	 *  };
+	 *
+	 *  using MessageUnpacker = Unpacker<SpanReader, boost::endian::order::little, IntegerEncoding::Fixed, Bounds::Checked>;
+	 *
+	 *  Session session;
+	 *  Dispatcher<Messages, MessageUnpacker, Session> dispatcher(session);
+	 *
+	 *  SpanReader reader(frame.payload.data(), frame.payload.size());
+	 *  MessageUnpacker unpacker(reader);
+	 *  if(!dispatcher.dispatch(frame.type, unpacker)) {
+	 *      // unknown message type
+	 *  }
+	 * @endcode
+	 *
+	 * @tparam Registry     the MessageRegistry of the dispatched message types
+	 * @tparam Unpacker     the Unpacker type messages are unpacked with
+	 * @tparam Handler      the type of the handler of unpacked messages
+	 */
+	template<typename... Registrations, typename Unpacker, typename Handler>
+	class Dispatcher<MessageRegistry<Registrations...>, Unpacker, Handler> {
+	private:
+		using Registry = MessageRegistry<Registrations...>;
+
+		static_assert(Registry::maxId < 65536, "Message ids must be dense enough for a jump table");
+
+		/**
+		 * A jump table entry, unpacking and handling a message of one type
+		 */
+		using Entry = void (*)(Dispatcher&, Unpacker&);
+
+		/**
+		 * The jump table, indexed by message id
+		 */
+		struct Table {
+			Entry entries[Registry::maxId + 1];
+		};
+
+		/**
+		 * The handler of unpacked messages
+		 */
+		Handler& handler;
+
+		/**
+		 * The type of the message slots
+		 */
+		using Slots = std::tuple<typename Registrations::Type...>;
+
+		/**
+		 * The reused message slots, one per registered id, in registration order
+		 */
+		Slots slots;
+
+	public:
+		/**
+		 * Creates a new Dispatcher.
+		 *
+		 * @param handler the handler of unpacked messages
+		 */
+		explicit Dispatcher(Handler& handler) : handler(handler) {}
+
+		/**
+		 * Unpacks a message of the type registered as <tt>id</tt> and hands it to the handler.
+		 *
+		 * @param id        the message id
+		 * @param unpacker  the unpacker to read the message from
+		 *
+		 * @return false if no message type is registered as <tt>id</tt>
+		 */
+		bool dispatch(uint64_t id, Unpacker& unpacker) {
+			static constexpr Table table = makeTable();
+			if(id > Registry::maxId || table.entries[id] == nullptr) {
+				return false;
+			}
+			table.entries[id](*this, unpacker);
+			return true;
+		}
+
+		/**
+		 * Unpacks a message id, as a varint, followed by a message of the type registered under
+		 * that id, and hands the message to the handler.
+		 *
+		 * @param unpacker the unpacker to read the id and the message from
+		 *
+		 * @return false if no message type is registered under the id, or the id could not be
+		 * unpacked
+		 */
+		bool dispatch(Unpacker& unpacker) {
+			uint64_t id = 0;
+			unpacker.unpackVarint(id);
+			return unpacker.good() && dispatch(id, unpacker);
+		}
+
+		/**
+		 * @tparam T a message type registered under a single id
+		 *
+		 * @return the slot messages of type <tt>T</tt> are unpacked to
+		 */
+		template<typename T>
+		T& slot() noexcept {
+			return std::get<T>(slots);
+		}
+
+	private:
+		/**
+		 * Unpacks a message of the type registered at <tt>Index</tt> into its slot and hands it
+		 * to the handler.
+		 */
+		template<size_t Index>
+		static void invoke(Dispatcher& dispatcher, Unpacker& unpacker) {
+			using T = typename std::tuple_element<Index, Slots>::type;
+			T& message = std::get<Index>(dispatcher.slots);
+			unpacker.unpack(message);
+			if(unpacker.good()) {
+				dispatcher.handler(message);
+			}
+		}
+
+		/**
+		 * @return the jump table of the registered message types
+		 */
+		static constexpr Table makeTable() noexcept {
+			return makeTable(std::index_sequence_for<Registrations...>());
+		}
+
+		/**
+		 * @return the jump table of the registered message types
+		 */
+		template<size_t... Indexes>
+		static constexpr Table makeTable(std::index_sequence<Indexes...>) noexcept {
+			Table table = {};
+			const uint64_t ids[] = {Registrations::id...};
+			const Entry entries[] = {&invoke<Indexes>...};
+			for(size_t i = 0; i < sizeof...(Registrations); i++) {
+				table.entries[ids[i]] = entries[i];
+			}
+			return table;
+		}
+	};
+
+}
+
+#endif //PACKETBUFFER_DISPATCHER_H
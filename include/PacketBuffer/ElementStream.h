@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_ELEMENTSTREAM_H
+#define PACKETBUFFER_ELEMENTSTREAM_H
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ObjectSerializer.h"
+#include "StreamVByte.h"
+#include "Unpacker.h"
+
+namespace PacketBuffer {
+
+	/**
+	 * The type an element of a container is unpacked as. Map entries are unpacked with a
+	 * mutable key.
+	 *
+	 * @tparam T the container value type
+	 */
+	template<typename T>
+	struct StreamElement {
+		using type = T;
+	};
+
+	template<typename K, typename V>
+	struct StreamElement<std::pair<const K, V>> {
+		using type = std::pair<K, V>;
+	};
+
+	template<typename Container, typename Unpacker>
+	class ElementStream;
+
+	/**
+	 * The ElementStream template class unpacks the elements of a packed container one at a time,
+	 * without ever materializing the container. Any container packed with a length followed by
+	 * its elements can be streamed, such as std::vector, std::list, std::set and std::map.
+	 *
+	 * The length is unpacked on construction. Elements are then unpacked as the input iterator
+	 * advances. Contiguous ranges of bitwise packable elements are unpacked in chunks of
+	 * StreamVByte::BlockLength elements with Unpacker::unpackArray(), so memory stays constant in
+	 * the container length:
+	 *
+	 * @code
+	 *  ElementStream<std::vector<uint32_t>, Unpacker<SpanReader>> samples(unpacker);
+	 *  uint64_t sum = 0;
+	 *  for(uint32_t sample : samples) {
+	 *      sum += sample;
+	 *  }
+	 * @endcode
+	 *
+	 * Iteration stops early if the Unpacker fails. The Unpacker is positioned after the
+	 * container only once every element has been streamed; call finish() to skip the elements
+	 * that were not iterated.
+	 *
+	 * @tparam Container    the packed container type
+	 * @tparam Buffer       the buffer type of the Unpacker
+	 * @tparam Policy       the PackingPolicy of the Unpacker
+	 */
+	template<typename Container, typename Buffer, typename Policy>
+	class ElementStream<Container, BasicUnpacker<Buffer, Policy>> {
+	public:
+		using value_type = typename StreamElement<typename Container::value_type>::type;
+
+		class iterator;
+
+	private:
+		/**
+		 * Whether the container is packed with Packer::packArray(), which packs <tt>uint32_t</tt>
+		 * ranges as StreamVByte blocks with IntegerEncoding::Varint
+		 */
+		static constexpr bool PackedAsArray = std::is_same<Container,
+				std::vector<value_type, typename Container::allocator_type>>::value;
+
+		/**
+		 * Whether elements are unpacked in chunks. StreamVByte blocks are only decoded whole,
+		 * so containers packed element by element cannot be chunked in that encoding.
+		 */
+		static constexpr bool Chunked = IsBitwisePackable<value_type>::value &&
+				(PackedAsArray || Policy::encoding != IntegerEncoding::Varint ||
+				 !std::is_same<value_type, uint32_t>::value);
+
+		/**
+		 * The number of elements unpacked at once. Chunks of StreamVByte::BlockLength line up
+		 * with the blocks of a StreamVByte encoded range.
+		 */
+		static constexpr size_t ChunkLength = Chunked ? StreamVByte::BlockLength : 1;
+
+		/**
+		 * The unpacker to read elements from
+		 */
+		BasicUnpacker<Buffer, Policy>& unpacker;
+
+		/**
+		 * The number of elements in the container
+		 */
+		uint64_t count = 0;
+
+		/**
+		 * The number of elements not yet unpacked
+		 */
+		uint64_t left = 0;
+
+		/**
+		 * The unpacked elements
+		 */
+		std::array<value_type, ChunkLength> chunk;
+
+		/**
+		 * The index of the current element in the chunk
+		 */
+		size_t position = 0;
+
+		/**
+		 * The number of elements in the chunk
+		 */
+		size_t filled = 0;
+
+	public:
+		/**
+		 * Creates a new stream and unpacks the container length. The length is validated like
+		 * the one of a stored container, with Unpacker::checkStreamedLength(), but the elements
+		 * are not charged against the allocation budget since at most a chunk of them is held.
+		 *
+		 * @param unpacker the unpacker to read elements from
+		 */
+		explicit ElementStream(BasicUnpacker<Buffer, Policy>& unpacker) : unpacker(unpacker) {
+			unpacker.unpackLength(count);
+			left = unpacker.good() && unpacker.template checkStreamedLength<Container>(count) ? count : 0;
+		}
+
+		ElementStream(const ElementStream& other) = delete;
+		ElementStream& operator=(const ElementStream& other) = delete;
+
+	public:
+		/**
+		 * @return the number of elements in the container
+		 */
+		uint64_t size() const noexcept {
+			return count;
+		}
+
+		/**
+		 * Returns an iterator to the next element that was not iterated. A stream can only be
+		 * iterated once: calling begin() again continues where the previous iteration stopped.
+		 *
+		 * @return an iterator to the next element
+		 */
+		iterator begin() {
+			return iterator(position < filled || refill() ? this : nullptr);
+		}
+
+		iterator end() noexcept {
+			return iterator(nullptr);
+		}
+
+		/**
+		 * Passes each element that was not iterated to <tt>visitor</tt>. Elements are visited a
+		 * chunk at a time, which is faster than advancing an iterator.
+		 *
+		 * @tparam Visitor  a callable taking a const reference to an element
+		 * @param visitor   the callable to pass each element to
+		 *
+		 * @return the number of elements passed to <tt>visitor</tt>
+		 */
+		template<typename Visitor>
+		uint64_t visit(Visitor&& visitor) {
+			uint64_t visited = 0;
+			for(bool more = position < filled || refill(); more; more = refill()) {
+				const value_type* elements = chunk.data();
+				const size_t from = position;
+				const size_t to = filled;
+				for(size_t i = from; i < to; i++) {
+					visitor(elements[i]);
+				}
+				visited += to - from;
+			}
+			return visited;
+		}
+
+		/**
+		 * Unpacks and discards the elements that were not iterated, so that the Unpacker is
+		 * positioned after the container.
+		 */
+		void finish() {
+			while(advance()) {
+			}
+		}
+
+	private:
+		/**
+		 * Moves to the next element.
+		 *
+		 * @return true if there is a next element
+		 */
+		bool advance() {
+			if(++position < filled) {
+				return true;
+			}
+			return refill();
+		}
+
+		/**
+		 * Unpacks the next chunk of elements.
+		 *
+		 * @return true if there is a next element
+		 */
+		bool refill() {
+			position = 0;
+			filled = 0;
+			if(left == 0 || !unpacker.good()) {
+				return false;
+			}
+
+			filled = left < ChunkLength ? static_cast<size_t>(left) : ChunkLength;
+			unpack(std::integral_constant<bool, Chunked>());
+			left -= filled;
+			if(!unpacker.good()) {
+				filled = 0;
+				left = 0;
+				return false;
+			}
+			return true;
+		}
+
+		void unpack(std::true_type) {
+			unpacker.unpackArray(chunk.data(), filled);
+		}
+
+		void unpack(std::false_type) {
+			unpacker.unpack(chunk[0]);
+		}
+
+	public:
+		/**
+		 * An input iterator over the elements of an ElementStream.
+		 */
+		class iterator {
+		public:
+			using iterator_category = std::input_iterator_tag;
+			using value_type = typename ElementStream::value_type;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const value_type*;
+			using reference = const value_type&;
+
+		private:
+			/**
+			 * The stream, or nullptr once exhausted
+			 */
+			ElementStream* stream;
+
+		public:
+			explicit iterator(ElementStream* stream) noexcept : stream(stream) {}
+
+		public:
+			reference operator*() const noexcept {
+				return stream->chunk[stream->position];
+			}
+
+			pointer operator->() const noexcept {
+				return &stream->chunk[stream->position];
+			}
+
+			iterator& operator++() {
+				if(++stream->position < stream->filled) {
+					return *this;
+				}
+				if(!stream->refill()) {
+					stream = nullptr;
+				}
+				return *this;
+			}
+
+			friend bool operator==(const iterator& lhs, const iterator& rhs) noexcept {
+				return lhs.stream == rhs.stream;
+			}
+
+			friend bool operator!=(const iterator& lhs, const iterator& rhs) noexcept {
+				return lhs.stream != rhs.stream;
+			}
+		};
+	};
+
+	/**
+	 * Unpacks the elements of a packed container one at a time and passes each one to
+	 * <tt>visitor</tt>, without materializing the container. See ElementStream.
+	 *
+	 * @code
+	 *  unpackEach<std::set<std::string>>(unpacker, [&](const std::string& tag) {
+	 *      tags.insert(tag);
+	 *  });
+	 * @endcode
+	 *
+	 * @tparam Container    the packed container type
+	 * @tparam Unpacker     the unpacker type
+	 * @tparam Visitor      a callable taking a const reference to an element
+	 * @param unpacker      the unpacker to read elements from
+	 * @param visitor       the callable to pass each element to
+	 *
+	 * @return the number of elements passed to <tt>visitor</tt>
+	 */
+	template<typename Container, typename Unpacker, typename Visitor>
+	inline uint64_t unpackEach(Unpacker& unpacker, Visitor&& visitor) {
+		ElementStream<Container, Unpacker> stream(unpacker);
+		return stream.visit(std::forward<Visitor>(visitor));
+	}
+
+}
+
+#endif //PACKETBUFFER_ELEMENTSTREAM_H
@@ -0,0 +1,437 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_FRAME_H
+#define PACKETBUFFER_FRAME_H
+
+#include <cstring>
+#include <limits>
+#include <memory>
+
+#include "Buffer/GrowableBuffer.h"
+#include "Buffer/SpanReader.h"
+#include "PackedSize.h"
+#include "Packer.h"
+#include "BufferedUnpacker.h"
+#include "Unpacker.h"
+#include "View.h"
+
+namespace PacketBuffer {
+
+	/**
+	 * A complete frame yielded by a FrameReassembler.
+	 */
+	struct Frame {
+		/**
+		 * The frame type id, or zero if the frame was sent without one
+		 */
+		uint64_t type = 0;
+
+		/**
+		 * The frame payload
+		 */
+		ByteSpan payload = ByteSpan();
+	};
+
+	/**
+	 * The header preceding every frame.
+	 *
+	 * A header is a LEB128 varint holding the payload length shifted left by
+	 * one bit, whose lowest bit tells whether a type id follows. The type id
+	 * is a second varint. Frames of type zero are sent without a type id, so
+	 * an untyped frame of less than 64 bytes only takes one header byte.
+	 */
+	namespace FrameHeader {
+
+		/**
+		 * The maximum number of bytes of a header
+		 */
+		constexpr size_t MaxLength = 2 * Varint::MaxLength;
+
+		/**
+		 * Decodes the header at the start of the <tt>available</tt> bytes at <tt>data</tt>.
+		 *
+		 * @param data          the received bytes
+		 * @param available     the number of received bytes
+		 * @param type          the frame type id
+		 * @param length        the frame payload length
+		 * @param headerLength  the number of bytes of the header
+		 *
+		 * @return UnpackError::Truncated if the header is incomplete, or UnpackError::Overflow if
+		 * it is invalid
+		 */
+		inline UnpackError decode(const char* data, size_t available, uint64_t& type, uint64_t& length,
+								  size_t& headerLength) noexcept {
+			SpanReader reader(data, available);
+			Unpacker<SpanReader, boost::endian::order::little, IntegerEncoding::Fixed, Bounds::Checked> unpacker(reader);
+
+			uint64_t word = 0;
+			unpacker.unpackVarint(word);
+			type = 0;
+			if(word & 1) {
+				unpacker.unpackVarint(type);
+			}
+			length = word >> 1;
+			headerLength = reader.position();
+			return unpacker.error();
+		}
+
+	}
+
+	/**
+	 * The FramePacker template class packs values as frames, each preceded by a FrameHeader, so
+	 * that the receiving side can tell where each value ends before unpacking it.
+	 *
+	 * The payload length is computed with packedSize() before the value is packed, so the value is
+	 * packed straight into the buffer without an intermediate copy.
+	 *
+	 * @code
+	 *  GrowableBuffer<> buffer;
+	 *  FramePacker<GrowableBuffer<>> framer(buffer);
+	 *  framer.pack(LoginType, login);
+	 *  framer.pack(QuoteType, quote);
+	 *  send(socket, buffer.data(), buffer.size(), 0);
+	 * @endcode
+	 *
+	 * @tparam Buffer       the buffer type to write frames to
+	 * @tparam Endianess    the endianess used to encode integer types of the payloads
+	 * @tparam Encoding     the encoding used for integer types and container lengths of the payloads
+	 */
+	template<typename Buffer, boost::endian::order Endianess = boost::endian::order::little,
+			IntegerEncoding Encoding = IntegerEncoding::Fixed>
+	class FramePacker {
+	private:
+		/**
+		 * The packer frames are written with
+		 */
+		Packer<Buffer, Endianess, Encoding> packer;
+
+	public:
+		/**
+		 * Creates a new FramePacker.
+		 *
+		 * @param buffer the buffer to write frames to
+		 */
+		explicit FramePacker(Buffer& buffer) : packer(buffer) {}
+
+		/**
+		 * Packs <tt>value</tt> in a frame without a type id.
+		 *
+		 * @tparam T        the type of the value to be packed
+		 * @param value     the value to be packed
+		 */
+		template<typename T>
+		void pack(const T& value) {
+			pack(0, value);
+		}
+
+		/**
+		 * Packs <tt>value</tt> in a frame of type <tt>type</tt>.
+		 *
+		 * @tparam T        the type of the value to be packed
+		 * @param type      the frame type id, zero for none
+		 * @param value     the value to be packed
+		 */
+		template<typename T>
+		void pack(uint64_t type, const T& value) {
+			packHeader(type, packedSize<Encoding>(value));
+			packer.pack(value);
+		}
+
+		/**
+		 * Packs <tt>length</tt> already packed bytes from <tt>data</tt> in a frame of type
+		 * <tt>type</tt>.
+		 *
+		 * @param type      the frame type id, zero for none
+		 * @param data      the frame payload
+		 * @param length    the frame payload length
+		 */
+		void pack(uint64_t type, const char* data, size_t length) {
+			packHeader(type, length);
+			packer.pack(data, length);
+		}
+
+	private:
+		/**
+		 * Packs the header of a frame of type <tt>type</tt> with a payload of <tt>length</tt> bytes.
+		 */
+		void packHeader(uint64_t type, uint64_t length) {
+			packer.packVarint(length << 1 | (type != 0 ? 1 : 0));
+			if(type != 0) {
+				packer.packVarint(type);
+			}
+		}
+	};
+
+	/**
+	 * The FrameReassembler template class splits a stream received in arbitrary fragments, such as
+	 * a TCP connection, into the frames written by a FramePacker.
+	 *
+	 * Each fragment is handed to feed() as is. next() then yields the frames it holds, one at a
+	 * time. A frame that lies entirely within the fragment is yielded as a view into the fragment
+	 * itself, without any copy. Only a frame that straddles two fragments is copied into a
+	 * reassembly buffer owned by the FrameReassembler, which is reused and stops allocating once it
+	 * has grown to the largest such frame.
+	 *
+	 * Once next() returns UnpackStatus::NeedMoreData, the remaining bytes of the fragment have been
+	 * buffered and its memory can be reused for the next read. A yielded frame is valid until the
+	 * next call to next() or feed().
+	 *
+	 * @code
+	 *  char fragment[65536];
+	 *  FrameReassembler<> reassembler(1 << 20);
+	 *  for(;;) {
+	 *      reassembler.feed(fragment, recv(socket, fragment, sizeof(fragment), 0));
+	 *
+	 *      Frame frame;
+	 *      while(reassembler.next(frame) == UnpackStatus::Complete) {
+	 *          SpanReader reader(frame.payload.data(), frame.payload.size());
+	 *          Unpacker<SpanReader, boost::endian::order::little, IntegerEncoding::Fixed, Bounds::Checked> unpacker(reader);
+	 *          dispatch(frame.type, unpacker);
+	 *      }
+	 *  }
+	 * @endcode
+	 *
+	 * @tparam Allocator the allocator used for the reassembly buffer
+	 */
+	template<typename Allocator = std::allocator<char>>
+	class FrameReassembler {
+	private:
+		/**
+		 * The fragment being split
+		 */
+		const char* input = nullptr;
+
+		/**
+		 * The number of bytes of the fragment
+		 */
+		size_t inputLength = 0;
+
+		/**
+		 * The number of bytes of the fragment already split
+		 */
+		size_t inputOffset = 0;
+
+		/**
+		 * The bytes received so far of a frame that straddles fragments
+		 */
+		GrowableBuffer<Allocator> pending;
+
+		/**
+		 * The total number of bytes of the pending frame, or zero while its header is incomplete
+		 */
+		size_t pendingLength = 0;
+
+		/**
+		 * Whether the pending frame was yielded and must be discarded on the next call
+		 */
+		bool yielded = false;
+
+		/**
+		 * The maximum payload length of a frame
+		 */
+		size_t maxFrameLength;
+
+		/**
+		 * The error that failed the stream
+		 */
+		UnpackError state = UnpackError::None;
+
+	public:
+		/**
+		 * Creates a new FrameReassembler.
+		 *
+		 * @param maxFrameLength    the maximum payload length of a frame. A longer frame fails the
+		 *                          stream with UnpackError::LimitExceeded instead of being buffered.
+		 * @param allocator         the allocator used for the reassembly buffer
+		 */
+		explicit FrameReassembler(size_t maxFrameLength = std::numeric_limits<size_t>::max() / 2,
+								  const Allocator& allocator = Allocator()) :
+				pending(0, allocator), maxFrameLength(maxFrameLength) {}
+
+		/**
+		 * Hands the next received fragment to the reassembler. The previous fragment must have been
+		 * fully split, that is, next() must have returned UnpackStatus::NeedMoreData.
+		 *
+		 * @param data      the received bytes
+		 * @param length    the number of bytes received
+		 */
+		void feed(const char* data, size_t length) noexcept {
+			input = data;
+			inputLength = length;
+			inputOffset = 0;
+		}
+
+		/**
+		 * Yields the next complete frame.
+		 *
+		 * @param frame the frame
+		 *
+		 * @return whether a frame was yielded, more data is needed or the stream failed
+		 */
+		UnpackStatus next(Frame& frame) {
+			if(state != UnpackError::None) {
+				return UnpackStatus::Failed;
+			}
+			if(yielded) {
+				pending.reset();
+				pendingLength = 0;
+				yielded = false;
+			}
+			if(pending.size() != 0) {
+				return reassemble(frame);
+			}
+
+			const char* data = input + inputOffset;
+			const size_t available = inputLength - inputOffset;
+			if(available == 0) {
+				return UnpackStatus::NeedMoreData;
+			}
+
+			uint64_t type;
+			uint64_t length;
+			size_t headerLength;
+			const UnpackError error = FrameHeader::decode(data, available, type, length, headerLength);
+			if(error == UnpackError::None && !accept(length)) {
+				return UnpackStatus::Failed;
+			}
+			if(error == UnpackError::None && length <= available - headerLength) {
+				frame.type = type;
+				frame.payload = ByteSpan(reinterpret_cast<const uint8_t*>(data + headerLength), length);
+				inputOffset += headerLength + length;
+				return UnpackStatus::Complete;
+			}
+			if(error != UnpackError::None && error != UnpackError::Truncated) {
+				state = error;
+				return UnpackStatus::Failed;
+			}
+
+			pendingLength = error == UnpackError::None ? headerLength + length : 0;
+			buffer(available);
+			return UnpackStatus::NeedMoreData;
+		}
+
+		/**
+		 * @return the number of bytes of a frame that straddles fragments received so far
+		 */
+		size_t buffered() const noexcept {
+			return yielded ? 0 : pending.size();
+		}
+
+		/**
+		 * @return the error that failed the stream
+		 */
+		UnpackError error() const noexcept {
+			return state;
+		}
+
+		/**
+		 * Discards the buffered bytes and the current fragment and clears the error, keeping the
+		 * reassembly buffer memory.
+		 */
+		void reset() noexcept {
+			feed(nullptr, 0);
+			pending.reset();
+			pendingLength = 0;
+			yielded = false;
+			state = UnpackError::None;
+		}
+
+	private:
+		/**
+		 * Completes the pending frame from the current fragment.
+		 */
+		UnpackStatus reassemble(Frame& frame) {
+			// the header itself straddles fragments: take its bytes one at a time
+			while(pendingLength == 0) {
+				if(inputOffset == inputLength) {
+					return UnpackStatus::NeedMoreData;
+				}
+				buffer(1);
+
+				uint64_t type;
+				uint64_t length;
+				size_t headerLength;
+				const UnpackError error = FrameHeader::decode(pending.data(), pending.size(), type, length,
+															  headerLength);
+				if(error == UnpackError::None) {
+					if(!accept(length)) {
+						return UnpackStatus::Failed;
+					}
+					pendingLength = headerLength + length;
+				} else if(error != UnpackError::Truncated) {
+					state = error;
+					return UnpackStatus::Failed;
+				}
+			}
+
+			const size_t missing = pendingLength - pending.size();
+			const size_t available = inputLength - inputOffset;
+			if(missing > available) {
+				buffer(available);
+				return UnpackStatus::NeedMoreData;
+			}
+			buffer(missing);
+
+			uint64_t length;
+			size_t headerLength;
+			FrameHeader::decode(pending.data(), pending.size(), frame.type, length, headerLength);
+			frame.payload = ByteSpan(reinterpret_cast<const uint8_t*>(pending.data() + headerLength), length);
+			yielded = true;
+			return UnpackStatus::Complete;
+		}
+
+		/**
+		 * Moves <tt>length</tt> bytes of the current fragment to the pending frame.
+		 */
+		void buffer(size_t length) {
+			if(length == 0) {
+				return;
+			}
+			std::memcpy(pending.prepare(length), input + inputOffset, length);
+			pending.commit(length);
+			inputOffset += length;
+		}
+
+		/**
+		 * @return whether a frame payload of <tt>length</tt> bytes is accepted, failing the stream
+		 * if not
+		 */
+		bool accept(uint64_t length) noexcept {
+			if(length > maxFrameLength) {
+				state = UnpackError::LimitExceeded;
+				return false;
+			}
+			return true;
+		}
+	};
+
+}
+
+#endif //PACKETBUFFER_FRAME_H
@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_INDEXED_H
+#define PACKETBUFFER_INDEXED_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <utility>
+
+#include <boost/endian/conversion.hpp>
+
+#include "Buffer/SpanReader.h"
+#include "Unpacker.h"
+#include "View.h"
+
+namespace PacketBuffer {
+
+	/**
+	 * A sequence of fields packed as an indexed section, created with indexed().
+	 *
+	 * An indexed section is prefixed with an offset table, so that an IndexedView can jump to any
+	 * of its items without decoding the ones before it:
+	 * @code
+	 * (
+	 * 	length:		count
+	 * 	uint32_t:	end[0]
+	 * 	...
+	 * 	uint32_t:	end[count-1]
+	 * 	T:			item[0]
+	 * 	...
+	 * 	T:			item[count-1]
+	 * )
+	 * @endcode
+	 *
+	 * The count is packed with Packer::packLength(), and every <tt>end</tt> is the offset, in the
+	 * Packer endianess, of the byte that follows the item, relative to the first item. A section
+	 * holds at most 4 GiB of items: packing a larger one throws std::length_error, or aborts when
+	 * exceptions are disabled.
+	 *
+	 * Unpacking an IndexedFields decodes every field in order. Fields missing from the input are
+	 * left untouched and extra items are skipped, so fields can be appended to a message.
+	 *
+	 * @tparam Ts the field types, which are references for lvalue fields
+	 */
+	template<typename... Ts>
+	class IndexedFields {
+	private:
+		/**
+		 * The fields
+		 */
+		std::tuple<Ts...> values;
+
+	public:
+		/**
+		 * Creates a new indexed section of <tt>fields</tt>.
+		 *
+		 * @param fields the fields
+		 */
+		template<typename... Us>
+		explicit IndexedFields(Us&& ... fields) : values(std::forward<Us>(fields)...) {}
+
+	public:
+		/**
+		 * @return the fields
+		 */
+		std::tuple<Ts...>& getValues() noexcept {
+			return values;
+		}
+
+		/**
+		 * @return the fields
+		 */
+		const std::tuple<Ts...>& getValues() const noexcept {
+			return values;
+		}
+	};
+
+	/**
+	 * Packs or unpacks <tt>fields</tt> as an indexed section. Lvalue fields are referenced,
+	 * rvalue fields such as the result of indexedArray() are stored by value.
+	 *
+	 * @code
+	 *  template<typename Packer>
+	 *  void pack(Packer& packer) const {
+	 *      packer(indexed(id, name, indexedArray(attributes)));
+	 *  }
+	 *
+	 *  template<typename Unpacker>
+	 *  void unpack(Unpacker& unpacker) {
+	 *      auto fields = indexed(id, name, indexedArray(attributes));
+	 *      unpacker(fields);
+	 *  }
+	 * @endcode
+	 *
+	 * @param fields the fields
+	 *
+	 * @return the indexed section
+	 */
+	template<typename... Ts>
+	inline IndexedFields<Ts...> indexed(Ts&& ... fields) {
+		return IndexedFields<Ts...>(std::forward<Ts>(fields)...);
+	}
+
+	/**
+	 * The elements of a container packed as an indexed section, created with indexedArray().
+	 * The section has the same format as IndexedFields, with one item per element.
+	 *
+	 * The offset table takes 4 bytes per element, so this is meant for elements of variable
+	 * length, such as strings or nested records.
+	 *
+	 * @tparam Container the container type, such as std::vector
+	 */
+	template<typename Container>
+	class IndexedArray {
+	private:
+		/**
+		 * The container
+		 */
+		Container* container;
+
+	public:
+		/**
+		 * Creates a new indexed section of the elements of <tt>container</tt>.
+		 *
+		 * @param container the container
+		 */
+		explicit IndexedArray(Container& container) noexcept : container(&container) {}
+
+	public:
+		/**
+		 * @return the container
+		 */
+		Container& getContainer() const noexcept {
+			return *container;
+		}
+	};
+
+	/**
+	 * Packs or unpacks the elements of <tt>container</tt> as an indexed section.
+	 *
+	 * @param container the container
+	 *
+	 * @return the indexed section
+	 */
+	template<typename Container>
+	inline IndexedArray<Container> indexedArray(Container& container) noexcept {
+		return IndexedArray<Container>(container);
+	}
+
+	/**
+	 * A lazy view of an indexed section, which decodes a single item on demand instead of the
+	 * whole section.
+	 *
+	 * An IndexedView is unpacked from the same bytes as IndexedFields and IndexedArray. Only the
+	 * count is decoded; the offset table and the items are borrowed from the input, so the
+	 * Unpacker must sit on a contiguous buffer, such as SpanReader, and the view is only valid as
+	 * long as the input memory is. Unpacking an IndexedView is also the fastest way to skip a
+	 * section.
+	 *
+	 * @code
+	 *  IndexedView<> record;
+	 *  unpacker(record);
+	 *
+	 *  IndexedView<> attributes;
+	 *  record.get(2, attributes);
+	 *
+	 *  Attribute attribute;
+	 *  if(attributes.get(1000, attribute) != UnpackError::None) {
+	 *      // ...
+	 *  }
+	 * @endcode
+	 *
+	 * @tparam Endianess    the endianess the section was packed with
+	 * @tparam Encoding     the integer encoding the section was packed with
+	 */
+	template<boost::endian::order Endianess = boost::endian::order::little,
+			IntegerEncoding Encoding = IntegerEncoding::Fixed>
+	class IndexedView {
+	private:
+		/**
+		 * The offset table
+		 */
+		const char* table = nullptr;
+
+		/**
+		 * The first item byte
+		 */
+		const char* first = nullptr;
+
+		/**
+		 * The number of items
+		 */
+		size_t count = 0;
+
+		/**
+		 * The number of item bytes
+		 */
+		size_t length = 0;
+
+	public:
+		/**
+		 * Creates an empty view.
+		 */
+		IndexedView() noexcept = default;
+
+		/**
+		 * Creates a view of a section.
+		 *
+		 * @param table     the offset table, with <tt>count</tt> entries
+		 * @param count     the number of items
+		 * @param first     the first item byte
+		 * @param length    the number of item bytes
+		 */
+		IndexedView(const char* table, size_t count, const char* first, size_t length) noexcept :
+				table(table), first(first), count(count), length(length) {}
+
+	public:
+		/**
+		 * @return the number of items
+		 */
+		size_t size() const noexcept {
+			return count;
+		}
+
+		/**
+		 * @return true if the section has no items
+		 */
+		bool empty() const noexcept {
+			return count == 0;
+		}
+
+		/**
+		 * Returns the packed bytes of the item at <tt>index</tt>. Out of range indices and
+		 * offsets pointing outside of the section give an empty span.
+		 *
+		 * @param index the item index
+		 *
+		 * @return the packed bytes of the item
+		 */
+		ByteSpan item(size_t index) const noexcept {
+			size_t from, to;
+			if(!locate(index, from, to)) {
+				return ByteSpan();
+			}
+			return ByteSpan(first + from, to - from);
+		}
+
+		/**
+		 * Unpacks the item at <tt>index</tt> into <tt>value</tt>. Nested sections can be read
+		 * into another IndexedView.
+		 *
+		 * @tparam T        the item type
+		 * @param index     the item index
+		 * @param value     the value to unpack to
+		 *
+		 * @return the error that occurred while unpacking. An out of range index or offset
+		 * fails with UnpackError::Truncated.
+		 */
+		template<typename T>
+		UnpackError get(size_t index, T& value) const {
+			size_t from, to;
+			if(!locate(index, from, to)) {
+				return UnpackError::Truncated;
+			}
+			SpanReader reader(first + from, to - from);
+			Unpacker<SpanReader, Endianess, Encoding, Bounds::Checked> unpacker(reader);
+			unpacker.unpack(value);
+			return unpacker.error();
+		}
+
+	private:
+		/**
+		 * Finds the bytes of the item at <tt>index</tt>.
+		 *
+		 * @param index the item index
+		 * @param from  the offset of the first item byte
+		 * @param to    the offset that follows the item
+		 *
+		 * @return false if the index is out of range or its offsets point outside of the section
+		 */
+		bool locate(size_t index, size_t& from, size_t& to) const noexcept {
+			if(index >= count) {
+				return false;
+			}
+			from = index == 0 ? 0 : end(index - 1);
+			to = end(index);
+			return from <= to && to <= length;
+		}
+
+		/**
+		 * @return the offset that follows the item at <tt>index</tt>
+		 */
+		size_t end(size_t index) const noexcept {
+			uint32_t offset;
+			std::memcpy(&offset, table + index * sizeof(offset), sizeof(offset));
+			return boost::endian::conditional_reverse<Endianess, boost::endian::order::native>(offset);
+		}
+	};
+
+}
+
+#endif //PACKETBUFFER_INDEXED_H
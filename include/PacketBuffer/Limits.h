@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_LIMITS_H
+#define PACKETBUFFER_LIMITS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace PacketBuffer {
+
+	/**
+	 * Bounds the memory a Unpacker may reserve for containers whose length
+	 * is read from the input.
+	 *
+	 * Container serializers consult these limits through
+	 * Unpacker::checkLength() once per container, before reserving any
+	 * memory, so that a hostile length cannot trigger a huge allocation.
+	 */
+	struct Limits {
+		/**
+		 * The maximum number of elements in a single container
+		 */
+		uint64_t maxElements = std::numeric_limits<uint64_t>::max();
+
+		/**
+		 * The total number of bytes of element storage that may be reserved
+		 * by all containers unpacked by a Unpacker
+		 */
+		size_t allocationBudget = std::numeric_limits<size_t>::max();
+	};
+
+	/**
+	 * The minimum number of bytes that an object of type <tt>T</tt> takes
+	 * once packed.
+	 *
+	 * When the input length is known, a container length is rejected if
+	 * its elements could not possibly fit in the remaining input. Users can
+	 * specialize this template to tighten the bound for their own types.
+	 *
+	 * @tparam T the packed type
+	 */
+	template<typename T, typename = void>
+	struct MinimumPackedSize : std::integral_constant<size_t, std::is_empty<T>::value ? 0 : 1> {
+	};
+
+	/**
+	 * The minimum number of bytes that an arithmetic or enum value takes
+	 * once packed.
+	 *
+	 * @tparam T the packed type
+	 */
+	template<typename T>
+	struct MinimumPackedSize<T, typename std::enable_if<
+			std::is_arithmetic<T>::value || std::is_enum<T>::value>::type>
+			: std::integral_constant<size_t, sizeof(T)> {
+	};
+
+}
+
+#endif //PACKETBUFFER_LIMITS_H
@@ -30,6 +30,8 @@
 #ifndef PACKETBUFFER_OBJECTSERIALIZER_H
 #define PACKETBUFFER_OBJECTSERIALIZER_H
 
+#include <type_traits>
+
 namespace PacketBuffer {
 
 	template<typename Packer, typename T>
@@ -60,6 +62,42 @@ namespace PacketBuffer {
 		static const bool value = sizeof(test<T>(0)) == sizeof(char);
 	};
 
+	/**
+	 * Tells whether the packed representation of a value of type <tt>T</tt> is identical to its
+	 * in-memory representation when packed with native endianess.
+	 *
+	 * Contiguous ranges of such values are packed and unpacked with a single bulk copy by
+	 * Packer::packArray() and Unpacker::unpackArray() instead of element by element.
+	 *
+	 * This holds for arithmetic and enum types. A user can opt a trivially copyable struct in by
+	 * specializing this template, as long as the struct has no padding and its pack() method packs
+	 * every member in declaration order:
+	 *
+	 * @code
+	 *  struct Sample {
+	 *      uint32_t timestamp;
+	 *      float    value;
+	 *
+	 *      template<typename Packer>
+	 *      void pack(Packer& packer) const { packer(timestamp, value); }
+	 *
+	 *      template<typename Unpacker>
+	 *      void unpack(Unpacker& unpacker) { unpacker(timestamp, value); }
+	 *  };
+	 *
+	 *  namespace PacketBuffer {
+	 *      template<>
+	 *      struct IsBitwisePackable<Sample> : std::true_type {};
+	 *  }
+	 * @endcode
+	 *
+	 * @tparam T the type to be packed
+	 */
+	template<typename T, typename = void>
+	struct IsBitwisePackable : std::integral_constant<bool,
+			(std::is_arithmetic<T>::value && !std::is_same<T, long double>::value) || std::is_enum<T>::value> {
+	};
+
 	/**
 	 * The ObjectSerializer class template is responsible for implementing the serialization logic
 	 * for non-primitive types.
@@ -0,0 +1,462 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_OVERLAY_H
+#define PACKETBUFFER_OVERLAY_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include <boost/endian/conversion.hpp>
+
+#include "PackedSize.h"
+#include "Serializer/Std/Array.h"
+
+namespace PacketBuffer {
+
+	/**
+	 * The ordered list of the field types of a fixed layout type.
+	 *
+	 * @tparam Ts the field types, in packing order
+	 */
+	template<typename... Ts>
+	struct FieldList {
+	};
+
+	/**
+	 * Recovers the field types of <tt>T</tt> from its MaxPackedSize specialization, as long as
+	 * it derives from MaxPackedSizeOf, as in:
+	 *
+	 * @code
+	 *  template<IntegerEncoding Encoding>
+	 *  struct MaxPackedSize<Point, Encoding> : MaxPackedSizeOf<Encoding, uint32_t, uint32_t> {};
+	 * @endcode
+	 *
+	 * @return the field types of <tt>T</tt>
+	 */
+	template<IntegerEncoding Encoding, typename... Ts>
+	FieldList<Ts...> fieldsOf(const MaxPackedSizeOf<Encoding, Ts...>&);
+
+	/**
+	 * Selected for types whose MaxPackedSize does not list their fields.
+	 */
+	void fieldsOf(...);
+
+	/**
+	 * The field types of <tt>T</tt> as a FieldList, or <tt>void</tt> if <tt>T</tt> does not
+	 * declare them.
+	 */
+	template<typename T>
+	using FieldsOf = decltype(fieldsOf(std::declval<MaxPackedSize<T, IntegerEncoding::Fixed>>()));
+
+	template<typename T, typename = void>
+	struct IsFixedLayout;
+
+	/**
+	 * Tells whether all of <tt>Ts</tt> have a fixed layout.
+	 */
+	template<typename... Ts>
+	struct AreFixedLayout : std::true_type {
+	};
+
+	template<typename T, typename... Ts>
+	struct AreFixedLayout<T, Ts...> : std::integral_constant<bool,
+			IsFixedLayout<T>::value && AreFixedLayout<Ts...>::value> {
+	};
+
+	template<typename Fields>
+	struct IsFixedFieldList : std::false_type {
+	};
+
+	template<typename... Ts>
+	struct IsFixedFieldList<FieldList<Ts...>> : AreFixedLayout<Ts...> {
+	};
+
+	/**
+	 * Tells whether values of type <tt>T</tt>, once packed with fixed size integers, always
+	 * place every field at the same offset, so that an Overlay can read them in place.
+	 *
+	 * This holds for arithmetic types, enums, std::array and C arrays of fixed layout types, and
+	 * for types whose MaxPackedSize specialization derives from MaxPackedSizeOf with fixed layout
+	 * field types, such as std::pair, std::tuple and user types declared as in fieldsOf(). The
+	 * field types must be listed in the order in which pack() packs them.
+	 *
+	 * @tparam T the type to be inspected
+	 */
+	template<typename T, typename>
+	struct IsFixedLayout : IsFixedFieldList<FieldsOf<T>> {
+	};
+
+	template<typename T>
+	struct IsFixedLayout<T, typename std::enable_if<
+			(std::is_arithmetic<T>::value && !std::is_same<T, long double>::value) || std::is_enum<T>::value>::type> :
+			std::true_type {
+	};
+
+	template<typename T, size_t S>
+	struct IsFixedLayout<std::array<T, S>> : IsFixedLayout<T> {
+	};
+
+	template<typename T, size_t S>
+	struct IsFixedLayout<T[S]> : IsFixedLayout<T> {
+	};
+
+	/**
+	 * The type and the offset of the field at <tt>I</tt> in <tt>Fields</tt>.
+	 *
+	 * @tparam Fields   a FieldList
+	 * @tparam I        the field index
+	 */
+	template<typename Fields, size_t I>
+	struct FieldAt;
+
+	template<typename T, typename... Ts>
+	struct FieldAt<FieldList<T, Ts...>, 0> {
+		using type = T;
+		static constexpr size_t offset = 0;
+	};
+
+	template<typename T, typename... Ts, size_t I>
+	struct FieldAt<FieldList<T, Ts...>, I> {
+		using type = typename FieldAt<FieldList<Ts...>, I - 1>::type;
+		static constexpr size_t offset = fixedPackedSize<T>() + FieldAt<FieldList<Ts...>, I - 1>::offset;
+	};
+
+	/**
+	 * The element type of the array type <tt>T</tt>.
+	 */
+	template<typename T>
+	struct ElementOf {
+	};
+
+	template<typename T, size_t S>
+	struct ElementOf<std::array<T, S>> {
+		using type = T;
+	};
+
+	template<typename T, size_t S>
+	struct ElementOf<T[S]> {
+		using type = T;
+	};
+
+	template<typename Fields>
+	struct FieldBoundaries;
+
+	/**
+	 * Appends the offset past every arithmetic and enum value of a fixed layout type, in packing
+	 * order, as laid out by its field list.
+	 *
+	 * @tparam T the fixed layout type
+	 */
+	template<typename T, typename = void>
+	struct LayoutBoundaries {
+		static void append(std::vector<size_t>& boundaries, size_t base) {
+			FieldBoundaries<FieldsOf<T>>::append(boundaries, base);
+		}
+	};
+
+	template<typename T>
+	struct LayoutBoundaries<T, typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value>::type> {
+		static void append(std::vector<size_t>& boundaries, size_t base) {
+			boundaries.push_back(base + fixedPackedSize<T>());
+		}
+	};
+
+	template<typename T, size_t S>
+	struct LayoutBoundaries<std::array<T, S>> {
+		static void append(std::vector<size_t>& boundaries, size_t base) {
+			for(size_t i = 0; i < S; i++) {
+				LayoutBoundaries<T>::append(boundaries, base + i * fixedPackedSize<T>());
+			}
+		}
+	};
+
+	template<typename T, size_t S>
+	struct LayoutBoundaries<T[S]> : LayoutBoundaries<std::array<T, S>> {
+	};
+
+	template<>
+	struct FieldBoundaries<FieldList<>> {
+		static void append(std::vector<size_t>&, size_t) {
+		}
+	};
+
+	template<typename T, typename... Ts>
+	struct FieldBoundaries<FieldList<T, Ts...>> {
+		static void append(std::vector<size_t>& boundaries, size_t base) {
+			LayoutBoundaries<T>::append(boundaries, base);
+			FieldBoundaries<FieldList<Ts...>>::append(boundaries, base + fixedPackedSize<T>());
+		}
+	};
+
+	/**
+	 * A Packer buffer that discards the data, only recording the offset past every write.
+	 */
+	class LayoutRecorder {
+	private:
+		/**
+		 * The offset past every write, in order
+		 */
+		std::vector<size_t> ends;
+
+		/**
+		 * The number of bytes written so far
+		 */
+		size_t written = 0;
+
+	public:
+		/**
+		 * Records a write of <tt>length</tt> bytes.
+		 *
+		 * @param length    the number of bytes to be written
+		 */
+		void write(const char*, size_t length) {
+			if(length != 0) {
+				written += length;
+				ends.push_back(written);
+			}
+		}
+
+		/**
+		 * Records a write of <tt>length</tt> bytes.
+		 *
+		 * @param length    the number of bytes to be written
+		 */
+		void write(const unsigned char*, size_t length) {
+			write(static_cast<const char*>(nullptr), length);
+		}
+
+		/**
+		 * @return the offset past every write, in order
+		 */
+		const std::vector<size_t>& boundaries() const noexcept {
+			return ends;
+		}
+
+		/**
+		 * @return the number of bytes written so far
+		 */
+		size_t size() const noexcept {
+			return written;
+		}
+	};
+
+	template<typename T, boost::endian::order Endianess, typename = void>
+	struct OverlayField;
+
+	/**
+	 * A read-only view of a value of type <tt>T</tt> packed with fixed size integers and
+	 * <tt>Endianess</tt>, which reads fields directly from the packed bytes instead of unpacking
+	 * the whole value with an Unpacker.
+	 *
+	 * Fields are read with get<I>(), where <tt>I</tt> is the index of the field in the order it
+	 * is packed. Arithmetic and enum fields are returned by value, converted to the native
+	 * endianess; struct and array fields are returned as nested overlays. Array elements are
+	 * read with operator[].
+	 *
+	 * @code
+	 *  Overlay<OrderHeader, boost::endian::order::big> header(frame.data());
+	 *  uint64_t sequence = header.get<0>();
+	 *  Side side = header.get<3>();
+	 * @endcode
+	 *
+	 * Only types for which IsFixedLayout holds can be overlaid. The overlay does not own the
+	 * bytes and does not check their length: the caller must make sure that at least size()
+	 * bytes are readable.
+	 *
+	 * @tparam T            the overlaid type
+	 * @tparam Endianess    the endianess of the packed integers
+	 */
+	template<typename T, boost::endian::order Endianess = boost::endian::order::little>
+	class Overlay {
+		static_assert(IsFixedLayout<T>::value,
+					  "The type T does not have a fixed layout. Only arithmetic types, enums, arrays and "
+							  "types whose MaxPackedSize derives from MaxPackedSizeOf can be overlaid.");
+
+	private:
+		/**
+		 * The first packed byte
+		 */
+		const char* first;
+
+	public:
+		/**
+		 * Creates a new overlay over the value packed at <tt>data</tt>.
+		 *
+		 * @param data the first packed byte
+		 */
+		explicit Overlay(const char* data) noexcept : first(data) {}
+
+		/**
+		 * Creates a new overlay over the value packed at <tt>data</tt>.
+		 *
+		 * @param data the first packed byte
+		 */
+		explicit Overlay(const uint8_t* data) noexcept : first(reinterpret_cast<const char*>(data)) {}
+
+	public:
+		/**
+		 * Reads the field at <tt>I</tt>.
+		 *
+		 * @tparam I the index of the field in packing order
+		 *
+		 * @return the field value, or an overlay if the field is a struct or an array
+		 */
+		template<size_t I>
+		typename OverlayField<typename FieldAt<FieldsOf<T>, I>::type, Endianess>::type get() const noexcept {
+			using Field = FieldAt<FieldsOf<T>, I>;
+			return OverlayField<typename Field::type, Endianess>::read(first + Field::offset);
+		}
+
+		/**
+		 * Reads the array element at <tt>index</tt>. Only available if <tt>T</tt> is an array.
+		 *
+		 * @param index the element index
+		 *
+		 * @return the element value, or an overlay if the element is a struct or an array
+		 */
+		template<typename U = T>
+		typename OverlayField<typename ElementOf<U>::type, Endianess>::type operator[](size_t index) const noexcept {
+			using Element = typename ElementOf<U>::type;
+			return OverlayField<Element, Endianess>::read(first + index * fixedPackedSize<Element>());
+		}
+
+		/**
+		 * @return the first packed byte
+		 */
+		const char* data() const noexcept {
+			return first;
+		}
+
+		/**
+		 * @return the number of bytes the packed value takes
+		 */
+		static constexpr size_t size() noexcept {
+			return fixedPackedSize<T>();
+		}
+
+		/**
+		 * Checks that the field list of <tt>T</tt> matches what its pack() method actually packs,
+		 * by packing <tt>sample</tt> and comparing the packed size and the offset of every write
+		 * with those of the field list. A field list that misses a field, or lists fields of
+		 * different sizes out of order, is reported. Meant for tests and assertions, as it
+		 * allocates.
+		 *
+		 * @param sample any value of type <tt>T</tt>
+		 *
+		 * @return true if the packed layout of <tt>sample</tt> matches the field list
+		 */
+		static bool checkLayout(const T& sample) {
+			LayoutRecorder recorder;
+			Packer<LayoutRecorder, Endianess> packer(recorder);
+			packer.pack(sample);
+
+			std::vector<size_t> expected;
+			LayoutBoundaries<T>::append(expected, 0);
+			return recorder.size() == size() && std::includes(expected.begin(), expected.end(),
+															  recorder.boundaries().begin(), recorder.boundaries().end());
+		}
+	};
+
+	/**
+	 * Reads single byte integer and boolean fields.
+	 */
+	template<typename T, boost::endian::order Endianess>
+	struct OverlayField<T, Endianess, typename std::enable_if<std::is_integral<T>::value && sizeof(T) == 1>::type> {
+		using type = T;
+
+		static T read(const char* data) noexcept {
+			T value;
+			std::memcpy(&value, data, sizeof(value));
+			return value;
+		}
+	};
+
+	/**
+	 * Reads integer fields.
+	 */
+	template<typename T, boost::endian::order Endianess>
+	struct OverlayField<T, Endianess, typename std::enable_if<std::is_integral<T>::value && sizeof(T) != 1>::type> {
+		using type = T;
+
+		static T read(const char* data) noexcept {
+			T value;
+			std::memcpy(&value, data, sizeof(value));
+			return boost::endian::conditional_reverse<Endianess, boost::endian::order::native>(value);
+		}
+	};
+
+	/**
+	 * Reads floating point fields, which are packed as integers of the same size.
+	 */
+	template<typename T, boost::endian::order Endianess>
+	struct OverlayField<T, Endianess, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+		using type = T;
+
+		static T read(const char* data) noexcept {
+			using Bits = typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type;
+			const Bits bits = OverlayField<Bits, Endianess>::read(data);
+			T value;
+			std::memcpy(&value, &bits, sizeof(value));
+			return value;
+		}
+	};
+
+	/**
+	 * Reads enum fields, which are packed as their underlying type.
+	 */
+	template<typename T, boost::endian::order Endianess>
+	struct OverlayField<T, Endianess, typename std::enable_if<std::is_enum<T>::value>::type> {
+		using type = T;
+
+		static T read(const char* data) noexcept {
+			return static_cast<T>(OverlayField<typename std::underlying_type<T>::type, Endianess>::read(data));
+		}
+	};
+
+	/**
+	 * Reads struct and array fields as nested overlays.
+	 */
+	template<typename T, boost::endian::order Endianess>
+	struct OverlayField<T, Endianess, typename std::enable_if<std::is_class<T>::value || std::is_array<T>::value>::type> {
+		using type = Overlay<T, Endianess>;
+
+		static type read(const char* data) noexcept {
+			return type(data);
+		}
+	};
+
+}
+
+#endif //PACKETBUFFER_OVERLAY_H
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_PACKEDMAPVIEW_H
+#define PACKETBUFFER_PACKEDMAPVIEW_H
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+#include "PackedVectorView.h"
+#include "Serializer/Std/Pair.h"
+
+namespace PacketBuffer {
+
+	/**
+	 * A read-only view of a packed std::map from <tt>K</tt> to <tt>V</tt>, which looks keys up
+	 * with a binary search on the packed entries instead of rebuilding the map.
+	 *
+	 * A std::map is packed in key order, so its entries form a sorted array. When both
+	 * <tt>K</tt> and <tt>V</tt> have a fixed packed size, entry <tt>i</tt> starts at a known
+	 * offset and a lookup only decodes the O(log n) keys it compares, plus the entry it finds.
+	 *
+	 * @code
+	 *  PackedMapView<uint32_t, Symbol> symbols;
+	 *  unpacker(symbols);
+	 *  auto it = symbols.find(id);
+	 *  if(it != symbols.end()) {
+	 *      Symbol symbol = (*it).second;
+	 *  }
+	 * @endcode
+	 *
+	 * The entries are borrowed from the input when unpacked, like a PackedVectorView, and keys are
+	 * read at the same stride as the entries. A map whose doubles were packed in single precision
+	 * fails with UnpackError::FloatEncodingMismatch. The order of the entries is not verified:
+	 * lookups in an unsorted input stay within its bounds but may not find existing keys.
+	 *
+	 * @tparam K            the key type
+	 * @tparam V            the value type
+	 * @tparam Endianess    the endianess the map was packed with
+	 * @tparam Encoding     the integer encoding the map was packed with
+	 * @tparam Compare      the comparison functor the map was sorted with
+	 */
+	template<typename K, typename V, boost::endian::order Endianess = boost::endian::order::little,
+			IntegerEncoding Encoding = IntegerEncoding::Fixed, typename Compare = std::less<K>>
+	class PackedMapView {
+	public:
+		using key_type = K;
+		using mapped_type = V;
+		using value_type = std::pair<K, V>;
+		using key_compare = Compare;
+		using const_iterator = typename PackedVectorView<value_type, Endianess, Encoding>::const_iterator;
+
+	private:
+		/**
+		 * The packed entries
+		 */
+		PackedVectorView<value_type, Endianess, Encoding> entries;
+
+		/**
+		 * The key comparison functor
+		 */
+		Compare compare;
+
+	public:
+		/**
+		 * Creates an empty view.
+		 */
+		PackedMapView() = default;
+
+		/**
+		 * Creates a view of <tt>count</tt> entries packed at <tt>data</tt>.
+		 *
+		 * @param data      the first packed entry byte
+		 * @param count     the number of entries
+		 * @param compare   the key comparison functor
+		 */
+		PackedMapView(const char* data, size_t count, const Compare& compare = Compare()) :
+				entries(data, count), compare(compare) {}
+
+	public:
+		/**
+		 * @return the number of entries
+		 */
+		size_t size() const noexcept {
+			return entries.size();
+		}
+
+		/**
+		 * @return true if the view has no entries
+		 */
+		bool empty() const noexcept {
+			return entries.empty();
+		}
+
+		/**
+		 * @return the key comparison functor
+		 */
+		Compare key_comp() const {
+			return compare;
+		}
+
+		const_iterator begin() const noexcept {
+			return entries.begin();
+		}
+
+		const_iterator end() const noexcept {
+			return entries.end();
+		}
+
+		/**
+		 * @param key the key to look for
+		 *
+		 * @return the first entry whose key is not less than <tt>key</tt>, or end()
+		 */
+		const_iterator lower_bound(const K& key) const {
+			return begin() + static_cast<std::ptrdiff_t>(lowerBound(key));
+		}
+
+		/**
+		 * @param key the key to look for
+		 *
+		 * @return the entry with <tt>key</tt>, or end() if there is none
+		 */
+		const_iterator find(const K& key) const {
+			const size_t index = lowerBound(key);
+			if(index == size() || compare(key, keyAt(index))) {
+				return end();
+			}
+			return begin() + static_cast<std::ptrdiff_t>(index);
+		}
+
+		/**
+		 * @param key the key to look for
+		 *
+		 * @return 1 if there is an entry with <tt>key</tt>, 0 otherwise
+		 */
+		size_t count(const K& key) const {
+			return find(key) != end() ? 1 : 0;
+		}
+
+	private:
+		/**
+		 * @return the key of the entry at <tt>index</tt>
+		 */
+		K keyAt(size_t index) const {
+			constexpr size_t stride = PackedVectorView<value_type, Endianess, Encoding>::Stride;
+			return PackedElement<K, Endianess, Encoding>::decode(entries.data() + index * stride);
+		}
+
+		/**
+		 * @return the index of the first entry whose key is not less than <tt>key</tt>
+		 */
+		size_t lowerBound(const K& key) const {
+			size_t first = 0;
+			size_t length = size();
+			while(length > 0) {
+				const size_t half = length / 2;
+				if(compare(keyAt(first + half), key)) {
+					first += half + 1;
+					length -= half + 1;
+				} else {
+					length = half;
+				}
+			}
+			return first;
+		}
+	};
+
+}
+
+#endif //PACKETBUFFER_PACKEDMAPVIEW_H
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_PACKEDSIZE_H
+#define PACKETBUFFER_PACKEDSIZE_H
+
+#include <cstddef>
+#include <type_traits>
+
+#include "Packer.h"
+#include "Varint.h"
+
+namespace PacketBuffer {
+
+	/**
+	 * The maximum number of bytes that a value of type <tt>T</tt> takes once
+	 * packed with <tt>Encoding</tt>, as <tt>value</tt>.
+	 *
+	 * Only types with no variable length members, such as arithmetic types,
+	 * enums, std::array, std::pair and std::tuple of such types, have a
+	 * maximum packed size. For other types, <tt>value</tt> is not defined.
+	 * With IntegerEncoding::Fixed and IntegerEncoding::VarintLength, these
+	 * types always take exactly that many bytes.
+	 *
+	 * A user can provide a maximum packed size for its own types by
+	 * specializing this template:
+	 *
+	 * @code
+	 *  struct Point {
+	 *      uint32_t x;
+	 *      uint32_t y;
+	 *
+	 *      template<typename Packer>
+	 *      void pack(Packer& packer) const { packer(x, y); }
+	 *  };
+	 *
+	 *  namespace PacketBuffer {
+	 *      template<IntegerEncoding Encoding>
+	 *      struct MaxPackedSize<Point, Encoding> : MaxPackedSizeOf<Encoding, uint32_t, uint32_t> {};
+	 *  }
+	 * @endcode
+	 *
+	 * @tparam T        the type to be packed
+	 * @tparam Encoding the integer encoding of the Packer
+	 */
+	template<typename T, IntegerEncoding Encoding = IntegerEncoding::Fixed, typename = void>
+	struct MaxPackedSize {
+	};
+
+	/**
+	 * The sum of the maximum packed sizes of <tt>Ts</tt>.
+	 *
+	 * @tparam Encoding the integer encoding of the Packer
+	 * @tparam Ts       the types to be packed
+	 */
+	template<IntegerEncoding Encoding, typename... Ts>
+	struct MaxPackedSizeOf : std::integral_constant<size_t, 0> {
+	};
+
+	template<IntegerEncoding Encoding, typename T, typename... Ts>
+	struct MaxPackedSizeOf<Encoding, T, Ts...> : std::integral_constant<size_t,
+			MaxPackedSize<typename std::remove_cv<T>::type, Encoding>::value +
+			MaxPackedSizeOf<Encoding, Ts...>::value> {
+	};
+
+	/**
+	 * Maps any sequence of types to <tt>void</tt>.
+	 */
+	template<typename... Ts>
+	struct MakeVoid {
+		using type = void;
+	};
+
+	/**
+	 * Enables a MaxPackedSize specialization if all of <tt>Ts</tt> have a
+	 * maximum packed size.
+	 */
+	template<IntegerEncoding Encoding, typename... Ts>
+	using EnableIfMaxPackedSize = typename MakeVoid<
+			decltype(MaxPackedSize<typename std::remove_cv<Ts>::type, Encoding>::value)...>::type;
+
+	/**
+	 * The maximum packed size of arithmetic types. Varint encoded integers
+	 * take up to one byte per 7 bits.
+	 */
+	template<typename T, IntegerEncoding Encoding>
+	struct MaxPackedSize<T, Encoding, typename std::enable_if<
+			std::is_arithmetic<T>::value && !std::is_same<T, long double>::value>::type> :
+			std::integral_constant<size_t,
+					(Encoding == IntegerEncoding::Varint && std::is_integral<T>::value && sizeof(T) != 1) ?
+					(sizeof(T) * 8 + 6) / 7 : sizeof(T)> {
+	};
+
+	/**
+	 * The maximum packed size of enums, which are packed as their underlying type.
+	 */
+	template<typename T, IntegerEncoding Encoding>
+	struct MaxPackedSize<T, Encoding, typename std::enable_if<std::is_enum<T>::value>::type> :
+			MaxPackedSize<typename std::underlying_type<T>::type, Encoding> {
+	};
+
+	/**
+	 * The maximum packed size of a contiguous range of <tt>S</tt> values of
+	 * type <tt>T</tt> packed with Packer::packArray(). StreamVByte takes up
+	 * to 4 data bytes per value, plus the control bytes.
+	 */
+	template<typename T, size_t S, IntegerEncoding Encoding>
+	struct MaxPackedArraySize : std::integral_constant<size_t,
+			ArrayLayoutOf<typename std::remove_cv<T>::type, boost::endian::order::native, Encoding>::value ==
+			ArrayLayout::StreamVByte ? sizeof(uint32_t) * S + StreamVByte::controlLength(S) :
+			MaxPackedSize<typename std::remove_cv<T>::type, Encoding>::value * S> {
+	};
+
+	/**
+	 * @return the number of bytes that a value of type <tt>T</tt> always
+	 * takes once packed with fixed size integers
+	 */
+	template<typename T>
+	constexpr size_t fixedPackedSize() noexcept {
+		return MaxPackedSize<T, IntegerEncoding::Fixed>::value;
+	}
+
+	/**
+	 * @return the maximum number of bytes that a value of type <tt>T</tt>
+	 * takes once packed with <tt>Encoding</tt>
+	 */
+	template<typename T, IntegerEncoding Encoding = IntegerEncoding::Fixed>
+	constexpr size_t maxPackedSize() noexcept {
+		return MaxPackedSize<T, Encoding>::value;
+	}
+
+	/**
+	 * A buffer that counts the bytes written to it and discards them.
+	 */
+	class PackedSizeCounter {
+	private:
+		/**
+		 * The number of bytes written so far
+		 */
+		size_t written = 0;
+
+	public:
+		/**
+		 * Counts <tt>length</tt> bytes. The data itself is discarded.
+		 *
+		 * @param length    the number of bytes to be written
+		 */
+		void write(const char*, size_t length) noexcept {
+			written += length;
+		}
+
+		/**
+		 * @return the number of bytes written so far
+		 */
+		size_t size() const noexcept {
+			return written;
+		}
+	};
+
+	/**
+	 * Computes the number of bytes that <tt>value</tt> takes once packed with
+	 * <tt>Encoding</tt>, so that the output can be reserved once before
+	 * packing.
+	 *
+	 * The value is packed into a PackedSizeCounter, which only adds up
+	 * lengths. For types with no variable length members, this folds into a
+	 * constant once inlined. fixedPackedSize() gives the same size as a
+	 * constant expression.
+	 *
+	 * @tparam Encoding the integer encoding of the Packer
+	 * @tparam T        the type to be packed
+	 * @param value     the value to be packed
+	 *
+	 * @return the packed size of <tt>value</tt>, in bytes
+	 */
+	template<IntegerEncoding Encoding = IntegerEncoding::Fixed, typename T>
+	inline size_t packedSize(const T& value) {
+		PackedSizeCounter counter;
+		Packer<PackedSizeCounter, boost::endian::order::native, Encoding> packer(counter);
+		packer.pack(value);
+		return counter.size();
+	}
+
+	/**
+	 * Computes the number of bytes that <tt>value</tt> takes once packed by a
+	 * BasicPacker using <tt>Policy</tt>, such as one that packs doubles in
+	 * single precision.
+	 *
+	 * Only the integer and float encodings of the policy change the packed
+	 * size. Its endianess and statistics hook are ignored.
+	 *
+	 * @tparam Policy   the PackingPolicy of the Packer
+	 * @tparam T        the type to be packed
+	 * @param value     the value to be packed
+	 *
+	 * @return the packed size of <tt>value</tt>, in bytes
+	 */
+	template<typename Policy, typename T>
+	inline size_t packedSize(const T& value) {
+		PackedSizeCounter counter;
+		BasicPacker<PackedSizeCounter, PackingPolicy<boost::endian::order::native, Policy::encoding,
+				Bounds::Unchecked, Policy::floats>> packer(counter);
+		packer.pack(value);
+		return counter.size();
+	}
+
+}
+
+#endif //PACKETBUFFER_PACKEDSIZE_H
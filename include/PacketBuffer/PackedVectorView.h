@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_PACKEDVECTORVIEW_H
+#define PACKETBUFFER_PACKEDVECTORVIEW_H
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+#include "Buffer/SpanReader.h"
+#include "Overlay.h"
+#include "PackedSize.h"
+#include "Unpacker.h"
+
+namespace PacketBuffer {
+
+	/**
+	 * Decodes a single packed value of type <tt>T</tt>, which must have a fixed packed size.
+	 * Arithmetic and enum values are loaded directly; other types are unpacked from their own
+	 * bytes.
+	 *
+	 * @tparam T            the value type
+	 * @tparam Endianess    the endianess the value was packed with
+	 * @tparam Encoding     the integer encoding the value was packed with
+	 */
+	template<typename T, boost::endian::order Endianess, IntegerEncoding Encoding>
+	struct PackedElement {
+		static_assert(Encoding != IntegerEncoding::Varint, "Varint encoded elements do not have a fixed size");
+
+		/**
+		 * The number of bytes of a packed value
+		 */
+		static constexpr size_t Size = MaxPackedSize<T, Encoding>::value;
+
+		/**
+		 * @param data the first packed byte
+		 *
+		 * @return the decoded value
+		 */
+		static T decode(const char* data) {
+			return decode(data, std::integral_constant<bool, std::is_arithmetic<T>::value || std::is_enum<T>::value>());
+		}
+
+	private:
+		static T decode(const char* data, std::true_type) noexcept {
+			return OverlayField<T, Endianess>::read(data);
+		}
+
+		static T decode(const char* data, std::false_type) {
+			SpanReader reader(data, Size);
+			Unpacker<SpanReader, Endianess, Encoding, Bounds::Unchecked> unpacker(reader);
+			T value;
+			unpacker.unpack(value);
+			return value;
+		}
+	};
+
+	/**
+	 * A read-only view of a packed std::vector of <tt>T</tt>, which decodes elements on demand
+	 * instead of unpacking the whole vector.
+	 *
+	 * <tt>T</tt> must have a fixed packed size, given by MaxPackedSize, so that element
+	 * <tt>i</tt> starts at <tt>i * MaxPackedSize</tt> bytes. Arithmetic and enum elements are
+	 * loaded directly with the right endianess; other types are unpacked from their own bytes.
+	 * Doubles packed in single precision shrink the elements, so a view of them fails with
+	 * UnpackError::FloatEncodingMismatch.
+	 *
+	 * The elements are borrowed from the input when unpacked, so the Unpacker must sit on a
+	 * contiguous buffer, such as SpanReader, and the view is only valid as long as the input
+	 * memory is. The view has random access iterators, so a sorted vector can be searched
+	 * without allocating:
+	 *
+	 * @code
+	 *  PackedVectorView<uint64_t, boost::endian::order::big> timestamps;
+	 *  unpacker(timestamps);
+	 *  auto it = std::lower_bound(timestamps.begin(), timestamps.end(), since);
+	 * @endcode
+	 *
+	 * @tparam T            the element type
+	 * @tparam Endianess    the endianess the vector was packed with
+	 * @tparam Encoding     the integer encoding the vector was packed with. IntegerEncoding::Varint
+	 *                      gives elements a variable size and is not supported.
+	 */
+	template<typename T, boost::endian::order Endianess = boost::endian::order::little,
+			IntegerEncoding Encoding = IntegerEncoding::Fixed>
+	class PackedVectorView {
+	public:
+		/**
+		 * The number of bytes of each packed element
+		 */
+		static constexpr size_t Stride = PackedElement<T, Endianess, Encoding>::Size;
+
+		using value_type = T;
+
+		class const_iterator;
+
+	private:
+		/**
+		 * The first packed element byte
+		 */
+		const char* first = nullptr;
+
+		/**
+		 * The number of elements
+		 */
+		size_t count = 0;
+
+	public:
+		/**
+		 * Creates an empty view.
+		 */
+		PackedVectorView() noexcept = default;
+
+		/**
+		 * Creates a view of <tt>count</tt> elements packed at <tt>data</tt>.
+		 *
+		 * @param data  the first packed element byte
+		 * @param count the number of elements
+		 */
+		PackedVectorView(const char* data, size_t count) noexcept : first(data), count(count) {}
+
+	public:
+		/**
+		 * @return the number of elements
+		 */
+		size_t size() const noexcept {
+			return count;
+		}
+
+		/**
+		 * @return true if the view has no elements
+		 */
+		bool empty() const noexcept {
+			return count == 0;
+		}
+
+		/**
+		 * @return the first packed element byte
+		 */
+		const char* data() const noexcept {
+			return first;
+		}
+
+		/**
+		 * Decodes the element at <tt>index</tt>, which must be lower than size().
+		 *
+		 * @param index the element index
+		 *
+		 * @return the element
+		 */
+		T operator[](size_t index) const {
+			return PackedElement<T, Endianess, Encoding>::decode(first + index * Stride);
+		}
+
+		const_iterator begin() const noexcept {
+			return const_iterator(first, 0);
+		}
+
+		const_iterator end() const noexcept {
+			return const_iterator(first, count);
+		}
+
+	public:
+		/**
+		 * A random access iterator that decodes the element it points to when dereferenced.
+		 * Elements are returned by value.
+		 */
+		class const_iterator {
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = void;
+			using reference = T;
+
+		private:
+			/**
+			 * The first packed element byte
+			 */
+			const char* first = nullptr;
+
+			/**
+			 * The element index
+			 */
+			size_t index = 0;
+
+		public:
+			const_iterator() noexcept = default;
+
+			const_iterator(const char* first, size_t index) noexcept : first(first), index(index) {}
+
+		public:
+			T operator*() const {
+				return PackedElement<T, Endianess, Encoding>::decode(first + index * Stride);
+			}
+
+			T operator[](difference_type n) const {
+				return PackedElement<T, Endianess, Encoding>::decode(first + (index + n) * Stride);
+			}
+
+			const_iterator& operator++() noexcept {
+				index++;
+				return *this;
+			}
+
+			const_iterator operator++(int) noexcept {
+				const_iterator copy = *this;
+				index++;
+				return copy;
+			}
+
+			const_iterator& operator--() noexcept {
+				index--;
+				return *this;
+			}
+
+			const_iterator operator--(int) noexcept {
+				const_iterator copy = *this;
+				index--;
+				return copy;
+			}
+
+			const_iterator& operator+=(difference_type n) noexcept {
+				index += n;
+				return *this;
+			}
+
+			const_iterator& operator-=(difference_type n) noexcept {
+				index -= n;
+				return *this;
+			}
+
+			friend const_iterator operator+(const_iterator it, difference_type n) noexcept {
+				return it += n;
+			}
+
+			friend const_iterator operator+(difference_type n, const_iterator it) noexcept {
+				return it += n;
+			}
+
+			friend const_iterator operator-(const_iterator it, difference_type n) noexcept {
+				return it -= n;
+			}
+
+			friend difference_type operator-(const const_iterator& lhs, const const_iterator& rhs) noexcept {
+				return static_cast<difference_type>(lhs.index) - static_cast<difference_type>(rhs.index);
+			}
+
+			friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) noexcept {
+				return lhs.index == rhs.index;
+			}
+
+			friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) noexcept {
+				return lhs.index != rhs.index;
+			}
+
+			friend bool operator<(const const_iterator& lhs, const const_iterator& rhs) noexcept {
+				return lhs.index < rhs.index;
+			}
+
+			friend bool operator>(const const_iterator& lhs, const const_iterator& rhs) noexcept {
+				return lhs.index > rhs.index;
+			}
+
+			friend bool operator<=(const const_iterator& lhs, const const_iterator& rhs) noexcept {
+				return lhs.index <= rhs.index;
+			}
+
+			friend bool operator>=(const const_iterator& lhs, const const_iterator& rhs) noexcept {
+				return lhs.index >= rhs.index;
+			}
+		};
+	};
+
+}
+
+#endif //PACKETBUFFER_PACKEDVECTORVIEW_H
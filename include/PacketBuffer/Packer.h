@@ -32,33 +32,73 @@
 
 #include <boost/endian/conversion.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "ByteSwap.h"
 #include "ObjectSerializer.h"
+#include "Policy.h"
+#include "StreamVByte.h"
+#include "Varint.h"
 
 namespace PacketBuffer {
 
+	template<typename Buffer>
+	struct HasPrepareMethod {
+		template<typename U, typename = decltype(std::declval<U&>().prepare(size_t()))>
+		static char test(int);
+
+		template<typename U>
+		static int test(...);
+
+		static const bool value = sizeof(test<Buffer>(0)) == sizeof(char);
+	};
+
 	/**
-	 * The Packer template class is responsible for converting C++ primitive types like integers and raw buffers
-	 * into a platform independent raw buffer.
+	 * The BasicPacker template class is responsible for converting C++ primitive types like integers and raw
+	 * buffers into a platform independent raw buffer.
 	 *
-	 * By default, all integers are encoded as little endian, this, however can be changed by setting "Endianess"
-	 * template parameter to something else.
+	 * How values are encoded is selected at compile time by a PackingPolicy: the endianess of integers, whether
+	 * container lengths and integers are encoded as LEB128 varints, how floating point values are encoded and
+	 * which statistics hook is notified of written bytes. Most code uses the Packer alias template instead,
+	 * which only exposes the endianess and the integer encoding.
 	 *
 	 * The <tt>Buffer</tt> class must implement a <tt>write</tt> with the following signature:
 	 * @code
 	 *  void write(const char* data, size_t length);
 	 * @endcode
 	 *
-	 * @tparam Buffer       the buffer type to write data to
-	 * @tparam Endianess    the endianess used to encode integer types
+	 * @tparam Buffer   the buffer type to write data to
+	 * @tparam Policy   the PackingPolicy
 	 */
-	template<typename Buffer, boost::endian::order Endianess = boost::endian::order::little>
-	class Packer {
+	template<typename Buffer, typename Policy = PackingPolicy<>>
+	class BasicPacker {
 	private:
+		static constexpr boost::endian::order Endianess = Policy::endianess;
+		static constexpr IntegerEncoding Encoding = Policy::encoding;
+		static constexpr FloatEncoding Floats = Policy::floats;
+		static constexpr bool RuntimeEndianess = Policy::runtimeEndianess;
+		using Stats = typename Policy::StatsHook;
+
+		/**
+		 * The endianess whose ranges are byte swapped in bulk: the foreign one when the endianess
+		 * is chosen at runtime
+		 */
+		static constexpr boost::endian::order ArrayEndianess = !RuntimeEndianess ? Endianess :
+				boost::endian::order::native == boost::endian::order::little ?
+				boost::endian::order::big : boost::endian::order::little;
+
 		/**
 		 * A reference to the buffer in which packed data is written to
 		 */
 		Buffer& buffer;
 
+		/**
+		 * Whether integers are byte swapped, when the endianess is chosen at runtime
+		 */
+		bool swapping = boost::endian::order::native != boost::endian::order::little;
+
 	public:
 		/**
 		 * Creates a new Packer instance with the given buffer reference. Packed data will be written
@@ -66,32 +106,88 @@ namespace PacketBuffer {
 		 *
 		 * @param buffer the buffer object to write data to
 		 */
-		explicit Packer(Buffer& buffer) : buffer(buffer) {};
+		BasicPacker(Buffer& buffer) : buffer(buffer) {};
 
 		/**
 		 * Deleted copy constructor.
 		 */
-		Packer(const Packer& other) = delete;
+		BasicPacker(const BasicPacker& other) = delete;
 
 		/**
 		 * Deleted copy assignment operator.
 		 */
-		Packer& operator=(const Packer& other) = delete;
+		BasicPacker& operator=(const BasicPacker& other) = delete;
 
 		/**
 		 * Deleted move constructor.
 		 */
-		Packer(Packer&& other) = delete;
+		BasicPacker(BasicPacker&& other) = delete;
 
 		/**
 		 * Deleted move assignment operator.
 		 */
-		Packer& operator=(Packer&& other) = delete;
+		BasicPacker& operator=(BasicPacker&& other) = delete;
 
 		/**
 		 * Default destructor.
 		 */
-		~Packer() = default;
+		~BasicPacker() = default;
+
+	public: // Endianess
+		/**
+		 * @return the endianess used to encode integer types
+		 */
+		boost::endian::order getEndianess() const noexcept {
+			if(!RuntimeEndianess) {
+				return Endianess;
+			}
+			return swapping == (boost::endian::order::native == boost::endian::order::little) ?
+				   boost::endian::order::big : boost::endian::order::little;
+		}
+
+		/**
+		 * Sets the endianess used to encode integer types. Only available when the policy chooses
+		 * the endianess at runtime, such as RuntimeEndianPolicy.
+		 *
+		 * @param endianess the endianess used to encode integer types
+		 */
+		void setEndianess(boost::endian::order endianess) noexcept {
+			static_assert(RuntimeEndianess, "The endianess of this policy is fixed at compile time");
+			swapping = endianess != boost::endian::order::native;
+		}
+
+		/**
+		 * Calls <tt>function</tt> with a packer that writes to the same buffer with the current
+		 * endianess fixed at compile time. With RuntimeEndianPolicy, the byte order is tested once
+		 * here instead of on every packed integer, which lets a hot loop over many values compile
+		 * down to a plain copy or a swapping copy. The function is instantiated once per byte
+		 * order, so it must accept any packer:
+		 *
+		 * @code
+		 *  packer.withEndianess([&](auto& packer) {
+		 *      for(const Sample& sample : samples) {
+		 *          packer(sample.time, sample.value);
+		 *      }
+		 *  });
+		 * @endcode
+		 *
+		 * With any other policy, the function is called with this packer.
+		 *
+		 * @tparam Function the function type
+		 * @param function  the function to call with the packer
+		 */
+		template<typename Function>
+		void withEndianess(Function&& function) {
+			withEndianess(std::forward<Function>(function), std::integral_constant<bool, RuntimeEndianess>());
+		}
+
+	public: // Buffer
+		/**
+		 * @return the buffer packed data is written to
+		 */
+		Buffer& getBuffer() const noexcept {
+			return buffer;
+		}
 
 	public: // Helper methods
 		/**
@@ -103,7 +199,7 @@ namespace PacketBuffer {
 		 * @return this
 		 */
 		template<typename T>
-		inline Packer& operator&(const T& v) {
+		inline BasicPacker& operator&(const T& v) {
 			return pack(v);
 		}
 
@@ -117,7 +213,7 @@ namespace PacketBuffer {
 		 * @return this
 		 */
 		template<typename T>
-		inline Packer& operator<<(const T& v) {
+		inline BasicPacker& operator<<(const T& v) {
 			return pack(v);
 		}
 
@@ -130,7 +226,7 @@ namespace PacketBuffer {
 		 * @return this
 		 */
 		template<typename... Ts>
-		inline Packer& operator()(const Ts& ... vs) {
+		inline BasicPacker& operator()(const Ts& ... vs) {
 			return pack(vs...);
 		}
 
@@ -148,7 +244,7 @@ namespace PacketBuffer {
 		 * @return this
 		 */
 		template<typename T, typename... Ts>
-		inline Packer& pack(const T& v, const Ts& ... vs) {
+		inline BasicPacker& pack(const T& v, const Ts& ... vs) {
 			pack(v);
 			pack(vs...);
 			return *this;
@@ -163,7 +259,7 @@ namespace PacketBuffer {
 		 * @return this
 		 */
 		template<typename T>
-		inline Packer& pack(const T& object) {
+		inline BasicPacker& pack(const T& object) {
 			ObjectSerializer<T>::pack(*this, object);
 			return *this;
 		}
@@ -173,10 +269,136 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		inline Packer& pack() {
+		inline BasicPacker& pack() {
 			return *this;
 		}
 
+		/**
+		 * Packs a contiguous range of <tt>count</tt> objects of type <tt>T</tt>.
+		 *
+		 * If <tt>T</tt> is bitwise packable and its packed representation does not depend on
+		 * endianess (or the Packer endianess is native), the whole range is written with a single
+		 * write. Arithmetic types of 2, 4 and 8 bytes in foreign endianess are byte swapped in bulk,
+		 * straight into buffers that implement <tt>prepare()</tt> and <tt>commit()</tt> (such as
+		 * SpanWriter and GrowableBuffer) and through a stack buffer otherwise. With IntegerEncoding::Varint, <tt>uint32_t</tt> ranges are packed in
+		 * StreamVByte blocks. Otherwise, each object is packed individually.
+		 *
+		 * @tparam T        the type of the objects to be packed
+		 * @param values    the first object to be packed
+		 * @param count     the number of objects to be packed
+		 *
+		 * @return this
+		 */
+		template<typename T>
+		inline BasicPacker& packArray(const T* values, size_t count) {
+			// an empty range may start at a null pointer (e.g. an empty std::vector), which
+			// must never reach the buffer's memcpy.
+			if(count == 0) {
+				return *this;
+			}
+			return packArray(values, count, ArrayLayoutOf<T, ArrayEndianess, Encoding, Floats>());
+		}
+
+	private:
+		template<typename T>
+		inline BasicPacker& packArray(const T* values, size_t count,
+								 std::integral_constant<ArrayLayout, ArrayLayout::Bitwise>) {
+			static_assert(std::is_trivially_copyable<T>::value, "bitwise packable types must be trivially copyable");
+			return pack(reinterpret_cast<const char*>(values), count * sizeof(T));
+		}
+
+		template<typename T>
+		inline BasicPacker& packArray(const T* values, size_t count,
+								 std::integral_constant<ArrayLayout, ArrayLayout::ByteSwapped>) {
+			if(RuntimeEndianess && !swapping) {
+				return packArray(values, count, std::integral_constant<ArrayLayout, ArrayLayout::Bitwise>());
+			}
+			return packSwapped<sizeof(T)>(reinterpret_cast<const char*>(values), count,
+										  std::integral_constant<bool, HasPrepareMethod<Buffer>::value>());
+		}
+
+		/**
+		 * Byte swaps <tt>count</tt> elements of <tt>Width</tt> bytes straight into a buffer that
+		 * can be filled directly, so that each byte is only touched once.
+		 */
+		template<size_t Width>
+		inline BasicPacker& packSwapped(const char* source, size_t count, std::true_type) {
+			const size_t size = count * Width;
+			ByteSwap::reverse<Width>(buffer.prepare(size), source, count);
+			buffer.commit(size);
+			Stats::packed(size);
+			return *this;
+		}
+
+		/**
+		 * Byte swaps <tt>count</tt> elements of <tt>Width</tt> bytes through a stack buffer,
+		 * writing it whenever it fills up.
+		 */
+		template<size_t Width>
+		inline BasicPacker& packSwapped(const char* source, size_t count, std::false_type) {
+			char chunk[4096];
+			while(count != 0) {
+				size_t items = std::min(count, sizeof(chunk) / Width);
+				ByteSwap::reverse<Width>(chunk, source, items);
+				pack(static_cast<const char*>(chunk), items * Width);
+				source += items * Width;
+				count -= items;
+			}
+			return *this;
+		}
+
+		template<typename T>
+		inline BasicPacker& packArray(const T* values, size_t count,
+								 std::integral_constant<ArrayLayout, ArrayLayout::StreamVByte>) {
+			char control[StreamVByte::controlLength(StreamVByte::BlockLength)];
+			char data[StreamVByte::BlockLength * sizeof(uint32_t)];
+			while(count != 0) {
+				size_t items = std::min(count, StreamVByte::BlockLength);
+				size_t length = StreamVByte::encode(values, items, control, data);
+				pack(static_cast<const char*>(control), StreamVByte::controlLength(items));
+				pack(static_cast<const char*>(data), length);
+				values += items;
+				count -= items;
+			}
+			return *this;
+		}
+
+		template<typename T>
+		inline BasicPacker& packArray(const T* values, size_t count,
+								 std::integral_constant<ArrayLayout, ArrayLayout::ElementWise>) {
+			for(size_t i = 0; i < count; i++) {
+				pack(values[i]);
+			}
+			return *this;
+		}
+
+		template<typename Function>
+		void withEndianess(Function&& function, std::false_type) {
+			function(*this);
+		}
+
+		template<typename Function>
+		void withEndianess(Function&& function, std::true_type) {
+			if(swapping) {
+				BasicPacker<Buffer, FixedEndianPolicy<Policy, ArrayEndianess>> packer(buffer);
+				function(packer);
+			} else {
+				BasicPacker<Buffer, FixedEndianPolicy<Policy, boost::endian::order::native>> packer(buffer);
+				function(packer);
+			}
+		}
+
+		/**
+		 * Converts <tt>i</tt> from the native endianess to the packed one.
+		 */
+		template<typename T>
+		inline void toWire(T& i) const noexcept {
+			boost::endian::conditional_reverse_inplace<boost::endian::order::native, Endianess>(i);
+			if(RuntimeEndianess && swapping) {
+				boost::endian::endian_reverse_inplace(i);
+			}
+		}
+
 	public: // Integer types
 		/**
 		 * Packs a uint8_t integer value.
@@ -185,9 +407,9 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		inline Packer& pack(uint8_t i) {
+		inline BasicPacker& pack(uint8_t i) {
 			static_assert(sizeof(i) == 1, "uint8_t size must be 1 byte");
-			boost::endian::conditional_reverse_inplace<boost::endian::order::native, Endianess>(i);
+			toWire(i);
 			return pack(reinterpret_cast<const char*>(&i), sizeof(i));
 		}
 
@@ -198,9 +420,9 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		inline Packer& pack(int8_t i) {
+		inline BasicPacker& pack(int8_t i) {
 			static_assert(sizeof(i) == 1, "int8_t size must be 1 byte");
-			boost::endian::conditional_reverse_inplace<boost::endian::order::native, Endianess>(i);
+			toWire(i);
 			return pack(reinterpret_cast<const char*>(&i), sizeof(i));
 		}
 
@@ -211,9 +433,12 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		inline Packer& pack(uint16_t i) {
+		inline BasicPacker& pack(uint16_t i) {
 			static_assert(sizeof(i) == 2, "uint16_t size must be 2 byte2");
-			boost::endian::conditional_reverse_inplace<boost::endian::order::native, Endianess>(i);
+			if(Encoding == IntegerEncoding::Varint) {
+				return packVarint(i);
+			}
+			toWire(i);
 			return pack(reinterpret_cast<const char*>(&i), sizeof(i));
 		}
 
@@ -224,9 +449,12 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		inline Packer& pack(int16_t i) {
+		inline BasicPacker& pack(int16_t i) {
 			static_assert(sizeof(i) == 2, "int16_t size must be 2 byte2");
-			boost::endian::conditional_reverse_inplace<boost::endian::order::native, Endianess>(i);
+			if(Encoding == IntegerEncoding::Varint) {
+				return packVarint(Varint::zigzag(i));
+			}
+			toWire(i);
 			return pack(reinterpret_cast<const char*>(&i), sizeof(i));
 		}
 
@@ -237,9 +465,12 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		inline Packer& pack(uint32_t i) {
+		inline BasicPacker& pack(uint32_t i) {
 			static_assert(sizeof(i) == 4, "uint32_t size must be 4 bytes");
-			boost::endian::conditional_reverse_inplace<boost::endian::order::native, Endianess>(i);
+			if(Encoding == IntegerEncoding::Varint) {
+				return packVarint(i);
+			}
+			toWire(i);
 			return pack(reinterpret_cast<const char*>(&i), sizeof(i));
 		}
 
@@ -250,9 +481,12 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		inline Packer& pack(int32_t i) {
+		inline BasicPacker& pack(int32_t i) {
 			static_assert(sizeof(i) == 4, "int32_t size must be 4 bytes");
-			boost::endian::conditional_reverse_inplace<boost::endian::order::native, Endianess>(i);
+			if(Encoding == IntegerEncoding::Varint) {
+				return packVarint(Varint::zigzag(i));
+			}
+			toWire(i);
 			return pack(reinterpret_cast<const char*>(&i), sizeof(i));
 		}
 
@@ -263,9 +497,12 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		inline Packer& pack(uint64_t i) {
+		inline BasicPacker& pack(uint64_t i) {
 			static_assert(sizeof(i) == 8, "uint64_t size must be 8 bytes");
-			boost::endian::conditional_reverse_inplace<boost::endian::order::native, Endianess>(i);
+			if(Encoding == IntegerEncoding::Varint) {
+				return packVarint(i);
+			}
+			toWire(i);
 			return pack(reinterpret_cast<const char*>(&i), sizeof(i));
 		}
 
@@ -276,9 +513,12 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		inline Packer& pack(int64_t i) {
+		inline BasicPacker& pack(int64_t i) {
 			static_assert(sizeof(i) == 8, "int64_t size must be 8 bytes");
-			boost::endian::conditional_reverse_inplace<boost::endian::order::native, Endianess>(i);
+			if(Encoding == IntegerEncoding::Varint) {
+				return packVarint(Varint::zigzag(i));
+			}
+			toWire(i);
 			return pack(reinterpret_cast<const char*>(&i), sizeof(i));
 		}
 
@@ -289,7 +529,7 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		inline Packer& pack(bool b) {
+		inline BasicPacker& pack(bool b) {
 			static_assert(sizeof(b) == 1, "bool size must be 1 byte");
 			return pack(reinterpret_cast<const char*>(&b), sizeof(b));
 		}
@@ -301,21 +541,60 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		inline Packer& pack(float f) {
+		inline BasicPacker& pack(float f) {
 			static_assert(sizeof(f) == 4, "float size must be 4 bytes");
-			return pack(reinterpret_cast<const char*>(&f), sizeof(f));
+			uint32_t i;
+			std::memcpy(&i, &f, sizeof(i));
+			toWire(i);
+			return pack(reinterpret_cast<const char*>(&i), sizeof(i));
 		}
 
 		/**
-		 * Packs a double value.
+		 * Packs a double value. With FloatEncoding::Single, the value is rounded to a float first.
 		 *
 		 * @param d the double value to pack
 		 *
 		 * @return this
 		 */
-		inline Packer& pack(double d) {
+		inline BasicPacker& pack(double d) {
 			static_assert(sizeof(d) == 8, "double size must be 8 bytes");
-			return pack(reinterpret_cast<const char*>(&d), sizeof(d));
+			if(Floats == FloatEncoding::Single) {
+				return pack(static_cast<float>(d));
+			}
+			uint64_t i;
+			std::memcpy(&i, &d, sizeof(i));
+			toWire(i);
+			return pack(reinterpret_cast<const char*>(&i), sizeof(i));
+		}
+
+	public: // Variable length integers
+		/**
+		 * Packs a container length. Depending on the Packer encoding, the length is packed as a fixed
+		 * size uint64_t or as a varint.
+		 *
+		 * Container serializers must pack their length with this method.
+		 *
+		 * @param length the container length
+		 *
+		 * @return this
+		 */
+		inline BasicPacker& packLength(uint64_t length) {
+			if(Encoding == IntegerEncoding::Fixed) {
+				return pack(length);
+			}
+			return packVarint(length);
+		}
+
+		/**
+		 * Packs a integer value as a LEB128 varint.
+		 *
+		 * @param value the integer value to pack
+		 *
+		 * @return this
+		 */
+		inline BasicPacker& packVarint(uint64_t value) {
+			char bytes[Varint::MaxLength];
+			return pack(static_cast<const char*>(bytes), Varint::encode(value, bytes));
 		}
 
 	public: // write operation
@@ -327,8 +606,9 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		inline Packer& pack(const char* ptr, size_t size) {
+		inline BasicPacker& pack(const char* ptr, size_t size) {
 			buffer.write(ptr, size);
+			Stats::packed(size);
 			return *this;
 		}
 
@@ -340,13 +620,30 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		inline Packer& pack(const unsigned char* ptr, size_t size) {
+		inline BasicPacker& pack(const unsigned char* ptr, size_t size) {
 			buffer.write(ptr, size);
+			Stats::packed(size);
 			return *this;
 		}
 
 	};
 
+	/**
+	 * A BasicPacker encoding integers with <tt>Endianess</tt> and <tt>Encoding</tt>, and floating
+	 * point values exactly.
+	 *
+	 * By default, all integers are encoded as little endian, this, however can be changed by setting "Endianess"
+	 * template parameter to something else. Setting "Encoding" to a varint IntegerEncoding encodes container
+	 * lengths, and optionally every integer, as LEB128 varints instead.
+	 *
+	 * @tparam Buffer       the buffer type to write data to
+	 * @tparam Endianess    the endianess used to encode integer types
+	 * @tparam Encoding     the encoding used for integer types and container lengths
+	 */
+	template<typename Buffer, boost::endian::order Endianess = boost::endian::order::little,
+			IntegerEncoding Encoding = IntegerEncoding::Fixed>
+	using Packer = BasicPacker<Buffer, PackingPolicy<Endianess, Encoding>>;
+
 }
 
 
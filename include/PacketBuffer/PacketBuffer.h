@@ -29,7 +29,20 @@
 
 #include "Packer.h"
 #include "Unpacker.h"
+#include "PackedSize.h"
+#include "BufferedUnpacker.h"
+#include "Frame.h"
+#include "Dispatcher.h"
+#include "Overlay.h"
+#include "ElementStream.h"
 
+#include "Buffer.h"
 #include "ObjectSerializer.h"
+#include "View.h"
+#include "Indexed.h"
+#include "PackedVectorView.h"
+#include "PackedMapView.h"
 #include "Serializer/Enum.h"
+#include "Serializer/View.h"
+#include "Serializer/Indexed.h"
 #include "Serializer/Std.h"
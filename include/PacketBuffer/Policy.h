@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_POLICY_H
+#define PACKETBUFFER_POLICY_H
+
+#include <boost/endian/conversion.hpp>
+
+#include <cstddef>
+
+#include "UnpackError.h"
+#include "Varint.h"
+
+namespace PacketBuffer {
+
+	/**
+	 * Selects how a Packer and Unpacker encode floating point values.
+	 */
+	enum class FloatEncoding {
+		/**
+		 * <tt>float</tt> and <tt>double</tt> values are encoded with their IEEE 754 bit pattern
+		 */
+		Exact,
+
+		/**
+		 * <tt>double</tt> values are rounded to single precision and encoded in 4 bytes, like
+		 * <tt>float</tt> values
+		 */
+		Single
+	};
+
+	/**
+	 * A statistics hook that records nothing. Its calls compile to nothing.
+	 *
+	 * A custom hook implements the same static methods, for instance to count the bytes sent on a
+	 * link:
+	 *
+	 * @code
+	 *  struct LinkStats {
+	 *      static thread_local size_t bytes;
+	 *
+	 *      static void packed(size_t length) noexcept { bytes += length; }
+	 *      static void unpacked(size_t length) noexcept { bytes += length; }
+	 *      static void failed(UnpackError) noexcept {}
+	 *  };
+	 * @endcode
+	 */
+	struct NoStats {
+		/**
+		 * Called after <tt>length</tt> bytes are written by a Packer.
+		 */
+		static void packed(size_t) noexcept {}
+
+		/**
+		 * Called after <tt>length</tt> bytes are read or borrowed by a Unpacker.
+		 */
+		static void unpacked(size_t) noexcept {}
+
+		/**
+		 * Called when a Unpacker fails with <tt>error</tt>.
+		 */
+		static void failed(UnpackError) noexcept {}
+	};
+
+	/**
+	 * A bundle of the compile-time choices of a BasicPacker and BasicUnpacker. Every combination
+	 * is a distinct instantiation, so a choice costs no runtime branch.
+	 *
+	 * The Packer and Unpacker alias templates cover the common choices. Any other combination is
+	 * spelled with a PackingPolicy:
+	 *
+	 * @code
+	 *  using LinkPolicy = PackingPolicy<boost::endian::order::little, IntegerEncoding::Varint,
+	 *                                   Bounds::Checked, FloatEncoding::Single, LinkStats>;
+	 *
+	 *  BasicPacker<GrowableBuffer<>, LinkPolicy> packer(buffer);
+	 *  BasicUnpacker<SpanReader, LinkPolicy> unpacker(reader);
+	 * @endcode
+	 *
+	 * The Packer and the Unpacker of a link must use the same endianess, integer encoding and float
+	 * encoding. Bounds checking and statistics only concern the side that uses them.
+	 *
+	 * @tparam Endianess    the endianess used to encode integer types
+	 * @tparam Encoding     the encoding used for integer types and container lengths
+	 * @tparam Checking     whether the Unpacker checks reads against the input length
+	 * @tparam Floats       the encoding used for floating point types
+	 * @tparam Stats        the statistics hook, such as NoStats
+	 */
+	template<boost::endian::order Endianess = boost::endian::order::little,
+			IntegerEncoding Encoding = IntegerEncoding::Fixed, Bounds Checking = Bounds::Unchecked,
+			FloatEncoding Floats = FloatEncoding::Exact, typename Stats = NoStats>
+	struct PackingPolicy {
+		/**
+		 * The endianess used to encode integer types
+		 */
+		static constexpr boost::endian::order endianess = Endianess;
+
+		/**
+		 * The encoding used for integer types and container lengths
+		 */
+		static constexpr IntegerEncoding encoding = Encoding;
+
+		/**
+		 * Whether the Unpacker checks reads against the input length
+		 */
+		static constexpr Bounds checking = Checking;
+
+		/**
+		 * The encoding used for floating point types
+		 */
+		static constexpr FloatEncoding floats = Floats;
+
+		/**
+		 * The statistics hook
+		 */
+		using StatsHook = Stats;
+
+		/**
+		 * Whether the endianess is chosen at runtime instead
+		 */
+		static constexpr bool runtimeEndianess = false;
+	};
+
+	/**
+	 * A PackingPolicy whose endianess is chosen at runtime, for protocols that negotiate the byte
+	 * order at handshake time. It is set with <tt>setEndianess()</tt> on the BasicPacker or
+	 * BasicUnpacker, and defaults to little endian.
+	 *
+	 * Messages are instantiated once for both byte orders. Scalars test the byte order as they are
+	 * packed; contiguous ranges take a single branch to either copy or byte swap in bulk. Hot loops
+	 * can move the test out of the loop with <tt>withEndianess()</tt>, at the cost of instantiating
+	 * the loop once per byte order.
+	 *
+	 * @code
+	 *  BasicUnpacker<SpanReader, RuntimeEndianPolicy<>> unpacker(reader);
+	 *  unpacker.setEndianess(handshake.bigEndian ? boost::endian::order::big : boost::endian::order::little);
+	 * @endcode
+	 *
+	 * @tparam Encoding     the encoding used for integer types and container lengths
+	 * @tparam Checking     whether the Unpacker checks reads against the input length
+	 * @tparam Floats       the encoding used for floating point types
+	 * @tparam Stats        the statistics hook, such as NoStats
+	 */
+	template<IntegerEncoding Encoding = IntegerEncoding::Fixed, Bounds Checking = Bounds::Unchecked,
+			FloatEncoding Floats = FloatEncoding::Exact, typename Stats = NoStats>
+	struct RuntimeEndianPolicy : PackingPolicy<boost::endian::order::native, Encoding, Checking, Floats, Stats> {
+		/**
+		 * Whether the endianess is chosen at runtime instead
+		 */
+		static constexpr bool runtimeEndianess = true;
+	};
+
+	/**
+	 * The choices of <tt>Policy</tt> with the endianess fixed at compile time. This is the policy
+	 * of the BasicPacker or BasicUnpacker that <tt>withEndianess()</tt> passes to its function.
+	 *
+	 * @tparam Policy       the PackingPolicy whose other choices are kept
+	 * @tparam Endianess    the endianess used to encode integer types
+	 */
+	template<typename Policy, boost::endian::order Endianess>
+	struct FixedEndianPolicy : Policy {
+		/**
+		 * The endianess used to encode integer types
+		 */
+		static constexpr boost::endian::order endianess = Endianess;
+
+		/**
+		 * Whether the endianess is chosen at runtime instead
+		 */
+		static constexpr bool runtimeEndianess = false;
+	};
+
+}
+
+#endif //PACKETBUFFER_POLICY_H
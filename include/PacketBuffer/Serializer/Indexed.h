@@ -0,0 +1,491 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_SERIALIZER_INDEXED_H
+#define PACKETBUFFER_SERIALIZER_INDEXED_H
+
+#include "PacketBuffer/Indexed.h"
+#include "PacketBuffer/ObjectSerializer.h"
+#include "PacketBuffer/PackedSize.h"
+#include "PacketBuffer/UnpackError.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace PacketBuffer {
+
+	/**
+	 * Computes the offset table entries of indexed sections.
+	 */
+	namespace IndexedSection {
+
+		/**
+		 * A Packer buffer that measures an indexed section, and records the offset table of the
+		 * section and of every section nested in it, in the order they are packed.
+		 */
+		class SizeRecorder {
+		private:
+			/**
+			 * The recorded offset table entries
+			 */
+			std::vector<uint32_t> offsets;
+
+			/**
+			 * The number of bytes written so far
+			 */
+			size_t written = 0;
+
+		public:
+			/**
+			 * Counts <tt>length</tt> bytes. The data itself is discarded.
+			 *
+			 * @param length    the number of bytes to be written
+			 */
+			void write(const char*, size_t length) noexcept {
+				written += length;
+			}
+
+			/**
+			 * Counts <tt>length</tt> bytes. The data itself is discarded.
+			 *
+			 * @param length    the number of bytes to be written
+			 */
+			void write(const unsigned char*, size_t length) noexcept {
+				written += length;
+			}
+
+			/**
+			 * @return the number of bytes written so far
+			 */
+			size_t size() const noexcept {
+				return written;
+			}
+
+			/**
+			 * Makes room for the offset table of a section of <tt>items</tt> items.
+			 *
+			 * @param items the number of items of the section
+			 *
+			 * @return the index of the first entry of the table
+			 */
+			size_t open(size_t items) {
+				const size_t first = offsets.size();
+				offsets.resize(first + items);
+				return first;
+			}
+
+			/**
+			 * Records the offset table entry at <tt>entry</tt>.
+			 *
+			 * @param entry     the index of the entry, as returned by open() plus the item index
+			 * @param offset    the offset past the item, from the first item of the section
+			 */
+			void record(size_t entry, size_t offset) {
+				if(offset > std::numeric_limits<uint32_t>::max()) {
+#if defined(__cpp_exceptions)
+					throw std::length_error("Indexed section larger than 4 GiB");
+#else
+					std::abort();
+#endif
+				}
+				offsets[entry] = static_cast<uint32_t>(offset);
+			}
+
+			/**
+			 * @return the recorded offset table entries
+			 */
+			const std::vector<uint32_t>& getOffsets() const noexcept {
+				return offsets;
+			}
+		};
+
+		/**
+		 * A Packer buffer that forwards writes to <tt>Buffer</tt>, and hands out the offset
+		 * tables recorded by a SizeRecorder, in the order they were recorded.
+		 *
+		 * @tparam Buffer the buffer type to write data to
+		 */
+		template<typename Buffer>
+		class Replay {
+		private:
+			/**
+			 * The buffer writes are forwarded to
+			 */
+			Buffer& buffer;
+
+			/**
+			 * The next offset table entry
+			 */
+			const uint32_t* next;
+
+		public:
+			/**
+			 * Creates a new Replay.
+			 *
+			 * @param buffer    the buffer writes are forwarded to
+			 * @param offsets   the offset table entries recorded by a SizeRecorder
+			 */
+			Replay(Buffer& buffer, const uint32_t* offsets) noexcept : buffer(buffer), next(offsets) {}
+
+			/**
+			 * Writes <tt>length</tt> bytes from <tt>data</tt> into the buffer.
+			 *
+			 * @param data      the data to be written
+			 * @param length    the number of bytes to be written
+			 */
+			void write(const char* data, size_t length) {
+				buffer.write(data, length);
+			}
+
+			/**
+			 * Writes <tt>length</tt> bytes from <tt>data</tt> into the buffer.
+			 *
+			 * @param data      the data to be written
+			 * @param length    the number of bytes to be written
+			 */
+			void write(const unsigned char* data, size_t length) {
+				buffer.write(reinterpret_cast<const char*>(data), length);
+			}
+
+			/**
+			 * Takes the offset table of the next section.
+			 *
+			 * @param items the number of items of the section
+			 *
+			 * @return the first entry of the table
+			 */
+			const uint32_t* take(size_t items) noexcept {
+				const uint32_t* table = next;
+				next += items;
+				return table;
+			}
+		};
+
+		/**
+		 * Packs an offset table entry. Entries are always 4 bytes long, whatever the integer
+		 * encoding of the Packer.
+		 *
+		 * @tparam Packer   the packer type
+		 * @param packer    the packer to write to
+		 * @param offset    the offset to be packed
+		 */
+		template<typename Packer>
+		inline void packOffset(Packer& packer, uint32_t offset) {
+			if(packer.getEndianess() != boost::endian::order::native) {
+				boost::endian::endian_reverse_inplace(offset);
+			}
+			packer.pack(reinterpret_cast<const char*>(&offset), sizeof(offset));
+		}
+
+		/**
+		 * Unpacks an offset table entry.
+		 *
+		 * @tparam Unpacker the unpacker type
+		 * @param unpacker  the unpacker to read from
+		 * @param offset    the offset to unpack to
+		 */
+		template<typename Unpacker>
+		inline void unpackOffset(Unpacker& unpacker, uint32_t& offset) {
+			offset = 0;
+			unpacker.unpack(reinterpret_cast<char*>(&offset), sizeof(offset));
+			if(unpacker.getEndianess() != boost::endian::order::native) {
+				boost::endian::endian_reverse_inplace(offset);
+			}
+		}
+
+		/**
+		 * Skips <tt>length</tt> bytes of input, in chunks so that any buffer can be read from.
+		 *
+		 * @tparam Unpacker the unpacker type
+		 * @param unpacker  the unpacker to skip from
+		 * @param length    the number of bytes to be skipped
+		 */
+		template<typename Unpacker>
+		inline void skip(Unpacker& unpacker, size_t length) {
+			char scratch[256];
+			while(length > 0 && unpacker.good()) {
+				const size_t chunk = std::min(length, sizeof(scratch));
+				unpacker.unpack(scratch, chunk);
+				length -= chunk;
+			}
+		}
+
+		/**
+		 * Gives <tt>to</tt> the endianess chosen at runtime for <tt>from</tt>.
+		 */
+		template<typename From, typename To>
+		inline void copyEndianess(const From& from, To& to, std::true_type) noexcept {
+			to.setEndianess(from.getEndianess());
+		}
+
+		/**
+		 * Does nothing, as the endianess is fixed by the policy.
+		 */
+		template<typename From, typename To>
+		inline void copyEndianess(const From&, To&, std::false_type) noexcept {
+		}
+
+		/**
+		 * Measures a section of <tt>count</tt> items, recording its offset table.
+		 *
+		 * @tparam Policy   the PackingPolicy of the Packer
+		 * @tparam Items    a callable packing every item with a given packer, and calling a
+		 *                  given callback with the item index after each one
+		 * @param packer    the measuring packer
+		 * @param count     the number of items
+		 * @param items     packs the items
+		 */
+		template<typename Policy, typename Items>
+		inline void pack(BasicPacker<SizeRecorder, Policy>& packer, size_t count, const Items& items) {
+			SizeRecorder& recorder = packer.getBuffer();
+			packer.packLength(static_cast<uint64_t>(count));
+			const size_t table = recorder.open(count);
+			recorder.write(static_cast<const char*>(nullptr), count * sizeof(uint32_t));
+
+			const size_t start = recorder.size();
+			items(packer, [&recorder, table, start](size_t i) {
+				recorder.record(table + i, recorder.size() - start);
+			});
+		}
+
+		/**
+		 * Packs a section of <tt>count</tt> items whose offset table was recorded beforehand.
+		 *
+		 * @tparam Buffer   the buffer type to write data to
+		 * @tparam Policy   the PackingPolicy of the Packer
+		 * @tparam Items    a callable packing every item with a given packer
+		 * @param packer    the packer to write to
+		 * @param count     the number of items
+		 * @param items     packs the items
+		 */
+		template<typename Buffer, typename Policy, typename Items>
+		inline void pack(BasicPacker<Replay<Buffer>, Policy>& packer, size_t count, const Items& items) {
+			packer.packLength(static_cast<uint64_t>(count));
+			const uint32_t* table = packer.getBuffer().take(count);
+			for(size_t i = 0; i < count; i++) {
+				packOffset(packer, table[i]);
+			}
+			items(packer, [](size_t) {});
+		}
+
+		/**
+		 * Packs a section of <tt>count</tt> items.
+		 *
+		 * The section is first measured, which records the offset table of the section and of
+		 * every section nested in it. It is then packed with those tables, so that every item
+		 * is measured once, however deeply sections are nested.
+		 *
+		 * @tparam Buffer   the buffer type to write data to
+		 * @tparam Policy   the PackingPolicy of the Packer
+		 * @tparam Items    a callable packing every item with a given packer, and calling a
+		 *                  given callback with the item index after each one
+		 * @param packer    the packer to write to
+		 * @param count     the number of items
+		 * @param items     packs the items
+		 */
+		template<typename Buffer, typename Policy, typename Items>
+		inline void pack(BasicPacker<Buffer, Policy>& packer, size_t count, const Items& items) {
+			SizeRecorder recorder;
+			BasicPacker<SizeRecorder, PackingPolicy<boost::endian::order::native, Policy::encoding,
+					Bounds::Unchecked, Policy::floats>> measure(recorder);
+			pack(measure, count, items);
+
+			Replay<Buffer> replay(packer.getBuffer(), recorder.getOffsets().data());
+			BasicPacker<Replay<Buffer>, Policy> replayer(replay);
+			copyEndianess(packer, replayer, std::integral_constant<bool, Policy::runtimeEndianess>());
+			pack(replayer, count, items);
+		}
+
+	}
+
+	/**
+	 * A ObjectSerializer for IndexedFields.
+	 *
+	 * @tparam Ts the field types
+	 */
+	template<typename... Ts>
+	class ObjectSerializer<IndexedFields<Ts...>> {
+	public:
+		template<typename Packer>
+		static inline void pack(Packer& packer, const IndexedFields<Ts...>& fields) {
+			const auto& values = fields.getValues();
+			IndexedSection::pack(packer, sizeof...(Ts), [&values](auto& itemPacker, auto packed) {
+				packFields<0>(itemPacker, values, packed);
+			});
+		}
+
+		template<typename Unpacker>
+		static inline void unpack(Unpacker& unpacker, IndexedFields<Ts...>& fields) {
+			uint64_t items;
+			unpacker.unpackLength(items);
+
+			/*
+			 * Only the end of the last known field and the end of the section are needed to skip
+			 * items appended by a newer version of the message.
+			 */
+			uint32_t known = 0;
+			uint32_t last = 0;
+			for(uint64_t i = 0; i < items && unpacker.good(); i++) {
+				IndexedSection::unpackOffset(unpacker, last);
+				if(i < sizeof...(Ts)) {
+					known = last;
+				}
+			}
+			if(!unpacker.good()) {
+				return;
+			}
+
+			unpackFields<0>(unpacker, fields.getValues(), items);
+			if(last < known) {
+				unpacker.fail(UnpackError::Overflow);
+				return;
+			}
+			IndexedSection::skip(unpacker, last - known);
+		}
+
+	private:
+		template<size_t I, typename Packer, typename Tuple, typename Callback>
+		static inline typename std::enable_if<(I < sizeof...(Ts))>::type
+		packFields(Packer& packer, const Tuple& values, Callback& packed) {
+			packer.pack(std::get<I>(values));
+			packed(I);
+			packFields<I + 1>(packer, values, packed);
+		}
+
+		template<size_t I, typename Packer, typename Tuple, typename Callback>
+		static inline typename std::enable_if<(I == sizeof...(Ts))>::type
+		packFields(Packer&, const Tuple&, Callback&) {}
+
+		template<size_t I, typename Unpacker, typename Tuple>
+		static inline typename std::enable_if<(I < sizeof...(Ts))>::type
+		unpackFields(Unpacker& unpacker, Tuple& values, uint64_t items) {
+			if(I < items) {
+				unpacker.unpack(std::get<I>(values));
+				unpackFields<I + 1>(unpacker, values, items);
+			}
+		}
+
+		template<size_t I, typename Unpacker, typename Tuple>
+		static inline typename std::enable_if<(I == sizeof...(Ts))>::type
+		unpackFields(Unpacker&, Tuple&, uint64_t) {}
+	};
+
+	/**
+	 * A ObjectSerializer for IndexedArray.
+	 *
+	 * @tparam Container the container type
+	 */
+	template<typename Container>
+	class ObjectSerializer<IndexedArray<Container>> {
+	public:
+		template<typename Packer>
+		static inline void pack(Packer& packer, const IndexedArray<Container>& array) {
+			const Container& container = array.getContainer();
+			IndexedSection::pack(packer, container.size(), [&container](auto& itemPacker, auto packed) {
+				size_t i = 0;
+				for(const auto& element : container) {
+					itemPacker.pack(element);
+					packed(i++);
+				}
+			});
+		}
+
+		template<typename Unpacker>
+		static inline void unpack(Unpacker& unpacker, IndexedArray<Container>& array) {
+			Container& container = array.getContainer();
+			uint64_t items;
+			unpacker.unpackLength(items);
+			if(!unpacker.checkLength(container, items)) {
+				container.clear();
+				return;
+			}
+			if(items > unpacker.remaining() / sizeof(uint32_t)) {
+				unpacker.fail(UnpackError::LengthTooLarge);
+				container.clear();
+				return;
+			}
+
+			IndexedSection::skip(unpacker, static_cast<size_t>(items) * sizeof(uint32_t));
+			container.resize(static_cast<size_t>(items));
+			for(auto& element : container) {
+				unpacker.unpack(element);
+			}
+		}
+	};
+
+	/**
+	 * A ObjectSerializer for IndexedView.
+	 *
+	 * Unpacking borrows the offset table and the items from the input, so the Unpacker must sit
+	 * on a contiguous buffer, such as SpanReader. An IndexedView cannot be packed; pack the
+	 * section with indexed() or indexedArray() instead. The view must use the endianess and
+	 * the integer encoding of the Unpacker.
+	 */
+	template<boost::endian::order Endianess, IntegerEncoding Encoding>
+	class ObjectSerializer<IndexedView<Endianess, Encoding>> {
+	public:
+		template<typename Unpacker>
+		static inline void unpack(Unpacker& unpacker, IndexedView<Endianess, Encoding>& view) {
+			view = IndexedView<Endianess, Encoding>();
+			if(!unpacker.template expectFormat<Endianess, Encoding>()) {
+				return;
+			}
+
+			uint64_t items;
+			unpacker.unpackLength(items);
+			if(items > std::numeric_limits<size_t>::max() / sizeof(uint32_t)) {
+				unpacker.fail(UnpackError::Overflow);
+				return;
+			}
+
+			const size_t count = static_cast<size_t>(items);
+			const char* table = unpacker.borrow(count * sizeof(uint32_t));
+			if(table == nullptr || count == 0) {
+				return;
+			}
+
+			uint32_t length;
+			std::memcpy(&length, table + (count - 1) * sizeof(length), sizeof(length));
+			boost::endian::conditional_reverse_inplace<Endianess, boost::endian::order::native>(length);
+
+			const char* first = unpacker.borrow(length);
+			if(first != nullptr) {
+				view = IndexedView<Endianess, Encoding>(table, count, first, length);
+			}
+		}
+	};
+
+}
+
+#endif //PACKETBUFFER_SERIALIZER_INDEXED_H
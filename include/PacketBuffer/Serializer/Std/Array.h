@@ -30,6 +30,8 @@
 #ifndef PACKETBUFFER_SERIALIZER_STD_ARRAY_H
 #define PACKETBUFFER_SERIALIZER_STD_ARRAY_H
 
+#include "PacketBuffer/Limits.h"
+#include "PacketBuffer/PackedSize.h"
 #include "PacketBuffer/ObjectSerializer.h"
 
 #include <array>
@@ -62,16 +64,12 @@ namespace PacketBuffer {
 	public:
 		template<typename Packer>
 		static inline void pack(Packer& packer, T const array[S]) {
-			for(int i = 0; i < S; i++) {
-				packer(array[i]);
-			}
+			packer.packArray(array, S);
 		}
 
 		template<typename Unpacker>
 		static inline void unpack(Unpacker& unpacker, T array[S]) {
-			for(int i = 0; i < S; i++) {
-				unpacker(array[i]);
-			}
+			unpacker.unpackArray(array, S);
 		}
 	};
 
@@ -138,19 +136,52 @@ namespace PacketBuffer {
 	public:
 		template<typename Packer>
 		static inline void pack(Packer& packer, const std::array<T, S>& array) {
-			for(int i = 0; i < S; i++) {
-				packer(array[i]);
-			}
+			packer.packArray(array.data(), S);
 		}
 
 		template<typename Unpacker>
 		static inline void unpack(Unpacker& unpacker, std::array<T, S>& array) {
-			for(int i = 0; i < S; i++) {
-				unpacker(array[i]);
-			}
+			unpacker.unpackArray(array.data(), S);
 		}
 	};
 
+	/**
+	 * The minimum number of bytes that a std::array of type <tt>T</tt> with
+	 * size of <tt>S</tt> takes once packed.
+	 *
+	 * @tparam T the array type
+	 * @tparam S the array fixed size
+	 */
+	template<typename T, size_t S>
+	struct MinimumPackedSize<std::array<T, S>> : std::integral_constant<size_t,
+			MinimumPackedSize<T>::value * S> {
+	};
+
+	/**
+	 * The maximum number of bytes that a statically sized array of type
+	 * <tt>T</tt> with size of <tt>S</tt> takes once packed.
+	 *
+	 * @tparam T        the array type
+	 * @tparam S        the array fixed size
+	 * @tparam Encoding the integer encoding of the Packer
+	 */
+	template<typename T, size_t S, IntegerEncoding Encoding>
+	struct MaxPackedSize<T[S], Encoding, EnableIfMaxPackedSize<Encoding, T>> :
+			MaxPackedArraySize<T, S, Encoding> {
+	};
+
+	/**
+	 * The maximum number of bytes that a std::array of type <tt>T</tt> with
+	 * size of <tt>S</tt> takes once packed.
+	 *
+	 * @tparam T        the array type
+	 * @tparam S        the array fixed size
+	 * @tparam Encoding the integer encoding of the Packer
+	 */
+	template<typename T, size_t S, IntegerEncoding Encoding>
+	struct MaxPackedSize<std::array<T, S>, Encoding, EnableIfMaxPackedSize<Encoding, T>> :
+			MaxPackedArraySize<T, S, Encoding> {
+	};
 
 }
 
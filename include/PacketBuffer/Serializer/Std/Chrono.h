@@ -31,6 +31,7 @@
 #define PACKETBUFFER_SERIALIZER_STD_CHRONO_H
 
 #include "PacketBuffer/ObjectSerializer.h"
+#include "PacketBuffer/PackedSize.h"
 
 #include <chrono>
 
@@ -85,6 +86,30 @@ namespace PacketBuffer {
 		}
 	};
 
+	/**
+	 * The maximum number of bytes that a std::chrono::duration takes once
+	 * packed.
+	 *
+	 * @tparam R        the duration representation type
+	 * @tparam P        the duration period type
+	 * @tparam Encoding the integer encoding of the Packer
+	 */
+	template<typename R, typename P, IntegerEncoding Encoding>
+	struct MaxPackedSize<std::chrono::duration<R, P>, Encoding> : MaxPackedSize<int64_t, Encoding> {
+	};
+
+	/**
+	 * The maximum number of bytes that a std::chrono::time_point takes once
+	 * packed.
+	 *
+	 * @tparam Clock    the time_point clock type
+	 * @tparam Duration the time_point duration type
+	 * @tparam Encoding the integer encoding of the Packer
+	 */
+	template<typename Clock, typename Duration, IntegerEncoding Encoding>
+	struct MaxPackedSize<std::chrono::time_point<Clock, Duration>, Encoding> : MaxPackedSize<int64_t, Encoding> {
+	};
+
 }
 
 #endif //PACKETBUFFER_SERIALIZER_STD_CHRONO_H
@@ -60,9 +60,14 @@ namespace PacketBuffer {
 		static inline void unpack(Unpacker& unpacker, std::experimental::optional<T>& optional) {
 			bool hasValue;
 			unpacker(hasValue);
-			if(hasValue) {
-				unpacker(*optional);
+			if(!hasValue) {
+				optional = std::experimental::nullopt;
+				return;
 			}
+			if(!optional) {
+				optional = T();
+			}
+			unpacker(*optional);
 		}
 	};
 
@@ -50,7 +50,7 @@ namespace PacketBuffer {
 		template<typename Packer>
 		static inline void pack(Packer& packer, const std::list<T, Allocator>& list) {
 			auto items = static_cast<uint64_t>(list.size());
-			packer(items);
+			packer.packLength(items);
 			for(auto& entry : list) {
 				packer(entry);
 			}
@@ -59,12 +59,15 @@ namespace PacketBuffer {
 		template<typename Unpacker>
 		static inline void unpack(Unpacker& unpacker, std::list<T, Allocator>& list) {
 			uint64_t items;
-			unpacker(items);
+			unpacker.unpackLength(items);
+			if(!unpacker.checkLength(list, items)) {
+				list.clear();
+				return;
+			}
 
-			for(int i = 0; i < items; i++) {
-				T v;
-				unpacker(v);
-				list.push_back(v);
+			list.resize((size_t) items);
+			for(auto& element : list) {
+				unpacker(element);
 			}
 		}
 	};
@@ -54,8 +54,8 @@ namespace PacketBuffer {
 		template<typename Packer>
 		static inline void pack(Packer& packer, const std::map<K, V, Compare, Allocator>& map) {
 			auto items = static_cast<uint64_t>(map.size());
-			packer(items);
-			for(const std::pair<K, V>& entry : map) {
+			packer.packLength(items);
+			for(const auto& entry : map) {
 				packer(entry);
 			}
 		}
@@ -63,7 +63,11 @@ namespace PacketBuffer {
 		template<typename Unpacker>
 		static inline void unpack(Unpacker& unpacker, std::map<K, V, Compare, Allocator>& map) {
 			uint64_t items;
-			unpacker(items);
+			unpacker.unpackLength(items);
+			map.clear();
+			if(!unpacker.checkLength(map, items)) {
+				return;
+			}
 
 			for(uint64_t i = 0; i < items; i++) {
 				std::pair<K, V> entry;
@@ -89,8 +93,8 @@ namespace PacketBuffer {
 		template<typename Packer>
 		static inline void pack(Packer& packer, const std::unordered_map<K, V, Hash, Predicate, Allocator>& map) {
 			auto items = static_cast<uint64_t>(map.size());
-			packer(items);
-			for(const std::pair<K, V>& entry : map) {
+			packer.packLength(items);
+			for(const auto& entry : map) {
 				packer(entry);
 			}
 		}
@@ -98,7 +102,11 @@ namespace PacketBuffer {
 		template<typename Unpacker>
 		static inline void unpack(Unpacker& unpacker, std::unordered_map<K, V, Hash, Predicate, Allocator>& map) {
 			uint64_t items;
-			unpacker(items);
+			unpacker.unpackLength(items);
+			map.clear();
+			if(!unpacker.checkLength(map, items)) {
+				return;
+			}
 
 			for(uint64_t i = 0; i < items; i++) {
 				std::pair<K, V> entry;
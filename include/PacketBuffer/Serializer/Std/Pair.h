@@ -30,6 +30,8 @@
 #ifndef PACKETBUFFER_SERIALIZER_STD_PAIR_H
 #define PACKETBUFFER_SERIALIZER_STD_PAIR_H
 
+#include "PacketBuffer/Limits.h"
+#include "PacketBuffer/PackedSize.h"
 #include "PacketBuffer/ObjectSerializer.h"
 
 #include <utility>
@@ -56,6 +58,31 @@ namespace PacketBuffer {
 		}
 	};
 
+	/**
+	 * The minimum number of bytes that a std::pair of types <tt>T1</tt> and
+	 * <tt>T2</tt> takes once packed.
+	 *
+	 * @tparam T1 the pair first type
+	 * @tparam T2 the pair second type
+	 */
+	template<typename T1, typename T2>
+	struct MinimumPackedSize<std::pair<T1, T2>> : std::integral_constant<size_t,
+			MinimumPackedSize<typename std::remove_cv<T1>::type>::value +
+			MinimumPackedSize<typename std::remove_cv<T2>::type>::value> {
+	};
+
+	/**
+	 * The maximum number of bytes that a std::pair of types <tt>T1</tt> and
+	 * <tt>T2</tt> takes once packed.
+	 *
+	 * @tparam T1       the pair first type
+	 * @tparam T2       the pair second type
+	 * @tparam Encoding the integer encoding of the Packer
+	 */
+	template<typename T1, typename T2, IntegerEncoding Encoding>
+	struct MaxPackedSize<std::pair<T1, T2>, Encoding, EnableIfMaxPackedSize<Encoding, T1, T2>> :
+			MaxPackedSizeOf<Encoding, T1, T2> {
+	};
 
 }
 
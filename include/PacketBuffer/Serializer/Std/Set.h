@@ -62,7 +62,7 @@ namespace PacketBuffer {
 		template<typename Packer>
 		static inline void pack(Packer& packer, const std::set<T, Compare, Allocator>& set) {
 			auto items = static_cast<uint64_t>(set.size());
-			packer(items);
+			packer.packLength(items);
 			for(auto& entry : set) {
 				packer(entry);
 			}
@@ -71,9 +71,13 @@ namespace PacketBuffer {
 		template<typename Unpacker>
 		static inline void unpack(Unpacker& unpacker, std::set<T, Compare, Allocator>& set) {
 			uint64_t items;
-			unpacker(items);
+			unpacker.unpackLength(items);
+			set.clear();
+			if(!unpacker.checkLength(set, items)) {
+				return;
+			}
 
-			for(int i = 0; i < items; i++) {
+			for(uint64_t i = 0; i < items; i++) {
 				T v;
 				unpacker(v);
 				set.insert(v);
@@ -107,7 +111,7 @@ namespace PacketBuffer {
 		template<typename Packer>
 		static inline void pack(Packer& packer, const std::unordered_set<T, Hash, Predicate, Allocator>& set) {
 			auto items = static_cast<uint64_t>(set.size());
-			packer(items);
+			packer.packLength(items);
 			for(auto& entry : set) {
 				packer(entry);
 			}
@@ -116,10 +120,14 @@ namespace PacketBuffer {
 		template<typename Unpacker>
 		static inline void unpack(Unpacker& unpacker, std::unordered_set<T, Hash, Predicate, Allocator>& set) {
 			uint64_t items;
-			unpacker(items);
+			unpacker.unpackLength(items);
+			set.clear();
+			if(!unpacker.checkLength(set, items)) {
+				return;
+			}
 
-			set.reserve(items);
-			for(int i = 0; i < items; i++) {
+			set.reserve((size_t) items);
+			for(uint64_t i = 0; i < items; i++) {
 				T v;
 				unpacker(v);
 				set.insert(v);
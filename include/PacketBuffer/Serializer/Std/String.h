@@ -51,8 +51,8 @@ namespace PacketBuffer {
 		template<typename Packer>
 		static inline void pack(Packer& packer, const std::basic_string<T, Traits, Allocator>& string) {
 			auto length = static_cast<uint64_t>(string.size());
-			packer(length);
-			for(int i = 0; i < length; i++) {
+			packer.packLength(length);
+			for(uint64_t i = 0; i < length; i++) {
 				packer(string[i]);
 			}
 		}
@@ -60,10 +60,14 @@ namespace PacketBuffer {
 		template<typename Unpacker>
 		static inline void unpack(Unpacker& unpacker, std::basic_string<T, Traits, Allocator>& string) {
 			uint64_t length;
-			unpacker(length);
+			unpacker.unpackLength(length);
+			if(!unpacker.checkLength(string, length)) {
+				string.clear();
+				return;
+			}
 
-			string.resize(length);
-			for(int i = 0; i < length; i++) {
+			string.resize((size_t) length);
+			for(uint64_t i = 0; i < length; i++) {
 				unpacker(string[i]);
 			}
 		}
@@ -78,14 +82,18 @@ namespace PacketBuffer {
 		template<typename Packer>
 		static inline void pack(Packer& packer, const std::string& string) {
 			auto length = static_cast<uint64_t>(string.size());
-			packer(length);
+			packer.packLength(length);
 			packer.pack(string.data(), string.size());
 		}
 
 		template<typename Unpacker>
 		static inline void unpack(Unpacker& unpacker, std::string& string) {
 			uint64_t length;
-			unpacker(length);
+			unpacker.unpackLength(length);
+			if(!unpacker.checkLength(string, length)) {
+				string.clear();
+				return;
+			}
 
 			string.resize((size_t) length);
 			unpacker.unpack(&string[0], string.size());
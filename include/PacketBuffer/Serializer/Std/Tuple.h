@@ -31,6 +31,7 @@
 #define PACKETBUFFER_SERIALIZER_STD_TUPLE_H
 
 #include "PacketBuffer/ObjectSerializer.h"
+#include "PacketBuffer/PackedSize.h"
 
 #include <tuple>
 
@@ -75,6 +76,18 @@ namespace PacketBuffer {
 
 	};
 
+	/**
+	 * The maximum number of bytes that a std::tuple with elements of type
+	 * <tt>Ts</tt> takes once packed.
+	 *
+	 * @tparam Ts       the tuple element types
+	 * @tparam Encoding the integer encoding of the Packer
+	 */
+	template<IntegerEncoding Encoding, typename... Ts>
+	struct MaxPackedSize<std::tuple<Ts...>, Encoding, EnableIfMaxPackedSize<Encoding, Ts...>> :
+			MaxPackedSizeOf<Encoding, Ts...> {
+	};
+
 }
 
 #endif //PACKETBUFFER_SERIALIZER_STD_TUPLE_H
@@ -60,20 +60,60 @@ namespace PacketBuffer {
 		template<typename Packer>
 		static inline void pack(Packer& packer, const std::vector<T, Allocator>& vector) {
 			auto items = static_cast<uint64_t>(vector.size());
-			packer(items);
-			for(uint64_t i = 0; i < items; i++) {
-				packer(vector[i]);
-			}
+			packer.packLength(items);
+			packer.packArray(vector.data(), vector.size());
 		}
 
 		template<typename Unpacker>
 		static inline void unpack(Unpacker& unpacker, std::vector<T, Allocator>& vector) {
 			uint64_t items;
-			unpacker(items);
+			unpacker.unpackLength(items);
+			if(!unpacker.checkLength(vector, items)) {
+				vector.clear();
+				return;
+			}
+
+			vector.resize((size_t) items);
+			unpacker.unpackArray(vector.data(), vector.size());
+		}
+	};
+
+	/**
+	 * A ObjectSerializer for std::vector<bool> using an allocator of type
+	 * <tt>Allocator</tt>.
+	 *
+	 * std::vector<bool> does not store its elements contiguously, so they
+	 * are packed one by one. The serialized format is the same as for any
+	 * other std::vector.
+	 *
+	 * @tparam Allocator the vector allocator type
+	 */
+	template<typename Allocator>
+	class ObjectSerializer<std::vector<bool, Allocator>> {
+	public:
+		template<typename Packer>
+		static inline void pack(Packer& packer, const std::vector<bool, Allocator>& vector) {
+			auto items = static_cast<uint64_t>(vector.size());
+			packer.packLength(items);
+			for(bool value : vector) {
+				packer(value);
+			}
+		}
+
+		template<typename Unpacker>
+		static inline void unpack(Unpacker& unpacker, std::vector<bool, Allocator>& vector) {
+			uint64_t items;
+			unpacker.unpackLength(items);
+			if(!unpacker.checkLength(vector, items)) {
+				vector.clear();
+				return;
+			}
 
 			vector.resize((size_t) items);
-			for(uint64_t i = 0; i < items; i++) {
-				unpacker(vector[i]);
+			for(size_t i = 0; i < vector.size(); i++) {
+				bool value;
+				unpacker(value);
+				vector[i] = value;
 			}
 		}
 	};
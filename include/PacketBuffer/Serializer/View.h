@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_SERIALIZER_VIEW_H
+#define PACKETBUFFER_SERIALIZER_VIEW_H
+
+#include "PacketBuffer/ObjectSerializer.h"
+#include "PacketBuffer/PackedMapView.h"
+#include "PacketBuffer/PackedVectorView.h"
+#include "PacketBuffer/UnpackError.h"
+#include "PacketBuffer/View.h"
+
+#include <limits>
+
+namespace PacketBuffer {
+
+	/**
+	 * A ObjectSerializer for StringView.
+	 *
+	 * The packed format is the same as std::string. Unpacking borrows the
+	 * characters from the input, so the Unpacker must sit on a contiguous
+	 * buffer, such as SpanReader.
+	 */
+	template<>
+	class ObjectSerializer<StringView> {
+	public:
+		template<typename Packer>
+		static inline void pack(Packer& packer, const StringView& view) {
+			packer.packLength(static_cast<uint64_t>(view.size()));
+			packer.pack(view.data(), view.size());
+		}
+
+		template<typename Unpacker>
+		static inline void unpack(Unpacker& unpacker, StringView& view) {
+			uint64_t length;
+			unpacker.unpackLength(length);
+			if(length > std::numeric_limits<size_t>::max()) {
+				unpacker.fail(UnpackError::Overflow);
+				view = StringView();
+				return;
+			}
+
+			const char* data = unpacker.borrow(static_cast<size_t>(length));
+			view = data ? StringView(data, static_cast<size_t>(length)) : StringView();
+		}
+	};
+
+	/**
+	 * A ObjectSerializer for ByteSpan.
+	 *
+	 * The packed format is the same as std::vector<uint8_t>. Unpacking
+	 * borrows the bytes from the input, so the Unpacker must sit on a
+	 * contiguous buffer, such as SpanReader.
+	 */
+	template<>
+	class ObjectSerializer<ByteSpan> {
+	public:
+		template<typename Packer>
+		static inline void pack(Packer& packer, const ByteSpan& span) {
+			packer.packLength(static_cast<uint64_t>(span.size()));
+			packer.pack(reinterpret_cast<const char*>(span.data()), span.size());
+		}
+
+		template<typename Unpacker>
+		static inline void unpack(Unpacker& unpacker, ByteSpan& span) {
+			uint64_t length;
+			unpacker.unpackLength(length);
+			if(length > std::numeric_limits<size_t>::max()) {
+				unpacker.fail(UnpackError::Overflow);
+				span = ByteSpan();
+				return;
+			}
+
+			const char* data = unpacker.borrow(static_cast<size_t>(length));
+			span = data ? ByteSpan(data, static_cast<size_t>(length)) : ByteSpan();
+		}
+	};
+
+	/**
+	 * A ObjectSerializer for PackedVectorView.
+	 *
+	 * The packed format is the same as std::vector. Unpacking borrows the
+	 * elements from the input, so the Unpacker must sit on a contiguous
+	 * buffer, such as SpanReader. A PackedVectorView cannot be packed; pack
+	 * the std::vector instead. The view must use the endianess and the
+	 * integer encoding of the Unpacker, and its elements must not hold
+	 * doubles packed in single precision.
+	 */
+	template<typename T, boost::endian::order Endianess, IntegerEncoding Encoding>
+	class ObjectSerializer<PackedVectorView<T, Endianess, Encoding>> {
+	public:
+		template<typename Unpacker>
+		static inline void unpack(Unpacker& unpacker, PackedVectorView<T, Endianess, Encoding>& view) {
+			constexpr size_t stride = PackedVectorView<T, Endianess, Encoding>::Stride;
+			if(!unpacker.template expectFormat<Endianess, Encoding, T>()) {
+				view = PackedVectorView<T, Endianess, Encoding>();
+				return;
+			}
+
+			uint64_t items;
+			unpacker.unpackLength(items);
+			if(items > std::numeric_limits<size_t>::max() / stride) {
+				unpacker.fail(UnpackError::Overflow);
+				view = PackedVectorView<T, Endianess, Encoding>();
+				return;
+			}
+
+			const char* data = unpacker.borrow(static_cast<size_t>(items) * stride);
+			view = data ? PackedVectorView<T, Endianess, Encoding>(data, static_cast<size_t>(items)) :
+				   PackedVectorView<T, Endianess, Encoding>();
+		}
+	};
+
+	/**
+	 * A ObjectSerializer for PackedMapView.
+	 *
+	 * The packed format is the same as std::map. Unpacking borrows the
+	 * entries from the input, so the Unpacker must sit on a contiguous
+	 * buffer, such as SpanReader. A PackedMapView cannot be packed; pack the
+	 * std::map instead. Like PackedVectorView, the view must use the
+	 * endianess and the integer encoding of the Unpacker, and its entries
+	 * must not hold doubles packed in single precision. The view keeps its
+	 * comparison functor.
+	 */
+	template<typename K, typename V, boost::endian::order Endianess, IntegerEncoding Encoding, typename Compare>
+	class ObjectSerializer<PackedMapView<K, V, Endianess, Encoding, Compare>> {
+	public:
+		template<typename Unpacker>
+		static inline void unpack(Unpacker& unpacker, PackedMapView<K, V, Endianess, Encoding, Compare>& view) {
+			PackedVectorView<std::pair<K, V>, Endianess, Encoding> entries;
+			unpacker(entries);
+			view = PackedMapView<K, V, Endianess, Encoding, Compare>(entries.data(), entries.size(), view.key_comp());
+		}
+	};
+
+}
+
+#endif //PACKETBUFFER_SERIALIZER_VIEW_H
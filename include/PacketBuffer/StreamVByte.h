@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_STREAMVBYTE_H
+#define PACKETBUFFER_STREAMVBYTE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "ByteSwap.h"
+
+namespace PacketBuffer {
+
+	/**
+	 * Stream VByte encoding of <tt>uint32_t</tt> ranges.
+	 *
+	 * Each value is stored in 1 to 4 little endian bytes. Its length is kept
+	 * apart, as a 2-bit code in a control byte shared by 4 consecutive values
+	 * (the first value in the least significant bits). The control bytes of a
+	 * block are followed by the data bytes of the block.
+	 *
+	 * Since a control byte tells where each of its 4 values starts, a group
+	 * of values is decoded without branches by a single <tt>pshufb</tt> on
+	 * x86. The fastest kernel supported by the running CPU is selected on
+	 * first use. Defining <tt>PACKETBUFFER_NO_SIMD</tt> restricts decoding
+	 * to the scalar kernel.
+	 */
+	namespace StreamVByte {
+
+		/**
+		 * The number of values packed in a block by Packer::packArray()
+		 */
+		constexpr size_t BlockLength = 1024;
+
+		/**
+		 * The number of bytes that must be readable past the data bytes given
+		 * to decode()
+		 */
+		constexpr size_t Padding = 16;
+
+		/**
+		 * The length and decoding shuffle of every control byte.
+		 */
+		struct Tables {
+			/**
+			 * The number of data bytes of the 4 values of a control byte
+			 */
+			uint8_t lengths[256];
+
+			/**
+			 * A pshufb mask that moves the data bytes of the 4 values of a
+			 * control byte into 4 <tt>uint32_t</tt> lanes
+			 */
+			alignas(16) uint8_t shuffles[256][16];
+		};
+
+		/**
+		 * @return the tables of every control byte
+		 */
+		constexpr Tables makeTables() {
+			Tables tables{};
+			for(int control = 0; control < 256; control++) {
+				int offset = 0;
+				for(int value = 0; value < 4; value++) {
+					const int length = ((control >> (2 * value)) & 3) + 1;
+					for(int byte = 0; byte < 4; byte++) {
+						tables.shuffles[control][value * 4 + byte] =
+								static_cast<uint8_t>(byte < length ? offset + byte : 0x80);
+					}
+					offset += length;
+				}
+				tables.lengths[control] = static_cast<uint8_t>(offset);
+			}
+			return tables;
+		}
+
+		/**
+		 * @return the tables of every control byte
+		 */
+		inline const Tables& tables() noexcept {
+			static constexpr Tables Instance = makeTables();
+			return Instance;
+		}
+
+		/**
+		 * @return the number of control bytes of <tt>count</tt> values
+		 */
+		constexpr size_t controlLength(size_t count) noexcept {
+			return (count + 3) / 4;
+		}
+
+		/**
+		 * @return the number of data bytes of <tt>count</tt> values described
+		 * by <tt>control</tt>
+		 */
+		inline size_t dataLength(const char* control, size_t count) noexcept {
+			const Tables& t = tables();
+			size_t length = 0;
+			for(size_t i = 0; i < count / 4; i++) {
+				length += t.lengths[static_cast<uint8_t>(control[i])];
+			}
+			for(size_t i = count & ~size_t(3); i < count; i++) {
+				length += ((static_cast<uint8_t>(control[i / 4]) >> (2 * (i % 4))) & 3) + 1;
+			}
+			return length;
+		}
+
+		/**
+		 * Encodes <tt>count</tt> values.
+		 *
+		 * @param values    the values to be encoded
+		 * @param count     the number of values
+		 * @param control   the control bytes, at least controlLength() bytes
+		 * @param data      the data bytes, at least 4 bytes per value
+		 *
+		 * @return the number of data bytes written
+		 */
+		inline size_t encode(const uint32_t* values, size_t count, char* control, char* data) noexcept {
+			if(count == 0) {
+				return 0;
+			}
+			std::memset(control, 0, controlLength(count));
+
+			size_t length = 0;
+			for(size_t i = 0; i < count; i++) {
+				const uint32_t value = values[i];
+				const unsigned int code = (value > 0xFF) + (value > 0xFFFF) + (value > 0xFFFFFF);
+				for(unsigned int byte = 0; byte <= code; byte++) {
+					data[length++] = static_cast<char>(value >> (8 * byte));
+				}
+				control[i / 4] = static_cast<char>(control[i / 4] | (code << (2 * (i % 4))));
+			}
+			return length;
+		}
+
+		/**
+		 * A kernel that decodes <tt>count</tt> values described by
+		 * <tt>control</tt> from <tt>data</tt>.
+		 */
+		using Kernel = void (*)(uint32_t* values, size_t count, const char* control, const char* data);
+
+		/**
+		 * Decodes <tt>count</tt> values one at a time.
+		 */
+		inline void decodeScalar(uint32_t* values, size_t count, const char* control, const char* data) {
+			const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+			for(size_t i = 0; i < count; i++) {
+				const unsigned int length = ((static_cast<uint8_t>(control[i / 4]) >> (2 * (i % 4))) & 3) + 1;
+				uint32_t value = 0;
+				for(unsigned int byte = 0; byte < length; byte++) {
+					value |= static_cast<uint32_t>(bytes[byte]) << (8 * byte);
+				}
+				bytes += length;
+				values[i] = value;
+			}
+		}
+
+#if defined(PACKETBUFFER_BYTESWAP_X86)
+		/**
+		 * Decodes <tt>count</tt> values, 4 at a time.
+		 */
+		__attribute__((target("ssse3")))
+		inline void decodeSSSE3(uint32_t* values, size_t count, const char* control, const char* data) {
+			const Tables& t = tables();
+			const size_t groups = count / 4;
+			for(size_t i = 0; i < groups; i++) {
+				const uint8_t code = static_cast<uint8_t>(control[i]);
+				const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+				const __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i*>(t.shuffles[code]));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(values + i * 4), _mm_shuffle_epi8(block, shuffle));
+				data += t.lengths[code];
+			}
+			decodeScalar(values + groups * 4, count - groups * 4, control + groups, data);
+		}
+
+		/**
+		 * Decodes <tt>count</tt> values, 8 at a time.
+		 */
+		__attribute__((target("avx2")))
+		inline void decodeAVX2(uint32_t* values, size_t count, const char* control, const char* data) {
+			const Tables& t = tables();
+			const size_t pairs = count / 8;
+			for(size_t i = 0; i < pairs; i++) {
+				const uint8_t low = static_cast<uint8_t>(control[i * 2]);
+				const uint8_t high = static_cast<uint8_t>(control[i * 2 + 1]);
+				const char* second = data + t.lengths[low];
+
+				const __m256i block = _mm256_inserti128_si256(_mm256_castsi128_si256(
+						_mm_loadu_si128(reinterpret_cast<const __m128i*>(data))),
+						_mm_loadu_si128(reinterpret_cast<const __m128i*>(second)), 1);
+				const __m256i shuffle = _mm256_inserti128_si256(_mm256_castsi128_si256(
+						_mm_load_si128(reinterpret_cast<const __m128i*>(t.shuffles[low]))),
+						_mm_load_si128(reinterpret_cast<const __m128i*>(t.shuffles[high])), 1);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(values + i * 8), _mm256_shuffle_epi8(block, shuffle));
+				data = second + t.lengths[high];
+			}
+			decodeSSSE3(values + pairs * 8, count - pairs * 8, control + pairs * 2, data);
+		}
+#endif
+
+		/**
+		 * @return the fastest kernel supported by the running CPU
+		 */
+		inline Kernel selectKernel() {
+#if defined(PACKETBUFFER_BYTESWAP_X86)
+			__builtin_cpu_init();
+			if(__builtin_cpu_supports("avx2")) {
+				return &decodeAVX2;
+			}
+			if(__builtin_cpu_supports("ssse3")) {
+				return &decodeSSSE3;
+			}
+#endif
+			return &decodeScalar;
+		}
+
+		/**
+		 * Decodes <tt>count</tt> values described by <tt>control</tt> from
+		 * <tt>data</tt>, using the fastest kernel supported by the running
+		 * CPU.
+		 *
+		 * @param values    the decoded values
+		 * @param count     the number of values
+		 * @param control   the control bytes
+		 * @param data      the data bytes, followed by Padding readable bytes
+		 */
+		inline void decode(uint32_t* values, size_t count, const char* control, const char* data) {
+			if(count < 8) {
+				decodeScalar(values, count, control, data);
+				return;
+			}
+			static const Kernel kernel = selectKernel();
+			kernel(values, count, control, data);
+		}
+
+	}
+
+}
+
+#endif //PACKETBUFFER_STREAMVBYTE_H
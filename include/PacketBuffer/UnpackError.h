@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_UNPACKERROR_H
+#define PACKETBUFFER_UNPACKERROR_H
+
+#include <cstdint>
+
+namespace PacketBuffer {
+
+	/**
+	 * The error state of a Unpacker.
+	 *
+	 * Errors are sticky: once a Unpacker fails, it keeps reporting the first
+	 * error it encountered.
+	 */
+	enum class UnpackError : uint8_t {
+		/**
+		 * No error has occurred
+		 */
+		None = 0,
+
+		/**
+		 * The input ended before the object was fully unpacked
+		 */
+		Truncated,
+
+		/**
+		 * A decoded value does not fit in its destination type
+		 */
+		Overflow,
+
+		/**
+		 * A container length is larger than the input could possibly hold
+		 */
+		LengthTooLarge,
+
+		/**
+		 * A container goes over the Limits given to the Unpacker
+		 */
+		LimitExceeded,
+
+		/**
+		 * The endianess chosen at runtime differs from the one a view decodes with
+		 */
+		EndianessMismatch,
+
+		/**
+		 * The float encoding changes the packed size of the elements a view decodes
+		 */
+		FloatEncodingMismatch
+	};
+
+	/**
+	 * Selects whether a Unpacker checks reads against the input length.
+	 */
+	enum class Bounds {
+		/**
+		 * Reads are forwarded to the buffer unchecked
+		 */
+		Unchecked,
+
+		/**
+		 * Reads past the end of the input fail with UnpackError::Truncated
+		 */
+		Checked
+	};
+
+}
+
+#endif //PACKETBUFFER_UNPACKERROR_H
@@ -32,42 +32,392 @@
 
 #include <boost/endian/conversion.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "ByteSwap.h"
+#include "Limits.h"
 #include "ObjectSerializer.h"
+#include "PackedSize.h"
+#include "Policy.h"
+#include "StreamVByte.h"
+#include "UnpackError.h"
+#include "Varint.h"
 
 namespace PacketBuffer {
 
-	template<typename Buffer, boost::endian::order Endianess = boost::endian::order::little>
-	class Unpacker {
+	template<typename Buffer>
+	struct HasRemainingMethod {
+		template<typename U, size_t (U::*)() const noexcept>
+		struct SFINAE;
+
+		template<typename U>
+		static char test(SFINAE<U, &U::remaining>*);
+
+		template<typename U>
+		static int test(...);
+
+		static const bool value = sizeof(test<Buffer>(0)) == sizeof(char);
+	};
+
+	template<typename Buffer>
+	struct HasDataMethod {
+		template<typename U, const char* (U::*)() const noexcept>
+		struct SFINAE;
+
+		template<typename U>
+		static char test(SFINAE<U, &U::data>*);
+
+		template<typename U>
+		static int test(...);
+
+		static const bool value = sizeof(test<Buffer>(0)) == sizeof(char);
+	};
+
+	/**
+	 * The BasicUnpacker template class is responsible for converting a platform independent raw buffer back
+	 * into C++ primitive types like integers and raw buffers.
+	 *
+	 * How values are decoded is selected at compile time by a PackingPolicy, which must match the one of the
+	 * Packer. Most code uses the Unpacker alias template instead, which exposes the endianess, bounds
+	 * checking and the integer encoding.
+	 *
+	 * The <tt>Buffer</tt> class must implement a <tt>read</tt> with the following signature:
+	 * @code
+	 *  void read(char* data, size_t length);
+	 * @endcode
+	 *
+	 * When the policy enables Bounds::Checked, a read that would go past the end of the input fails with
+	 * UnpackError::Truncated instead of reaching the buffer. Failures are sticky: the remaining input is
+	 * discarded, so every further read fails with the same single compare and leaves its destination
+	 * zero-filled. The error can be inspected with error() or good(). Checked reads never throw, which
+	 * makes this mode usable with <tt>-fno-exceptions</tt>.
+	 *
+	 * Bounded buffers, such as SpanReader, implement the following methods and are checked against their
+	 * own length. For any other buffer, the input length must be given to the Unpacker constructor.
+	 * @code
+	 *  size_t remaining() const noexcept;
+	 *  void skip(size_t length) noexcept;
+	 * @endcode
+	 *
+	 * @tparam Buffer   the buffer type to read data from
+	 * @tparam Policy   the PackingPolicy
+	 */
+	template<typename Buffer, typename Policy = PackingPolicy<>>
+	class BasicUnpacker {
 	private:
+		static constexpr boost::endian::order Endianess = Policy::endianess;
+		static constexpr IntegerEncoding Encoding = Policy::encoding;
+		static constexpr Bounds Checking = Policy::checking;
+		static constexpr FloatEncoding Floats = Policy::floats;
+		static constexpr bool RuntimeEndianess = Policy::runtimeEndianess;
+		using Stats = typename Policy::StatsHook;
+
+		/**
+		 * The endianess whose ranges are byte swapped in bulk: the foreign one when the endianess
+		 * is chosen at runtime
+		 */
+		static constexpr boost::endian::order ArrayEndianess = !RuntimeEndianess ? Endianess :
+				boost::endian::order::native == boost::endian::order::little ?
+				boost::endian::order::big : boost::endian::order::little;
+
+		/**
+		 * Whether reading from the buffer can throw
+		 */
+		static constexpr bool NoexceptRead = noexcept(std::declval<Buffer&>().read(
+				std::declval<char*>(), std::declval<size_t>()));
+
+		/**
+		 * A reference to the buffer from which packed data is read
+		 */
 		Buffer& buffer;
 
+		/**
+		 * Whether integers are byte swapped, when the endianess is chosen at runtime
+		 */
+		bool swapping = boost::endian::order::native != boost::endian::order::little;
+
+		/**
+		 * Whether the Unpacker must track the input length itself because the
+		 * buffer does not know it
+		 */
+		static constexpr bool TracksLength = !HasRemainingMethod<Buffer>::value;
+
+		/**
+		 * The number of input bytes that can still be read. Only tracked when
+		 * bounds checking is enabled and the buffer is not bounded.
+		 */
+		size_t available = std::numeric_limits<size_t>::max();
+
+		/**
+		 * The limits applied to containers read from the input
+		 */
+		Limits limits;
+
+		/**
+		 * The first error that occurred while unpacking
+		 */
+		UnpackError state = UnpackError::None;
+
+		/**
+		 * The number of bytes missing from the input when the first error occurred
+		 */
+		size_t shortfall = 0;
+
+		template<typename, typename>
+		friend class BasicUnpacker;
+
+		/**
+		 * Creates a new Unpacker instance that carries on from where <tt>other</tt> is, with its
+		 * own policy. Used by withEndianess().
+		 */
+		template<typename OtherPolicy>
+		BasicUnpacker(const BasicUnpacker<Buffer, OtherPolicy>& other) :
+				buffer(other.buffer), available(other.available), limits(other.limits),
+				state(other.state), shortfall(other.shortfall) {};
+
 	public:
-		Unpacker(Buffer& buffer) : buffer(buffer) {};
+		/**
+		 * Creates a new Unpacker instance with the given buffer reference. Packed data will be read
+		 * from the given buffer object.
+		 *
+		 * When bounds checking is enabled, the buffer must be bounded.
+		 *
+		 * @param buffer the buffer object to read data from
+		 * @param limits the limits applied to containers read from the input
+		 */
+		BasicUnpacker(Buffer& buffer, const Limits& limits = Limits()) : buffer(buffer), limits(limits) {
+			static_assert(Checking == Bounds::Unchecked || !TracksLength,
+						  "A bounds checked Unpacker requires a bounded buffer or the input length to be "
+								  "given to the constructor.");
+		};
+
+		/**
+		 * Creates a new Unpacker instance that reads at most <tt>length</tt> bytes from the given
+		 * buffer reference. Only available for buffers that are not bounded.
+		 *
+		 * @param buffer the buffer object to read data from
+		 * @param length the number of bytes available in the buffer
+		 * @param limits the limits applied to containers read from the input
+		 */
+		template<typename B = Buffer, typename = typename std::enable_if<!HasRemainingMethod<B>::value>::type>
+		BasicUnpacker(B& buffer, size_t length, const Limits& limits = Limits()) :
+				buffer(buffer), available(length), limits(limits) {};
 
 		/**
 		 * Deleted copy constructor.
 		 */
-		Unpacker(const Unpacker& other) = delete;
+		BasicUnpacker(const BasicUnpacker& other) = delete;
 
 		/**
 		 * Deleted copy assignment operator.
 		 */
-		Unpacker& operator=(const Unpacker& other) = delete;
+		BasicUnpacker& operator=(const BasicUnpacker& other) = delete;
 
 		/**
 		 * Deleted move constructor.
 		 */
-		Unpacker(Unpacker&& other) = delete;
+		BasicUnpacker(BasicUnpacker&& other) = delete;
 
 		/**
 		 * Deleted move assignment operator.
 		 */
-		Unpacker& operator=(Unpacker&& other) = delete;
+		BasicUnpacker& operator=(BasicUnpacker&& other) = delete;
 
 		/**
 		 * Default destructor.
 		 */
-		~Unpacker() = default;
+		~BasicUnpacker() = default;
+
+	public: // Error state
+		/**
+		 * @return the first error that occurred while unpacking
+		 */
+		UnpackError error() const noexcept {
+			return state;
+		}
+
+		/**
+		 * @return true if no error has occurred while unpacking
+		 */
+		bool good() const noexcept {
+			return state == UnpackError::None;
+		}
+
+		/**
+		 * @return true if no error has occurred while unpacking
+		 */
+		explicit operator bool() const noexcept {
+			return good();
+		}
+
+		/**
+		 * @return the number of input bytes that can still be read, or the maximum <tt>size_t</tt>
+		 * value if the input length is not known
+		 */
+		size_t remaining() const noexcept {
+			if(Checking == Bounds::Unchecked && TracksLength) {
+				return std::numeric_limits<size_t>::max();
+			}
+			return remainingIn(buffer, available);
+		}
+
+		/**
+		 * @return the minimum number of bytes that were missing from the input when the Unpacker
+		 * failed with UnpackError::Truncated or UnpackError::LengthTooLarge, and zero otherwise
+		 */
+		size_t missing() const noexcept {
+			return shortfall;
+		}
+
+		/**
+		 * @return the limits applied to containers read from the input, including what is left of
+		 * the allocation budget
+		 */
+		const Limits& getLimits() const noexcept {
+			return limits;
+		}
+
+		/**
+		 * Puts the Unpacker in a failed state. Only the first error is recorded and, when bounds
+		 * checking is enabled, all further reads fail.
+		 *
+		 * This is meant to be called by ObjectSerializer implementations that detect invalid input.
+		 *
+		 * @param error the error that occurred
+		 */
+		void fail(UnpackError error) noexcept {
+			if(state == UnpackError::None) {
+				state = error;
+				Stats::failed(error);
+			}
+			discard(buffer);
+		}
+
+		/**
+		 * Validates a container length read from the input before any memory is reserved for it.
+		 *
+		 * A length fails the Unpacker with UnpackError::LengthTooLarge if its elements could not
+		 * possibly fit in the remaining input (when its length is known), or with
+		 * UnpackError::LimitExceeded if it goes over the Limits given to the Unpacker. Accepted
+		 * lengths are charged against the allocation budget.
+		 *
+		 * Every container serializer must call this method once, before reserving memory.
+		 *
+		 * @tparam Container    the container type
+		 * @param container     the container being unpacked
+		 * @param items         the number of elements read from the input
+		 *
+		 * @return true if the length is acceptable
+		 */
+		template<typename Container>
+		bool checkLength(const Container& container, uint64_t items) noexcept {
+			return fitsInput<typename Container::value_type>(items) && checkLimits(container, items);
+		}
+
+		/**
+		 * Validates a container length read from the input for a container whose elements are
+		 * streamed one at a time instead of stored, such as by an ElementStream. The length fails
+		 * the Unpacker like with checkLength(), except that it is not charged against the
+		 * allocation budget.
+		 *
+		 * @tparam Container    the container type
+		 * @param items         the number of elements read from the input
+		 *
+		 * @return true if the length is acceptable
+		 */
+		template<typename Container>
+		bool checkStreamedLength(uint64_t items) noexcept {
+			if(!fitsInput<typename Container::value_type>(items)) {
+				return false;
+			}
+			if(items > limits.maxElements) {
+				fail(UnpackError::LimitExceeded);
+				return false;
+			}
+			return true;
+		}
+
+		/**
+		 * Validates a container length read from the input against the Limits given to the
+		 * Unpacker only, for containers whose elements are not expected to be in the remaining
+		 * input yet. The length fails the Unpacker with UnpackError::LimitExceeded if it goes over
+		 * the limits, and is charged against the allocation budget otherwise.
+		 *
+		 * checkLength() performs this check after validating the length against the input.
+		 *
+		 * @tparam Container    the container type
+		 * @param container     the container being unpacked
+		 * @param items         the number of elements read from the input
+		 *
+		 * @return true if the length is acceptable
+		 */
+		template<typename Container>
+		bool checkLimits(const Container&, uint64_t items) noexcept {
+			using T = typename Container::value_type;
+
+			if(items > std::numeric_limits<size_t>::max()) {
+				fail(UnpackError::Overflow);
+				return false;
+			}
+			if(items > limits.maxElements || items > limits.allocationBudget / sizeof(T)) {
+				fail(UnpackError::LimitExceeded);
+				return false;
+			}
+			limits.allocationBudget -= static_cast<size_t>(items) * sizeof(T);
+			return true;
+		}
+
+	public: // Endianess
+		/**
+		 * @return the endianess used to decode integer types
+		 */
+		boost::endian::order getEndianess() const noexcept {
+			if(!RuntimeEndianess) {
+				return Endianess;
+			}
+			return swapping == (boost::endian::order::native == boost::endian::order::little) ?
+				   boost::endian::order::big : boost::endian::order::little;
+		}
+
+		/**
+		 * Sets the endianess used to decode integer types. Only available when the policy chooses
+		 * the endianess at runtime, such as RuntimeEndianPolicy.
+		 *
+		 * @param endianess the endianess used to decode integer types
+		 */
+		void setEndianess(boost::endian::order endianess) noexcept {
+			static_assert(RuntimeEndianess, "The endianess of this policy is fixed at compile time");
+			swapping = endianess != boost::endian::order::native;
+		}
+
+		/**
+		 * Calls <tt>function</tt> with an unpacker that reads on from the same position with the
+		 * current endianess fixed at compile time. With RuntimeEndianPolicy, the byte order is
+		 * tested once here instead of on every unpacked integer. The function is instantiated once
+		 * per byte order, so it must accept any unpacker:
+		 *
+		 * @code
+		 *  unpacker.withEndianess([&](auto& unpacker) {
+		 *      for(Sample& sample : samples) {
+		 *          unpacker(sample.time, sample.value);
+		 *      }
+		 *  });
+		 * @endcode
+		 *
+		 * The position, the error state and what is left of the allocation budget carry back to
+		 * this unpacker when the function returns. With any other policy, the function is called
+		 * with this unpacker.
+		 *
+		 * @tparam Function the function type
+		 * @param function  the function to call with the unpacker
+		 */
+		template<typename Function>
+		void withEndianess(Function&& function) {
+			withEndianess(std::forward<Function>(function), std::integral_constant<bool, RuntimeEndianess>());
+		}
 
 	public: // Helper methods
 		/**
@@ -79,7 +429,7 @@ namespace PacketBuffer {
 		 * @return this
 		 */
 		template<typename T>
-		Unpacker& operator&(T& v) {
+		BasicUnpacker& operator&(T& v) {
 			return unpack(v);
 		}
 
@@ -93,7 +443,7 @@ namespace PacketBuffer {
 		 * @return this
 		 */
 		template<typename T>
-		Unpacker& operator>>(T& v) {
+		BasicUnpacker& operator>>(T& v) {
 			return unpack(v);
 		}
 
@@ -106,7 +456,7 @@ namespace PacketBuffer {
 		 * @return this
 		 */
 		template<typename... Ts>
-		Unpacker& operator()(Ts& ... vs) {
+		BasicUnpacker& operator()(Ts& ... vs) {
 			return unpack(vs...);
 		}
 
@@ -138,7 +488,7 @@ namespace PacketBuffer {
 		 * @return this
 		 */
 		template<typename T, typename... Ts>
-		Unpacker& unpack(T& v, Ts& ... vs) {
+		BasicUnpacker& unpack(T& v, Ts& ... vs) {
 			unpack(v);
 			unpack(vs...);
 			return *this;
@@ -153,17 +503,43 @@ namespace PacketBuffer {
 		 * @return this
 		 */
 		template<typename T>
-		Unpacker& unpack(T& object) {
+		BasicUnpacker& unpack(T& object) {
 			ObjectSerializer<T>::unpack(*this, object);
 			return *this;
 		}
 
+		/**
+		 * Unpacks a contiguous range of <tt>count</tt> objects of type <tt>T</tt>.
+		 *
+		 * If <tt>T</tt> is bitwise packable and its packed representation does not depend on
+		 * endianess (or the Unpacker endianess is native), the whole range is read with a single
+		 * read. Arithmetic types of 2, 4 and 8 bytes in foreign endianess are byte swapped in bulk,
+		 * straight from contiguous buffers (such as SpanReader) and in place after being read
+		 * otherwise. With IntegerEncoding::Varint, <tt>uint32_t</tt> ranges are unpacked from
+		 * StreamVByte blocks with SIMD kernels. Otherwise, each object is unpacked individually.
+		 *
+		 * @tparam T        the type of the objects to be unpacked
+		 * @param values    the first object to unpack to
+		 * @param count     the number of objects to be unpacked
+		 *
+		 * @return this
+		 */
+		template<typename T>
+		inline BasicUnpacker& unpackArray(T* values, size_t count) {
+			// an empty range may start at a null pointer (e.g. an empty std::vector), which
+			// must never reach the buffer's memcpy.
+			if(count == 0) {
+				return *this;
+			}
+			return unpackArray(values, count, ArrayLayoutOf<T, ArrayEndianess, Encoding, Floats>());
+		}
+
 		/**
 		 * A unpacker method that does not unpack anything.
 		 *
 		 * @return this
 		 */
-		inline Unpacker& unpack() {
+		inline BasicUnpacker& unpack() {
 			return *this;
 		}
 
@@ -175,10 +551,10 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		Unpacker& unpack(uint8_t& i) {
+		BasicUnpacker& unpack(uint8_t& i) noexcept(NoexceptRead) {
 			static_assert(sizeof(i) == 1, "uint8_t size must be 1 byte");
 			unpack(reinterpret_cast<char*>(&i), sizeof(i));
-			boost::endian::conditional_reverse_inplace<Endianess, boost::endian::order::native>(i);
+			fromWire(i);
 			return *this;
 		}
 
@@ -189,10 +565,10 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		Unpacker& unpack(int8_t& i) {
+		BasicUnpacker& unpack(int8_t& i) noexcept(NoexceptRead) {
 			static_assert(sizeof(i) == 1, "int8_t size must be 1 byte");
 			unpack(reinterpret_cast<char*>(&i), sizeof(i));
-			boost::endian::conditional_reverse_inplace<Endianess, boost::endian::order::native>(i);
+			fromWire(i);
 			return *this;
 		}
 
@@ -203,10 +579,13 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		Unpacker& unpack(uint16_t& i) {
+		BasicUnpacker& unpack(uint16_t& i) noexcept(NoexceptRead) {
 			static_assert(sizeof(i) == 2, "uint16_t size must be 2 byte2");
+			if(Encoding == IntegerEncoding::Varint) {
+				return unpackVarintAs(i);
+			}
 			unpack(reinterpret_cast<char*>(&i), sizeof(i));
-			boost::endian::conditional_reverse_inplace<Endianess, boost::endian::order::native>(i);
+			fromWire(i);
 			return *this;
 		}
 
@@ -217,10 +596,13 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		Unpacker& unpack(int16_t& i) {
+		BasicUnpacker& unpack(int16_t& i) noexcept(NoexceptRead) {
 			static_assert(sizeof(i) == 2, "int16_t size must be 2 byte2");
+			if(Encoding == IntegerEncoding::Varint) {
+				return unpackVarintAs(i);
+			}
 			unpack(reinterpret_cast<char*>(&i), sizeof(i));
-			boost::endian::conditional_reverse_inplace<Endianess, boost::endian::order::native>(i);
+			fromWire(i);
 			return *this;
 		}
 
@@ -231,10 +613,13 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		Unpacker& unpack(uint32_t& i) {
+		BasicUnpacker& unpack(uint32_t& i) noexcept(NoexceptRead) {
 			static_assert(sizeof(i) == 4, "uint32_t size must be 4 bytes");
+			if(Encoding == IntegerEncoding::Varint) {
+				return unpackVarintAs(i);
+			}
 			unpack(reinterpret_cast<char*>(&i), sizeof(i));
-			boost::endian::conditional_reverse_inplace<Endianess, boost::endian::order::native>(i);
+			fromWire(i);
 			return *this;
 		}
 
@@ -245,10 +630,13 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		Unpacker& unpack(int32_t& i) {
+		BasicUnpacker& unpack(int32_t& i) noexcept(NoexceptRead) {
 			static_assert(sizeof(i) == 4, "int32_t size must be 4 bytes");
+			if(Encoding == IntegerEncoding::Varint) {
+				return unpackVarintAs(i);
+			}
 			unpack(reinterpret_cast<char*>(&i), sizeof(i));
-			boost::endian::conditional_reverse_inplace<Endianess, boost::endian::order::native>(i);
+			fromWire(i);
 			return *this;
 		}
 
@@ -259,10 +647,13 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		Unpacker& unpack(uint64_t& i) {
+		BasicUnpacker& unpack(uint64_t& i) noexcept(NoexceptRead) {
 			static_assert(sizeof(i) == 8, "uint64_t size must be 8 bytes");
+			if(Encoding == IntegerEncoding::Varint) {
+				return unpackVarintAs(i);
+			}
 			unpack(reinterpret_cast<char*>(&i), sizeof(i));
-			boost::endian::conditional_reverse_inplace<Endianess, boost::endian::order::native>(i);
+			fromWire(i);
 			return *this;
 		}
 
@@ -273,10 +664,13 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		Unpacker& unpack(int64_t& i) {
+		BasicUnpacker& unpack(int64_t& i) noexcept(NoexceptRead) {
 			static_assert(sizeof(i) == 8, "int64_t size must be 8 bytes");
+			if(Encoding == IntegerEncoding::Varint) {
+				return unpackVarintAs(i);
+			}
 			unpack(reinterpret_cast<char*>(&i), sizeof(i));
-			boost::endian::conditional_reverse_inplace<Endianess, boost::endian::order::native>(i);
+			fromWire(i);
 			return *this;
 		}
 
@@ -287,7 +681,7 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		Unpacker& unpack(bool& b) {
+		BasicUnpacker& unpack(bool& b) noexcept(NoexceptRead) {
 			static_assert(sizeof(b) == 1, "bool size must be 1 byte");
 			unpack(reinterpret_cast<char*>(&b), sizeof(b));
 			return *this;
@@ -300,26 +694,86 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		Unpacker& unpack(float& f) {
+		BasicUnpacker& unpack(float& f) noexcept(NoexceptRead) {
 			static_assert(sizeof(f) == 4, "float size must be 4 bytes");
-			unpack(reinterpret_cast<char*>(&f), sizeof(f));
+			uint32_t i;
+			unpack(reinterpret_cast<char*>(&i), sizeof(i));
+			fromWire(i);
+			std::memcpy(&f, &i, sizeof(f));
 			return *this;
 		}
 
 		/**
-		 * Unpacks a double value.
+		 * Unpacks a double value. With FloatEncoding::Single, the value is unpacked from a float.
 		 *
 		 * @param d the double value to unpack
 		 *
 		 * @return this
 		 */
-		Unpacker& unpack(double& d) {
+		BasicUnpacker& unpack(double& d) noexcept(NoexceptRead) {
 			static_assert(sizeof(d) == 8, "double size must be 8 bytes");
-			unpack(reinterpret_cast<char*>(&d), sizeof(d));
+			if(Floats == FloatEncoding::Single) {
+				float f;
+				unpack(f);
+				d = f;
+				return *this;
+			}
+			uint64_t i;
+			unpack(reinterpret_cast<char*>(&i), sizeof(i));
+			fromWire(i);
+			std::memcpy(&d, &i, sizeof(d));
+			return *this;
+		}
+
+	public: // Variable length integers
+		/**
+		 * Unpacks a container length. Depending on the Unpacker encoding, the length is unpacked
+		 * from a fixed size uint64_t or from a varint.
+		 *
+		 * Container serializers must unpack their length with this method.
+		 *
+		 * @param length the container length
+		 *
+		 * @return this
+		 */
+		inline BasicUnpacker& unpackLength(uint64_t& length) noexcept(NoexceptRead) {
+			if(Encoding == IntegerEncoding::Fixed) {
+				return unpack(length);
+			}
+			return unpackVarint(length);
+		}
+
+		/**
+		 * Unpacks a integer value from a LEB128 varint.
+		 *
+		 * A varint longer than 10 bytes, or whose value does not fit in 64 bits, fails the Unpacker
+		 * with UnpackError::Overflow and unpacks as zero.
+		 *
+		 * @param value the integer value to unpack
+		 *
+		 * @return this
+		 */
+		inline BasicUnpacker& unpackVarint(uint64_t& value) noexcept(NoexceptRead) {
+			value = 0;
+			for(unsigned int shift = 0; shift < 64; shift += 7) {
+				char byte = 0;
+				unpack(&byte, 1);
+
+				const uint64_t bits = static_cast<unsigned char>(byte) & 0x7F;
+				if(shift == 63 && bits > 1) {
+					break;
+				}
+				value |= bits << shift;
+				if((byte & 0x80) == 0) {
+					return *this;
+				}
+			}
+			value = 0;
+			fail(UnpackError::Overflow);
 			return *this;
 		}
 
-	public: // write operation
+	public: // read operation
 		/**
 		 * Unpacks a char-pointer given by <tt>ptr</tt> with length given by <tt>size</tt>.
 		 *
@@ -328,8 +782,18 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		Unpacker& unpack(char* ptr, size_t size) {
+		inline BasicUnpacker& unpack(char* ptr, size_t size) noexcept(NoexceptRead) {
+			if(Checking == Bounds::Checked) {
+				if(BOOST_UNLIKELY(size > remainingIn(buffer, available))) {
+					truncate(ptr, size);
+					return *this;
+				}
+				if(TracksLength) {
+					available -= size;
+				}
+			}
 			buffer.read(ptr, size);
+			Stats::unpacked(size);
 			return *this;
 		}
 
@@ -341,13 +805,329 @@ namespace PacketBuffer {
 		 *
 		 * @return this
 		 */
-		Unpacker& unpack(unsigned char* ptr, size_t size) {
-			buffer.read(ptr, size);
+		inline BasicUnpacker& unpack(unsigned char* ptr, size_t size) noexcept(NoexceptRead) {
+			return unpack(reinterpret_cast<char*>(ptr), size);
+		}
+
+		/**
+		 * Borrows <tt>size</tt> bytes from the input without copying them. The returned pointer
+		 * points into the input and is only valid as long as the input memory is.
+		 *
+		 * Only available for contiguous buffers, which implement the following methods:
+		 * @code
+		 *  const char* data() const noexcept;
+		 *  size_t remaining() const noexcept;
+		 *  void skip(size_t length) noexcept;
+		 * @endcode
+		 *
+		 * The size is checked against the remaining input whether or not bounds checking is
+		 * enabled: the borrowed bytes are read later, through a view, where they can no longer be
+		 * checked. Borrowing past the end fails the Unpacker with UnpackError::Truncated.
+		 *
+		 * @param size the number of bytes to borrow
+		 *
+		 * @return the first borrowed byte, or nullptr if the read failed
+		 */
+		inline const char* borrow(size_t size) noexcept {
+			static_assert(HasDataMethod<Buffer>::value && HasRemainingMethod<Buffer>::value,
+						  "Borrowing from the input requires a contiguous buffer, such as SpanReader.");
+			if(BOOST_UNLIKELY(size > buffer.remaining())) {
+				if(state == UnpackError::None) {
+					shortfall = size - buffer.remaining();
+				}
+				fail(UnpackError::Truncated);
+				return nullptr;
+			}
+			const char* data = buffer.data();
+			buffer.skip(size);
+			Stats::unpacked(size);
+			return data;
+		}
+
+		/**
+		 * Checks that borrowed input can be decoded by a view fixed to the <tt>E</tt> endianess and
+		 * the <tt>Enc</tt> integer encoding. A mismatch does not compile, except for an endianess
+		 * chosen at runtime, which fails the Unpacker with UnpackError::EndianessMismatch.
+		 *
+		 * A view of elements of type <tt>T</tt> expects each element to take its MaxPackedSize.
+		 * When FloatEncoding::Single packs the doubles of <tt>T</tt> in fewer bytes, the Unpacker
+		 * fails with UnpackError::FloatEncodingMismatch.
+		 *
+		 * @tparam E    the endianess of the view
+		 * @tparam Enc  the integer encoding of the view
+		 * @tparam T    the element type of the view, or void if its items have no fixed size
+		 *
+		 * @return whether the view can decode the input
+		 */
+		template<boost::endian::order E, IntegerEncoding Enc, typename T = void>
+		inline bool expectFormat() {
+			static_assert(Enc == Encoding, "The view must use the integer encoding of the Unpacker.");
+			static_assert(RuntimeEndianess || E == Endianess, "The view must use the endianess of the Unpacker.");
+			if(RuntimeEndianess && BOOST_UNLIKELY(getEndianess() != E)) {
+				fail(UnpackError::EndianessMismatch);
+				return false;
+			}
+			if(BOOST_UNLIKELY(!keepsPackedSize<T>(std::is_void<T>()))) {
+				fail(UnpackError::FloatEncodingMismatch);
+				return false;
+			}
+			return true;
+		}
+
+	private:
+		/**
+		 * Checks that <tt>items</tt> elements of type <tt>T</tt> could fit in the remaining input,
+		 * when its length is known.
+		 */
+		template<typename T>
+		bool fitsInput(uint64_t items) noexcept {
+			if(items > std::numeric_limits<size_t>::max()) {
+				fail(UnpackError::Overflow);
+				return false;
+			}
+			/*
+			 * With varints every integer shrinks to a single byte, so only one byte per element can
+			 * be taken for granted. With single precision floats, a double shrinks to 4 bytes, and a
+			 * structure that may hold doubles to an unknown size.
+			 */
+			constexpr size_t exact = MinimumPackedSize<T>::value;
+			constexpr size_t fixed = Floats == FloatEncoding::Exact || exact <= 1 ? exact :
+									 std::is_same<T, double>::value ? sizeof(float) :
+									 std::is_arithmetic<T>::value || std::is_enum<T>::value ? exact : 1;
+			constexpr size_t minimum = Encoding == IntegerEncoding::Varint ? (fixed != 0 ? 1 : 0) : fixed;
+			if(minimum != 0 && items > remaining() / minimum) {
+				if(state == UnpackError::None) {
+					shortfall = items > std::numeric_limits<size_t>::max() / minimum ?
+								std::numeric_limits<size_t>::max() : static_cast<size_t>(items) * minimum - remaining();
+				}
+				fail(UnpackError::LengthTooLarge);
+				return false;
+			}
+			return true;
+		}
+
+		/**
+		 * @return whether a value of type <tt>T</tt> takes its MaxPackedSize with the float
+		 * encoding of the policy. Only FloatEncoding::Single can shrink it, by packing doubles as
+		 * floats.
+		 */
+		template<typename T>
+		static bool keepsPackedSize(std::false_type) {
+			return Floats == FloatEncoding::Exact || packedSize<Policy>(T()) == MaxPackedSize<T, Encoding>::value;
+		}
+
+		template<typename T>
+		static constexpr bool keepsPackedSize(std::true_type) noexcept {
+			return true;
+		}
+
+		template<typename Function>
+		void withEndianess(Function&& function, std::false_type) {
+			function(*this);
+		}
+
+		template<typename Function>
+		void withEndianess(Function&& function, std::true_type) {
+			if(swapping) {
+				withPolicy<FixedEndianPolicy<Policy, ArrayEndianess>>(function);
+			} else {
+				withPolicy<FixedEndianPolicy<Policy, boost::endian::order::native>>(function);
+			}
+		}
+
+		template<typename FixedPolicy, typename Function>
+		void withPolicy(Function& function) {
+			BasicUnpacker<Buffer, FixedPolicy> unpacker(*this);
+			function(unpacker);
+			available = unpacker.available;
+			limits = unpacker.limits;
+			state = unpacker.state;
+			shortfall = unpacker.shortfall;
+		}
+
+		/**
+		 * Converts <tt>i</tt> from the packed endianess to the native one.
+		 */
+		template<typename T>
+		inline void fromWire(T& i) const noexcept {
+			boost::endian::conditional_reverse_inplace<Endianess, boost::endian::order::native>(i);
+			if(RuntimeEndianess && swapping) {
+				boost::endian::endian_reverse_inplace(i);
+			}
+		}
+
+		template<typename T>
+		inline BasicUnpacker& unpackArray(T* values, size_t count,
+									 std::integral_constant<ArrayLayout, ArrayLayout::Bitwise>) {
+			static_assert(std::is_trivially_copyable<T>::value, "bitwise packable types must be trivially copyable");
+			return unpack(reinterpret_cast<char*>(values), count * sizeof(T));
+		}
+
+		template<typename T>
+		inline BasicUnpacker& unpackArray(T* values, size_t count,
+									 std::integral_constant<ArrayLayout, ArrayLayout::ByteSwapped>) {
+			char* bytes = reinterpret_cast<char*>(values);
+			if(RuntimeEndianess && !swapping) {
+				return unpack(bytes, count * sizeof(T));
+			}
+			return unpackSwapped<sizeof(T)>(bytes, count, std::integral_constant<bool,
+					HasDataMethod<Buffer>::value && HasRemainingMethod<Buffer>::value>());
+		}
+
+		/**
+		 * Byte swaps <tt>count</tt> elements of <tt>Width</tt> bytes straight from a contiguous
+		 * input, so that each byte is only touched once.
+		 */
+		template<size_t Width>
+		inline BasicUnpacker& unpackSwapped(char* bytes, size_t count, std::true_type) noexcept {
+			const size_t size = count * Width;
+			if(Checking == Bounds::Checked && BOOST_UNLIKELY(size > buffer.remaining())) {
+				truncate(bytes, size);
+				return *this;
+			}
+			ByteSwap::reverse<Width>(bytes, buffer.data(), count);
+			buffer.skip(size);
+			Stats::unpacked(size);
+			return *this;
+		}
+
+		/**
+		 * Reads <tt>count</tt> elements of <tt>Width</tt> bytes with a single read and byte swaps
+		 * them in place.
+		 */
+		template<size_t Width>
+		inline BasicUnpacker& unpackSwapped(char* bytes, size_t count, std::false_type) noexcept(NoexceptRead) {
+			unpack(bytes, count * Width);
+			ByteSwap::reverse<Width>(bytes, bytes, count);
+			return *this;
+		}
+
+		template<typename T>
+		inline BasicUnpacker& unpackArray(T* values, size_t count,
+									 std::integral_constant<ArrayLayout, ArrayLayout::StreamVByte>) {
+			char control[StreamVByte::controlLength(StreamVByte::BlockLength)];
+			char data[StreamVByte::BlockLength * sizeof(uint32_t) + StreamVByte::Padding];
+			while(count != 0) {
+				size_t items = std::min(count, StreamVByte::BlockLength);
+				unpack(control, StreamVByte::controlLength(items));
+				unpack(data, StreamVByte::dataLength(control, items));
+				StreamVByte::decode(values, items, control, data);
+				values += items;
+				count -= items;
+			}
+			return *this;
+		}
+
+		template<typename T>
+		inline BasicUnpacker& unpackArray(T* values, size_t count,
+									 std::integral_constant<ArrayLayout, ArrayLayout::ElementWise>) {
+			for(size_t i = 0; i < count; i++) {
+				unpack(values[i]);
+			}
 			return *this;
 		}
 
+		/**
+		 * Unpacks a varint into a integer of type <tt>T</tt>. Signed integers are ZigZag decoded.
+		 * Values out of the range of <tt>T</tt> fail the Unpacker with UnpackError::Overflow.
+		 *
+		 * @tparam T    the integer type
+		 * @param i     the integer value to unpack
+		 *
+		 * @return this
+		 */
+		template<typename T>
+		inline BasicUnpacker& unpackVarintAs(T& i) noexcept(NoexceptRead) {
+			uint64_t value;
+			unpackVarint(value);
+			if(std::is_signed<T>::value) {
+				const int64_t decoded = Varint::unzigzag(value);
+				if(decoded < std::numeric_limits<T>::min() || decoded > std::numeric_limits<T>::max()) {
+					i = 0;
+					fail(UnpackError::Overflow);
+					return *this;
+				}
+				i = static_cast<T>(decoded);
+			} else {
+				if(value > std::numeric_limits<T>::max()) {
+					i = 0;
+					fail(UnpackError::Overflow);
+					return *this;
+				}
+				i = static_cast<T>(value);
+			}
+			return *this;
+		}
+
+		/**
+		 * Fails a read that would go past the end of the input.
+		 *
+		 * @param ptr   the destination of the failed read
+		 * @param size  the destination length
+		 */
+		inline void truncate(char* ptr, size_t size) noexcept {
+			if(state == UnpackError::None) {
+				shortfall = size - remainingIn(buffer, available);
+			}
+			std::memset(ptr, 0, size);
+			fail(UnpackError::Truncated);
+		}
+
+		/**
+		 * @return the number of bytes that can still be read from a bounded buffer
+		 */
+		template<typename B>
+		static inline typename std::enable_if<HasRemainingMethod<B>::value, size_t>::type
+		remainingIn(const B& buffer, size_t) noexcept {
+			return buffer.remaining();
+		}
+
+		/**
+		 * @return the number of bytes that can still be read from a buffer that is not bounded
+		 */
+		template<typename B>
+		static inline typename std::enable_if<!HasRemainingMethod<B>::value, size_t>::type
+		remainingIn(const B&, size_t available) noexcept {
+			return available;
+		}
+
+		/**
+		 * Discards the remaining input of a bounded buffer.
+		 */
+		template<typename B>
+		inline typename std::enable_if<HasRemainingMethod<B>::value>::type discard(B& buffer) noexcept {
+			if(Checking == Bounds::Checked) {
+				buffer.skip(buffer.remaining());
+			}
+		}
+
+		/**
+		 * Discards the remaining input of a buffer that is not bounded.
+		 */
+		template<typename B>
+		inline typename std::enable_if<!HasRemainingMethod<B>::value>::type discard(B&) noexcept {
+			available = 0;
+		}
+
 	};
 
+	/**
+	 * A BasicUnpacker decoding integers with <tt>Endianess</tt> and <tt>Encoding</tt>, and floating
+	 * point values exactly.
+	 *
+	 * Setting "Encoding" to a varint IntegerEncoding decodes container lengths, and optionally every
+	 * integer, from LEB128 varints. It must match the encoding of the Packer. The parameters come in
+	 * the same order as those of Packer and PackingPolicy.
+	 *
+	 * @tparam Buffer       the buffer type to read data from
+	 * @tparam Endianess    the endianess used to decode integer types
+	 * @tparam Encoding     the encoding used for integer types and container lengths
+	 * @tparam Checking     whether reads are checked against the input length
+	 */
+	template<typename Buffer, boost::endian::order Endianess = boost::endian::order::little,
+			IntegerEncoding Encoding = IntegerEncoding::Fixed, Bounds Checking = Bounds::Unchecked>
+	using Unpacker = BasicUnpacker<Buffer, PackingPolicy<Endianess, Encoding, Checking>>;
+
 }
 
 
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_VARINT_H
+#define PACKETBUFFER_VARINT_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace PacketBuffer {
+
+	/**
+	 * Selects how a Packer and Unpacker encode integers.
+	 */
+	enum class IntegerEncoding {
+		/**
+		 * Integers are encoded with their fixed size and container lengths
+		 * as 8 byte <tt>uint64_t</tt>
+		 */
+		Fixed,
+
+		/**
+		 * Container lengths are encoded as LEB128 varints, every other
+		 * integer with its fixed size
+		 */
+		VarintLength,
+
+		/**
+		 * Container lengths and every integer wider than one byte are encoded
+		 * as LEB128 varints. Signed integers are ZigZag encoded first, so that
+		 * small negative values stay short. Contiguous ranges of
+		 * <tt>uint32_t</tt> are encoded in the StreamVByte format instead,
+		 * which decodes much faster.
+		 */
+		Varint
+	};
+
+	/**
+	 * LEB128 variable length integer encoding.
+	 *
+	 * Values are split in groups of 7 bits, least significant group first.
+	 * Every byte but the last has its most significant bit set. A value
+	 * below 128 takes a single byte and a 64-bit value takes at most 10.
+	 */
+	namespace Varint {
+
+		/**
+		 * The maximum number of bytes of an encoded 64-bit value
+		 */
+		constexpr size_t MaxLength = 10;
+
+		/**
+		 * Encodes <tt>value</tt> into <tt>output</tt>, which must have room
+		 * for at least MaxLength bytes.
+		 *
+		 * @param value     the value to be encoded
+		 * @param output    the encoded bytes
+		 *
+		 * @return the number of bytes written to <tt>output</tt>
+		 */
+		inline size_t encode(uint64_t value, char* output) noexcept {
+			size_t length = 0;
+			while(value >= 0x80) {
+				output[length++] = static_cast<char>(value | 0x80);
+				value >>= 7;
+			}
+			output[length++] = static_cast<char>(value);
+			return length;
+		}
+
+		/**
+		 * @return the number of bytes <tt>value</tt> takes once encoded
+		 */
+		inline size_t length(uint64_t value) noexcept {
+			size_t length = 1;
+			while(value >= 0x80) {
+				value >>= 7;
+				length++;
+			}
+			return length;
+		}
+
+		/**
+		 * Maps a signed value to an unsigned one so that values of small
+		 * magnitude stay small: 0, -1, 1, -2, 2... become 0, 1, 2, 3, 4...
+		 *
+		 * @param value the signed value
+		 *
+		 * @return the ZigZag encoded value
+		 */
+		inline uint64_t zigzag(int64_t value) noexcept {
+			return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+		}
+
+		/**
+		 * Reverts zigzag().
+		 *
+		 * @param value the ZigZag encoded value
+		 *
+		 * @return the signed value
+		 */
+		inline int64_t unzigzag(uint64_t value) noexcept {
+			return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+		}
+
+	}
+
+}
+
+#endif //PACKETBUFFER_VARINT_H
@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PACKETBUFFER_VIEW_H
+#define PACKETBUFFER_VIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace PacketBuffer {
+
+	/**
+	 * A read-only view of a sequence of characters owned by someone else.
+	 *
+	 * A StringView is packed exactly like a std::string. When unpacked by an
+	 * Unpacker on a contiguous buffer, such as SpanReader, it points into the
+	 * input instead of copying it, so it is only valid as long as the input
+	 * memory is.
+	 *
+	 * @code
+	 *  struct Envelope {
+	 *      StringView topic;
+	 *      ByteSpan   payload;
+	 *
+	 *      template<typename Unpacker>
+	 *      void unpack(Unpacker& unpacker) { unpacker(topic, payload); }
+	 *  };
+	 * @endcode
+	 */
+	class StringView {
+	private:
+		/**
+		 * The first character
+		 */
+		const char* first = nullptr;
+
+		/**
+		 * The number of characters
+		 */
+		size_t length = 0;
+
+	public:
+		using value_type = char;
+		using const_iterator = const char*;
+
+		/**
+		 * Creates an empty view.
+		 */
+		constexpr StringView() noexcept = default;
+
+		/**
+		 * Creates a view of <tt>length</tt> characters starting at <tt>data</tt>.
+		 *
+		 * @param data      the first character
+		 * @param length    the number of characters
+		 */
+		constexpr StringView(const char* data, size_t length) noexcept : first(data), length(length) {}
+
+		/**
+		 * Creates a view of a null terminated string.
+		 *
+		 * @param string the null terminated string
+		 */
+		StringView(const char* string) noexcept : first(string), length(std::strlen(string)) {}
+
+		/**
+		 * Creates a view of the characters of a std::basic_string.
+		 *
+		 * @param string the viewed string
+		 */
+		template<typename Traits, typename Allocator>
+		StringView(const std::basic_string<char, Traits, Allocator>& string) noexcept :
+				first(string.data()), length(string.size()) {}
+
+	public:
+		/**
+		 * @return the first character
+		 */
+		constexpr const char* data() const noexcept {
+			return first;
+		}
+
+		/**
+		 * @return the number of characters
+		 */
+		constexpr size_t size() const noexcept {
+			return length;
+		}
+
+		/**
+		 * @return true if the view has no characters
+		 */
+		constexpr bool empty() const noexcept {
+			return length == 0;
+		}
+
+		const_iterator begin() const noexcept {
+			return first;
+		}
+
+		const_iterator end() const noexcept {
+			return first + length;
+		}
+
+		/**
+		 * @return the character at <tt>index</tt>
+		 */
+		constexpr char operator[](size_t index) const noexcept {
+			return first[index];
+		}
+
+		/**
+		 * @return a copy of the viewed characters
+		 */
+		std::string str() const {
+			return std::string(first, length);
+		}
+
+		friend bool operator==(const StringView& lhs, const StringView& rhs) noexcept {
+			return lhs.length == rhs.length && (lhs.length == 0 || std::memcmp(lhs.first, rhs.first, lhs.length) == 0);
+		}
+
+		friend bool operator!=(const StringView& lhs, const StringView& rhs) noexcept {
+			return !(lhs == rhs);
+		}
+	};
+
+	/**
+	 * A read-only view of a sequence of bytes owned by someone else.
+	 *
+	 * A ByteSpan is packed exactly like a std::vector<uint8_t>. When unpacked
+	 * by an Unpacker on a contiguous buffer, such as SpanReader, it points
+	 * into the input instead of copying it, so it is only valid as long as
+	 * the input memory is.
+	 */
+	class ByteSpan {
+	private:
+		/**
+		 * The first byte
+		 */
+		const uint8_t* first = nullptr;
+
+		/**
+		 * The number of bytes
+		 */
+		size_t length = 0;
+
+	public:
+		using value_type = uint8_t;
+		using const_iterator = const uint8_t*;
+
+		/**
+		 * Creates an empty span.
+		 */
+		constexpr ByteSpan() noexcept = default;
+
+		/**
+		 * Creates a span of <tt>length</tt> bytes starting at <tt>data</tt>.
+		 *
+		 * @param data      the first byte
+		 * @param length    the number of bytes
+		 */
+		constexpr ByteSpan(const uint8_t* data, size_t length) noexcept : first(data), length(length) {}
+
+		/**
+		 * Creates a span of <tt>length</tt> bytes starting at <tt>data</tt>.
+		 *
+		 * @param data      the first byte
+		 * @param length    the number of bytes
+		 */
+		ByteSpan(const char* data, size_t length) noexcept :
+				first(reinterpret_cast<const uint8_t*>(data)), length(length) {}
+
+		/**
+		 * Creates a span of the bytes of a std::vector.
+		 *
+		 * @param vector the viewed vector
+		 */
+		template<typename Allocator>
+		ByteSpan(const std::vector<uint8_t, Allocator>& vector) noexcept :
+				first(vector.data()), length(vector.size()) {}
+
+	public:
+		/**
+		 * @return the first byte
+		 */
+		constexpr const uint8_t* data() const noexcept {
+			return first;
+		}
+
+		/**
+		 * @return the number of bytes
+		 */
+		constexpr size_t size() const noexcept {
+			return length;
+		}
+
+		/**
+		 * @return true if the span has no bytes
+		 */
+		constexpr bool empty() const noexcept {
+			return length == 0;
+		}
+
+		const_iterator begin() const noexcept {
+			return first;
+		}
+
+		const_iterator end() const noexcept {
+			return first + length;
+		}
+
+		/**
+		 * @return the byte at <tt>index</tt>
+		 */
+		constexpr uint8_t operator[](size_t index) const noexcept {
+			return first[index];
+		}
+
+		friend bool operator==(const ByteSpan& lhs, const ByteSpan& rhs) noexcept {
+			return lhs.length == rhs.length && (lhs.length == 0 || std::memcmp(lhs.first, rhs.first, lhs.length) == 0);
+		}
+
+		friend bool operator!=(const ByteSpan& lhs, const ByteSpan& rhs) noexcept {
+			return !(lhs == rhs);
+		}
+	};
+
+}
+
+#endif //PACKETBUFFER_VIEW_H
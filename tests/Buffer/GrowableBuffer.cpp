@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+
+#include <PacketBuffer/PacketBuffer.h>
+#include <PacketBuffer/Buffer/HugePageAllocator.h>
+
+TEST_CASE("Buffer/GrowableBuffer", "[buffer][growable-buffer]") {
+
+	SECTION("should grow to fit packed data") {
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>> packer(buffer);
+
+		for(uint32_t i = 0; i < 1000; i++) {
+			packer.pack(i);
+		}
+
+		REQUIRE(buffer.size() == 4000);
+		CHECK(buffer.capacity() >= 4000);
+
+		SECTION("and should unpack back") {
+			PacketBuffer::SpanReader reader(buffer.data(), buffer.size());
+			PacketBuffer::Unpacker<PacketBuffer::SpanReader> unpacker(reader);
+
+			for(uint32_t i = 0; i < 1000; i++) {
+				REQUIRE(unpacker.unpack<uint32_t>() == i);
+			}
+		}
+
+		SECTION("and should keep its memory on reset") {
+			const char* data = buffer.data();
+			size_t capacity = buffer.capacity();
+
+			buffer.reset();
+			packer.pack(uint64_t(1));
+
+			CHECK(buffer.size() == 8);
+			CHECK(buffer.capacity() == capacity);
+			CHECK(buffer.data() == data);
+		}
+	}
+
+	SECTION("should be filled in place") {
+		PacketBuffer::GrowableBuffer<> buffer;
+
+		std::memcpy(buffer.prepare(6), "Hello!", 6);
+		buffer.commit(5);
+		REQUIRE(buffer.size() == 5);
+		CHECK(std::string(buffer.data(), buffer.size()) == "Hello");
+
+		SECTION("and should consume a prefix") {
+			buffer.consume(2);
+
+			CHECK(std::string(buffer.data(), buffer.size()) == "llo");
+		}
+	}
+
+	SECTION("should allocate from an arena") {
+		char storage[1024];
+		PacketBuffer::Arena arena(storage, sizeof(storage));
+
+		using Buffer = PacketBuffer::GrowableBuffer<PacketBuffer::ArenaAllocator<char>>;
+		Buffer buffer(128, arena);
+		PacketBuffer::Packer<Buffer> packer(buffer);
+
+		packer.pack(std::string("Hello Testing World"));
+
+		CHECK(buffer.size() == 27);
+		CHECK(buffer.data() >= storage);
+		CHECK(buffer.data() < storage + sizeof(storage));
+		CHECK(arena.used() == 128);
+
+		SECTION("and should throw when exhausted") {
+			CHECK_THROWS_AS(buffer.reserve(2048), std::bad_alloc);
+		}
+
+		SECTION("and should grow in place") {
+			const char* data = buffer.data();
+			packer.pack(std::string(500, 'x'));
+
+			CHECK(buffer.data() == data);
+			CHECK(arena.used() == buffer.capacity());
+		}
+	}
+
+	SECTION("should ignore empty writes before allocating") {
+		PacketBuffer::GrowableBuffer<> buffer;
+		buffer.write(static_cast<const char*>(nullptr), 0);
+
+		CHECK(buffer.size() == 0);
+		CHECK(buffer.capacity() == 0);
+	}
+
+	SECTION("should allocate from huge pages") {
+		using Buffer = PacketBuffer::GrowableBuffer<PacketBuffer::HugePageAllocator<char>>;
+		const size_t hugePageSize = Buffer::AllocatorType::HugePageSize;
+		Buffer buffer(4096);
+		PacketBuffer::Packer<Buffer> packer(buffer);
+
+		packer.pack(uint32_t(0xCAFEBABE));
+
+		PacketBuffer::SpanReader reader(buffer.data(), buffer.size());
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader> unpacker(reader);
+		CHECK(unpacker.unpack<uint32_t>() == 0xCAFEBABE);
+		CHECK(reinterpret_cast<uintptr_t>(buffer.data()) % hugePageSize == 0);
+		CHECK(buffer.capacity() == hugePageSize);
+
+		SECTION("and should start with a whole huge page") {
+			Buffer empty;
+			PacketBuffer::Packer<Buffer> emptyPacker(empty);
+			emptyPacker.pack(uint8_t(1));
+
+			CHECK(empty.capacity() == hugePageSize);
+		}
+	}
+
+}
\ No newline at end of file
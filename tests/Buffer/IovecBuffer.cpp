@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+#include <sstream>
+
+#include <PacketBuffer/PacketBuffer.h>
+#include <PacketBuffer/Buffer/IovecBuffer.h>
+
+#include <cerrno>
+#include <cstdio>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+	std::string gather(const struct iovec* vectors, size_t count) {
+		std::string output;
+		for(size_t i = 0; i < count; i++) {
+			output.append(static_cast<const char*>(vectors[i].iov_base), vectors[i].iov_len);
+		}
+		return output;
+	}
+}
+
+TEST_CASE("Buffer/IovecBuffer", "[buffer][iovec-buffer]") {
+
+	using Buffer = PacketBuffer::IovecBuffer<>;
+	const std::string payload(64 * 1024, 'P');
+
+	std::stringstream ss;
+	PacketBuffer::Packer<std::ostream> reference(ss);
+	reference.pack(uint32_t(0xCAFEBABE), payload, uint16_t(7));
+
+	Buffer buffer;
+	PacketBuffer::Packer<Buffer> packer(buffer);
+	packer.pack(uint32_t(0xCAFEBABE), payload, uint16_t(7));
+
+	SECTION("should reference large writes") {
+		const struct iovec* vectors = buffer.vectors();
+		REQUIRE(buffer.count() == 3);
+
+		CHECK(vectors[0].iov_len == 12);
+		CHECK(vectors[1].iov_base == payload.data());
+		CHECK(vectors[1].iov_len == payload.size());
+		CHECK(vectors[2].iov_len == 2);
+		CHECK(buffer.size() == ss.str().size());
+	}
+
+	SECTION("should gather the packed data") {
+		CHECK(gather(buffer.vectors(), buffer.count()) == ss.str());
+	}
+
+	SECTION("should be written with writev") {
+		const std::string small = "Hello Testing World";
+		buffer.reset();
+		packer.pack(uint64_t(1), small);
+
+		int fds[2];
+		REQUIRE(pipe(fds) == 0);
+		CHECK(writev(fds[1], buffer.vectors(), static_cast<int>(buffer.count())) == 35);
+
+		char received[35];
+		CHECK(read(fds[0], received, sizeof(received)) == 35);
+		close(fds[0]);
+		close(fds[1]);
+
+		PacketBuffer::SpanReader reader(received, sizeof(received));
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader> unpacker(reader);
+		CHECK(unpacker.unpack<uint64_t>() == 1);
+		CHECK(unpacker.unpack<std::string>() == small);
+	}
+
+	SECTION("should reference large values inside containers") {
+		std::map<uint32_t, std::string> map;
+		map[1] = std::string(20 * 1024, 'M');
+
+		std::stringstream expected;
+		PacketBuffer::Packer<std::ostream>(expected).pack(map);
+
+		buffer.reset();
+		packer.pack(map);
+		const struct iovec* vectors = buffer.vectors();
+		REQUIRE(buffer.count() == 2);
+
+		CHECK(vectors[1].iov_base == map[1].data());
+		CHECK(gather(vectors, buffer.count()) == expected.str());
+	}
+
+	SECTION("should never reference the Packer temporaries") {
+		using BigPacker = PacketBuffer::Packer<Buffer, boost::endian::order::big>;
+		std::vector<uint32_t> values(10000, 0x01020304);
+
+		Buffer small(1);
+		BigPacker big(small);
+		big.pack(values);
+
+		CHECK(small.count() == 1);
+		CHECK(small.size() == 8 + values.size() * 4);
+	}
+
+	SECTION("should write more vectors than IOV_MAX") {
+		std::vector<std::string> values(600, std::string(Buffer::MinimumThreshold, 'V'));
+		std::stringstream expected;
+		PacketBuffer::Packer<std::ostream>(expected).pack(values);
+
+		Buffer many(Buffer::MinimumThreshold);
+		PacketBuffer::Packer<Buffer>(many).pack(values);
+		REQUIRE(many.count() > Buffer::MaxVectors);
+
+		FILE* file = std::tmpfile();
+		REQUIRE(file != nullptr);
+		CHECK(many.writeTo(fileno(file)));
+		CHECK(many.pending() == 0);
+
+		std::string written(many.size(), '\0');
+		std::rewind(file);
+		CHECK(std::fread(&written[0], 1, written.size(), file) == written.size());
+		std::fclose(file);
+		CHECK(written == expected.str());
+	}
+
+	SECTION("should resume short writes") {
+		int fds[2];
+		REQUIRE(pipe(fds) == 0);
+		REQUIRE(fcntl(fds[1], F_SETFL, O_NONBLOCK) == 0);
+
+		std::string received;
+		char chunk[4096];
+		while(!buffer.writeTo(fds[1])) {
+			REQUIRE(errno == EAGAIN);
+			REQUIRE(buffer.pending() != 0);
+			const ssize_t length = read(fds[0], chunk, sizeof(chunk));
+			REQUIRE(length > 0);
+			received.append(chunk, static_cast<size_t>(length));
+		}
+		close(fds[1]);
+		for(ssize_t length; (length = read(fds[0], chunk, sizeof(chunk))) > 0;) {
+			received.append(chunk, static_cast<size_t>(length));
+		}
+		close(fds[0]);
+
+		CHECK(received == ss.str());
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+#include <cstdio>
+#include <sstream>
+
+#include <PacketBuffer/PacketBuffer.h>
+#include <PacketBuffer/Buffer/MappedFileReader.h>
+
+#include <unistd.h>
+
+namespace {
+	std::string temporaryFile(const std::string& contents) {
+		char path[] = "/tmp/PacketBuffer.MappedFileReader.XXXXXX";
+		int fd = mkstemp(path);
+		REQUIRE(fd >= 0);
+		REQUIRE(write(fd, contents.data(), contents.size()) == static_cast<ssize_t>(contents.size()));
+		close(fd);
+		return path;
+	}
+}
+
+TEST_CASE("Buffer/MappedFileReader", "[buffer][mapped-file-reader]") {
+
+	SECTION("should unpack from a file") {
+		std::stringstream ss;
+		PacketBuffer::Packer<std::ostream> packer(ss);
+		for(uint32_t i = 0; i < 1000; i++) {
+			packer.pack(i, std::string("topic"));
+		}
+		const std::string path = temporaryFile(ss.str());
+
+		{
+			PacketBuffer::MappedFileReader reader(path);
+			REQUIRE(reader.size() == ss.str().size());
+
+			PacketBuffer::Unpacker<PacketBuffer::MappedFileReader, boost::endian::order::little,
+					PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked> unpacker(reader);
+			for(uint32_t i = 0; i < 1000; i++) {
+				REQUIRE(unpacker.unpack<uint32_t>() == i);
+				REQUIRE(unpacker.unpack<PacketBuffer::StringView>() == "topic");
+			}
+			CHECK(unpacker.good());
+			CHECK(reader.remaining() == 0);
+
+			SECTION("and should fail past the end") {
+				unpacker.unpack<uint32_t>();
+				CHECK(unpacker.error() == PacketBuffer::UnpackError::Truncated);
+			}
+		}
+		std::remove(path.c_str());
+	}
+
+	SECTION("should map empty files") {
+		const std::string path = temporaryFile("");
+		{
+			PacketBuffer::MappedFileReader reader(path);
+			CHECK(reader.size() == 0);
+			CHECK(reader.remaining() == 0);
+		}
+		std::remove(path.c_str());
+	}
+
+	SECTION("should throw when the file cannot be opened") {
+		CHECK_THROWS_AS(PacketBuffer::MappedFileReader("/nonexistent/PacketBuffer"), std::system_error);
+	}
+
+}
\ No newline at end of file
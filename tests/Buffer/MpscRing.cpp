@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+#include <thread>
+#include <vector>
+
+#include <PacketBuffer/PacketBuffer.h>
+
+namespace {
+	struct Message {
+		uint32_t producer;
+		uint64_t sequence;
+		std::string text;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(producer, sequence, text);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			unpacker(producer, sequence, text);
+		}
+	};
+
+	void produce(PacketBuffer::MpscRing::Producer& producer, const Message& message) {
+		producer.reserve();
+		PacketBuffer::Packer<PacketBuffer::MpscRing::Producer> packer(producer);
+		packer.pack(message);
+		producer.commit();
+	}
+
+	bool consume(PacketBuffer::MpscRing::Consumer& consumer, Message& message) {
+		if(!consumer.next()) {
+			return false;
+		}
+		PacketBuffer::Unpacker<PacketBuffer::MpscRing::Consumer, boost::endian::order::little,
+				PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked> unpacker(consumer);
+		unpacker.unpack(message);
+		REQUIRE(unpacker.good());
+		REQUIRE(consumer.remaining() == 0);
+		consumer.release();
+		return true;
+	}
+}
+
+TEST_CASE("Buffer/MpscRing", "[buffer][mpsc-ring]") {
+
+	constexpr size_t Slots = 4;
+	constexpr size_t SlotSize = 100;
+	std::vector<uint64_t> memory(PacketBuffer::MpscRing::footprint(Slots, SlotSize) / sizeof(uint64_t));
+	PacketBuffer::MpscRing* ring = PacketBuffer::MpscRing::create(memory.data(), Slots, SlotSize);
+	PacketBuffer::MpscRing::Producer first(*ring);
+	PacketBuffer::MpscRing::Producer second(*ring);
+	PacketBuffer::MpscRing::Consumer consumer(*ring);
+
+	SECTION("should pad slots to cache lines") {
+		CHECK(PacketBuffer::MpscRing::footprint(Slots, SlotSize) == 64 * 3 + Slots * 128);
+		CHECK(ring->maxMessageSize() == SlotSize);
+	}
+
+	SECTION("should pass messages in claim order") {
+		Message message;
+		CHECK_FALSE(consumer.next());
+
+		produce(first, {1, 1, "Hello"});
+		produce(second, {2, 1, "World"});
+
+		REQUIRE(consume(consumer, message));
+		CHECK(message.producer == 1);
+		CHECK(message.text == "Hello");
+		REQUIRE(consume(consumer, message));
+		CHECK(message.producer == 2);
+		CHECK(message.text == "World");
+		CHECK_FALSE(consumer.next());
+	}
+
+	SECTION("should wait for a slot claimed earlier to be committed") {
+		first.reserve();
+		produce(second, {2, 1, "World"});
+		CHECK_FALSE(consumer.next());
+
+		PacketBuffer::Packer<PacketBuffer::MpscRing::Producer> packer(first);
+		packer.pack(Message{1, 1, "Hello"});
+		first.commit();
+
+		Message message;
+		REQUIRE(consume(consumer, message));
+		CHECK(message.producer == 1);
+		REQUIRE(consume(consumer, message));
+		CHECK(message.producer == 2);
+	}
+
+	SECTION("should give up reserving when full") {
+		for(size_t i = 0; i < Slots; i++) {
+			REQUIRE(first.tryReserve());
+			PacketBuffer::Packer<PacketBuffer::MpscRing::Producer> packer(first);
+			packer.pack(Message{1, i, "Hello"});
+			first.commit();
+		}
+		CHECK_FALSE(second.tryReserve());
+
+		Message message;
+		REQUIRE(consume(consumer, message));
+		CHECK(message.sequence == 0);
+		CHECK(second.tryReserve());
+		second.commit();
+	}
+
+	SECTION("should resume consuming with a new consumer") {
+		Message message;
+		produce(first, {1, 1, "Hello"});
+		produce(first, {1, 2, "World"});
+		REQUIRE(consume(consumer, message));
+
+		PacketBuffer::MpscRing::Consumer resumed(*PacketBuffer::MpscRing::attach(memory.data()));
+		REQUIRE(consume(resumed, message));
+		CHECK(message.sequence == 2);
+		CHECK_FALSE(resumed.next());
+	}
+
+	SECTION("should reuse slots once released") {
+		Message message;
+		for(uint64_t i = 0; i < 100; i++) {
+			produce(i % 2 ? first : second, {static_cast<uint32_t>(i % 2), i, std::string(i % 80, 'x')});
+			REQUIRE(consume(consumer, message));
+			CHECK(message.sequence == i);
+			CHECK(message.text.size() == i % 80);
+		}
+	}
+
+}
+
+TEST_CASE("Buffer/MpscRing/Threads", "[buffer][mpsc-ring]") {
+
+	constexpr size_t Slots = 256;
+	constexpr size_t SlotSize = 64;
+	constexpr uint32_t Producers = 4;
+	constexpr uint64_t Count = 50000;
+	std::vector<uint64_t> memory(PacketBuffer::MpscRing::footprint(Slots, SlotSize) / sizeof(uint64_t));
+	PacketBuffer::MpscRing* ring = PacketBuffer::MpscRing::create(memory.data(), Slots, SlotSize);
+
+	std::vector<std::thread> threads;
+	for(uint32_t p = 0; p < Producers; p++) {
+		threads.emplace_back([ring, p] {
+			PacketBuffer::MpscRing::Producer producer(*ring);
+			for(uint64_t i = 0; i < Count; i++) {
+				produce(producer, {p, i, std::string(i % 23, 'x')});
+			}
+		});
+	}
+
+	PacketBuffer::MpscRing::Consumer consumer(*ring);
+	std::vector<uint64_t> expected(Producers, 0);
+	Message message;
+	bool ordered = true;
+	for(uint64_t i = 0; i < Producers * Count; i++) {
+		while(!consume(consumer, message)) {
+			std::this_thread::yield();
+		}
+		ordered = ordered && message.producer < Producers &&
+				  message.sequence == expected[message.producer]++ && message.text.size() == message.sequence % 23;
+	}
+	for(std::thread& thread : threads) {
+		thread.join();
+	}
+
+	CHECK(ordered);
+	CHECK_FALSE(consumer.next());
+
+}
\ No newline at end of file
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+#include <string>
+#include <thread>
+
+#include <csignal>
+
+#include <pthread.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <PacketBuffer/PacketBuffer.h>
+#include <PacketBuffer/Buffer/ShmChannel.h>
+
+namespace {
+	struct Quote {
+		uint64_t sequence;
+		double price;
+		std::string venue;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(sequence, price, venue);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			unpacker(sequence, price, venue);
+		}
+	};
+
+	std::string channelName() {
+		return "/PacketBuffer.Tests." + std::to_string(::getpid());
+	}
+
+	void produce(PacketBuffer::ShmChannel::Producer& producer, const Quote& quote) {
+		while(!producer.reserve(PacketBuffer::packedSize(quote))) {
+			std::this_thread::yield();
+		}
+		PacketBuffer::Packer<PacketBuffer::ShmChannel::Producer> packer(producer);
+		packer.pack(quote);
+		producer.commit();
+	}
+
+	void interrupted(int) {
+	}
+
+	Quote consume(PacketBuffer::ShmChannel::Consumer& consumer) {
+		Quote quote;
+		PacketBuffer::Unpacker<PacketBuffer::ShmChannel::Consumer, boost::endian::order::little,
+				PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked> unpacker(consumer);
+		unpacker.unpack(quote);
+		REQUIRE(unpacker.good());
+		consumer.release();
+		return quote;
+	}
+}
+
+TEST_CASE("Buffer/ShmChannel", "[buffer][shm-channel]") {
+
+	const std::string name = channelName();
+	PacketBuffer::ShmChannel created = PacketBuffer::ShmChannel::create(name, 4096);
+
+	SECTION("should pass messages between two mappings") {
+		PacketBuffer::ShmChannel opened = PacketBuffer::ShmChannel::open(name);
+		REQUIRE(opened.ring()->getCapacity() == 4096);
+		CHECK(opened.ring() != created.ring());
+
+		PacketBuffer::ShmChannel::Producer producer(created);
+		PacketBuffer::ShmChannel::Consumer consumer(opened);
+		CHECK_FALSE(consumer.next());
+
+		produce(producer, {1, 101.25, "XNAS"});
+		REQUIRE(consumer.next());
+		const Quote quote = consume(consumer);
+		CHECK(quote.sequence == 1);
+		CHECK(quote.price == 101.25);
+		CHECK(quote.venue == "XNAS");
+		CHECK_FALSE(consumer.next());
+	}
+
+	SECTION("should time out when no message is committed") {
+		PacketBuffer::ShmChannel::Consumer consumer(created, 10);
+		CHECK_FALSE(consumer.wait(std::chrono::milliseconds(1)));
+	}
+
+	SECTION("should refuse to create an existing channel") {
+		CHECK_THROWS_AS(PacketBuffer::ShmChannel::create(name, 4096), std::system_error);
+	}
+
+	SECTION("should refuse to open a missing channel") {
+		CHECK_THROWS_AS(PacketBuffer::ShmChannel::open(name + ".missing"), std::system_error);
+	}
+
+	SECTION("should wake a sleeping consumer up") {
+		PacketBuffer::ShmChannel::Consumer consumer(created, 0);
+		std::thread thread([&name] {
+			PacketBuffer::ShmChannel opened = PacketBuffer::ShmChannel::open(name);
+			PacketBuffer::ShmChannel::Producer producer(opened);
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			produce(producer, {7, 99.5, "XLON"});
+		});
+
+		bool received = false;
+		for(int i = 0; i < 100 && !received; i++) {
+			received = consumer.wait(std::chrono::milliseconds(100));
+		}
+		thread.join();
+
+		REQUIRE(received);
+		CHECK(consume(consumer).sequence == 7);
+	}
+
+	SECTION("should keep sleeping when interrupted") {
+		struct sigaction action = {};
+		struct sigaction previous = {};
+		action.sa_handler = interrupted;
+		REQUIRE(::sigaction(SIGUSR1, &action, &previous) == 0);
+
+		const pthread_t waiting = ::pthread_self();
+		std::thread thread([&name, waiting] {
+			PacketBuffer::ShmChannel opened = PacketBuffer::ShmChannel::open(name);
+			PacketBuffer::ShmChannel::Producer producer(opened);
+			for(int i = 0; i < 5; i++) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+				::pthread_kill(waiting, SIGUSR1);
+			}
+			produce(producer, {8, 99.5, "XLON"});
+		});
+
+		PacketBuffer::ShmChannel::Consumer consumer(created, 0);
+		const bool received = consumer.wait();
+		thread.join();
+		::sigaction(SIGUSR1, &previous, nullptr);
+
+		REQUIRE(received);
+		CHECK(consume(consumer).sequence == 8);
+	}
+
+	SECTION("should sleep for the whole timeout when interrupted") {
+		struct sigaction action = {};
+		struct sigaction previous = {};
+		action.sa_handler = interrupted;
+		REQUIRE(::sigaction(SIGUSR1, &action, &previous) == 0);
+
+		const pthread_t waiting = ::pthread_self();
+		std::thread thread([waiting] {
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			::pthread_kill(waiting, SIGUSR1);
+		});
+
+		PacketBuffer::ShmChannel::Consumer consumer(created, 0);
+		const auto start = std::chrono::steady_clock::now();
+		const bool received = consumer.wait(std::chrono::milliseconds(50));
+		const auto elapsed = std::chrono::steady_clock::now() - start;
+		thread.join();
+		::sigaction(SIGUSR1, &previous, nullptr);
+
+		CHECK_FALSE(received);
+		CHECK(elapsed >= std::chrono::milliseconds(50));
+	}
+
+}
+
+TEST_CASE("Buffer/ShmChannel/Processes", "[buffer][shm-channel]") {
+
+	constexpr uint64_t Count = 100000;
+	const std::string name = channelName();
+	PacketBuffer::ShmChannel channel = PacketBuffer::ShmChannel::create(name, 1 << 14);
+
+	const pid_t child = ::fork();
+	REQUIRE(child >= 0);
+	if(child == 0) {
+		PacketBuffer::ShmChannel opened = PacketBuffer::ShmChannel::open(name);
+		PacketBuffer::ShmChannel::Producer producer(opened);
+		for(uint64_t i = 0; i < Count; i++) {
+			produce(producer, {i, 100.0 + i % 7, std::string(i % 11, 'x')});
+		}
+		::_exit(0);
+	}
+
+	PacketBuffer::ShmChannel::Consumer consumer(channel);
+	bool ordered = true;
+	for(uint64_t i = 0; i < Count; i++) {
+		while(!consumer.wait()) {
+		}
+		const Quote quote = consume(consumer);
+		ordered = ordered && quote.sequence == i && quote.venue.size() == i % 11;
+	}
+
+	int status = 0;
+	REQUIRE(::waitpid(child, &status, 0) == child);
+	CHECK(WIFEXITED(status));
+	CHECK(WEXITSTATUS(status) == 0);
+	CHECK(ordered);
+
+}
\ No newline at end of file
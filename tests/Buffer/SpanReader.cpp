@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+#include <PacketBuffer/PacketBuffer.h>
+
+namespace {
+	std::string hex_to_string(const std::string& input) {
+		static const char* const lut = "0123456789ABCDEF";
+		size_t len = input.length();
+		if(len & 1) throw std::invalid_argument("odd length");
+
+		std::string output;
+		output.reserve(len / 2);
+		for(size_t i = 0; i < len; i += 2) {
+			char a = input[i];
+			const char* p = std::lower_bound(lut, lut + 16, a);
+			if(*p != a) throw std::invalid_argument("not a hex digit");
+
+			char b = input[i + 1];
+			const char* q = std::lower_bound(lut, lut + 16, b);
+			if(*q != b) throw std::invalid_argument("not a hex digit");
+
+			output.push_back(((p - lut) << 4) | (q - lut));
+		}
+		return output;
+	}
+}
+
+TEST_CASE("Buffer/SpanReader", "[buffer][span-reader]") {
+
+	std::string input;
+
+	SECTION("should track the read position") {
+		input = hex_to_string("010000000200");
+		PacketBuffer::SpanReader reader(input.data(), input.size());
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader> unpacker(reader);
+
+		CHECK(unpacker.unpack<uint32_t>() == 1);
+		CHECK(reader.position() == 4);
+		CHECK(reader.remaining() == 2);
+		CHECK(unpacker.unpack<uint16_t>() == 2);
+		CHECK(reader.remaining() == 0);
+
+		SECTION("and should rewind on reset") {
+			reader.reset();
+			CHECK(unpacker.unpack<uint32_t>() == 1);
+		}
+	}
+
+	SECTION("should skip bytes without reading them") {
+		input = hex_to_string("0100000002");
+		PacketBuffer::SpanReader reader(input.data(), input.size());
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader> unpacker(reader);
+
+		reader.skip(4);
+		CHECK(reader.position() == 4);
+		CHECK(unpacker.unpack<uint8_t>() == 2);
+		CHECK(reader.remaining() == 0);
+		CHECK(reader.size() == 5);
+	}
+
+}
\ No newline at end of file
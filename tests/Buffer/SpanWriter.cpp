@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+
+#include <PacketBuffer/PacketBuffer.h>
+
+namespace {
+	std::string string_to_hex(const std::string& input) {
+		static const char* const lut = "0123456789ABCDEF";
+		size_t len = input.length();
+
+		std::string output;
+		output.reserve(2 * len);
+		for(size_t i = 0; i < len; ++i) {
+			const unsigned char c = input[i];
+			output.push_back(lut[c >> 4]);
+			output.push_back(lut[c & 15]);
+		}
+		return output;
+	}
+}
+
+TEST_CASE("Buffer/SpanWriter", "[buffer][span-writer]") {
+
+	char storage[16];
+	PacketBuffer::SpanWriter writer(storage);
+
+	SECTION("should track the written size") {
+		PacketBuffer::Packer<PacketBuffer::SpanWriter> packer(writer);
+		packer.pack(uint32_t(1), uint16_t(2));
+
+		CHECK(writer.size() == 6);
+		CHECK(writer.capacity() == 16);
+		CHECK(writer.remaining() == 10);
+
+		SECTION("and should rewind on reset") {
+			writer.reset();
+			packer.pack(uint8_t(3));
+
+			CHECK(string_to_hex(std::string(writer.data(), writer.size())) == "03");
+		}
+	}
+
+	SECTION("should fill the region up to its capacity") {
+		PacketBuffer::Packer<PacketBuffer::SpanWriter, boost::endian::order::little> packer(writer);
+		packer.pack(uint64_t(1), uint64_t(2));
+
+		CHECK(writer.size() == 16);
+		CHECK(writer.remaining() == 0);
+		CHECK(string_to_hex(std::string(writer.data(), writer.size())) == "01000000000000000200000000000000");
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+#include <thread>
+#include <vector>
+
+#include <PacketBuffer/PacketBuffer.h>
+
+namespace {
+	struct Message {
+		uint64_t sequence;
+		std::string text;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(sequence, text);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			unpacker(sequence, text);
+		}
+	};
+
+	bool produce(PacketBuffer::SpscRing::Producer& producer, const Message& message) {
+		if(!producer.reserve(PacketBuffer::packedSize(message))) {
+			return false;
+		}
+		PacketBuffer::Packer<PacketBuffer::SpscRing::Producer> packer(producer);
+		packer.pack(message);
+		producer.commit();
+		return true;
+	}
+
+	bool consume(PacketBuffer::SpscRing::Consumer& consumer, Message& message) {
+		if(!consumer.next()) {
+			return false;
+		}
+		PacketBuffer::Unpacker<PacketBuffer::SpscRing::Consumer, boost::endian::order::little,
+				PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked> unpacker(consumer);
+		unpacker.unpack(message);
+		REQUIRE(unpacker.good());
+		REQUIRE(consumer.remaining() == 0);
+		consumer.release();
+		return true;
+	}
+}
+
+TEST_CASE("Buffer/SpscRing", "[buffer][spsc-ring]") {
+
+	constexpr size_t Capacity = 256;
+	std::vector<uint64_t> memory(PacketBuffer::SpscRing::footprint(Capacity) / sizeof(uint64_t));
+	PacketBuffer::SpscRing* ring = PacketBuffer::SpscRing::create(memory.data(), Capacity);
+	PacketBuffer::SpscRing::Producer producer(*ring);
+	PacketBuffer::SpscRing::Consumer consumer(*ring);
+
+	SECTION("should pass messages in order") {
+		Message message;
+		CHECK_FALSE(consumer.next());
+
+		REQUIRE(produce(producer, {1, "Hello"}));
+		REQUIRE(produce(producer, {2, "World"}));
+
+		REQUIRE(consume(consumer, message));
+		CHECK(message.sequence == 1);
+		CHECK(message.text == "Hello");
+		REQUIRE(consume(consumer, message));
+		CHECK(message.sequence == 2);
+		CHECK(message.text == "World");
+		CHECK_FALSE(consumer.next());
+	}
+
+	SECTION("should refuse messages when full") {
+		const Message message = {1, std::string(100, 'A')};
+		REQUIRE(produce(producer, message));
+		REQUIRE(produce(producer, message));
+		CHECK_FALSE(produce(producer, message));
+
+		Message unpacked;
+		REQUIRE(consume(consumer, unpacked));
+		CHECK(produce(producer, message));
+	}
+
+	SECTION("should wrap messages around the end of the ring") {
+		Message message;
+		for(uint64_t i = 0; i < 100; i++) {
+			REQUIRE(produce(producer, {i, std::string(i % 90, 'x')}));
+			REQUIRE(consume(consumer, message));
+			CHECK(message.sequence == i);
+			CHECK(message.text.size() == i % 90);
+		}
+	}
+
+	SECTION("should unpack borrowed views in place") {
+		REQUIRE(produce(producer, {7, "in place"}));
+		REQUIRE(consumer.next());
+
+		PacketBuffer::Unpacker<PacketBuffer::SpscRing::Consumer> unpacker(consumer);
+		CHECK(unpacker.unpack<uint64_t>() == 7);
+		const PacketBuffer::StringView text = unpacker.unpack<PacketBuffer::StringView>();
+		CHECK(text == "in place");
+		CHECK(text.data() > reinterpret_cast<const char*>(ring));
+		CHECK(text.data() < reinterpret_cast<const char*>(ring) + PacketBuffer::SpscRing::footprint(Capacity));
+		consumer.release();
+	}
+
+}
+
+TEST_CASE("Buffer/SpscRing/Threads", "[buffer][spsc-ring]") {
+
+	constexpr size_t Capacity = 4096;
+	constexpr uint64_t Count = 200000;
+	std::vector<uint64_t> memory(PacketBuffer::SpscRing::footprint(Capacity) / sizeof(uint64_t));
+	PacketBuffer::SpscRing* ring = PacketBuffer::SpscRing::create(memory.data(), Capacity);
+
+	std::thread thread([ring] {
+		PacketBuffer::SpscRing::Producer producer(*ring);
+		for(uint64_t i = 0; i < Count; i++) {
+			const Message message = {i, std::string(i % 37, 'x')};
+			while(!produce(producer, message)) {
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	PacketBuffer::SpscRing::Consumer consumer(*ring);
+	Message message;
+	bool ordered = true;
+	for(uint64_t i = 0; i < Count; i++) {
+		while(!consume(consumer, message)) {
+			std::this_thread::yield();
+		}
+		ordered = ordered && message.sequence == i && message.text.size() == i % 37;
+	}
+	thread.join();
+
+	CHECK(ordered);
+	CHECK_FALSE(consumer.next());
+
+}
\ No newline at end of file
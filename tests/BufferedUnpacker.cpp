@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+#include <sstream>
+
+#include <PacketBuffer/PacketBuffer.h>
+
+namespace {
+	struct Message {
+		uint32_t id;
+		std::string text;
+		std::vector<uint16_t> values;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(id, text, values);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			unpacker(id, text, values);
+		}
+
+		bool operator==(const Message& other) const {
+			return id == other.id && text == other.text && values == other.values;
+		}
+	};
+
+	struct Point {
+		static int attempts;
+
+		uint32_t x;
+		uint32_t y;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(x, y);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			attempts++;
+			unpacker(x, y);
+		}
+	};
+
+	int Point::attempts = 0;
+
+	struct Text {
+		static int attempts;
+
+		std::string value;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(value);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			attempts++;
+			unpacker(value);
+		}
+	};
+
+	int Text::attempts = 0;
+}
+
+namespace PacketBuffer {
+	template<IntegerEncoding Encoding>
+	struct MaxPackedSize<Point, Encoding> : MaxPackedSizeOf<Encoding, uint32_t, uint32_t> {
+	};
+}
+
+TEST_CASE("BufferedUnpacker", "[buffered-unpacker]") {
+
+	std::stringstream ss;
+	PacketBuffer::Packer<std::ostream> packer(ss);
+
+	SECTION("should unpack values received one byte at a time") {
+		const std::vector<Message> messages = {
+				{1, "Hello", {1, 2, 3}},
+				{2, "", {}},
+				{3, "Testing World", {0xFFFF}}
+		};
+		for(const auto& message : messages) {
+			packer.pack(message);
+		}
+		const std::string stream = ss.str();
+
+		PacketBuffer::BufferedUnpacker<> unpacker;
+		std::vector<Message> unpacked;
+		for(char byte : stream) {
+			unpacker.feed(&byte, 1);
+
+			Message message;
+			while(unpacker.unpack(message) == PacketBuffer::UnpackStatus::Complete) {
+				unpacked.push_back(message);
+			}
+		}
+
+		CHECK(unpacked == messages);
+		CHECK(unpacker.buffered() == 0);
+		CHECK(unpacker.error() == PacketBuffer::UnpackError::None);
+	}
+
+	SECTION("should not keep the elements of previous attempts") {
+		const std::list<std::string> values = {"Hello", "Testing", "World"};
+		packer.pack(values);
+		const std::string stream = ss.str();
+
+		PacketBuffer::BufferedUnpacker<> unpacker;
+		std::list<std::string> unpacked;
+		PacketBuffer::UnpackStatus status = PacketBuffer::UnpackStatus::NeedMoreData;
+		for(size_t i = 0; i < stream.size(); i += 3) {
+			unpacker.feed(stream.data() + i, std::min<size_t>(3, stream.size() - i));
+			status = unpacker.unpack(unpacked);
+		}
+
+		CHECK(status == PacketBuffer::UnpackStatus::Complete);
+		CHECK(unpacked == values);
+	}
+
+	SECTION("should be filled in place") {
+		packer.pack(uint64_t(42), uint64_t(43));
+		const std::string stream = ss.str();
+
+		PacketBuffer::BufferedUnpacker<> unpacker;
+		uint64_t value = 0;
+
+		std::memcpy(unpacker.prepare(12), stream.data(), 12);
+		unpacker.commit(12);
+		REQUIRE(unpacker.unpack(value) == PacketBuffer::UnpackStatus::Complete);
+		CHECK(value == 42);
+		CHECK(unpacker.unpack(value) == PacketBuffer::UnpackStatus::NeedMoreData);
+		CHECK(unpacker.buffered() == 4);
+
+		std::memcpy(unpacker.prepare(4), stream.data() + 12, 4);
+		unpacker.commit(4);
+		REQUIRE(unpacker.unpack(value) == PacketBuffer::UnpackStatus::Complete);
+		CHECK(value == 43);
+	}
+
+	SECTION("should only attempt fixed size values once complete") {
+		packer.pack(Point{1, 2});
+		const std::string stream = ss.str();
+
+		PacketBuffer::BufferedUnpacker<> unpacker;
+		Point point;
+		Point::attempts = 0;
+		for(char byte : stream) {
+			unpacker.feed(&byte, 1);
+			unpacker.unpack(point);
+		}
+
+		CHECK(Point::attempts == 1);
+		CHECK(point.x == 1);
+		CHECK(point.y == 2);
+	}
+
+	SECTION("should wait for the missing bytes before attempting again") {
+		packer.pack(std::string(1000, 'A'));
+		const std::string stream = ss.str();
+
+		PacketBuffer::BufferedUnpacker<> unpacker;
+		Text text;
+		Text::attempts = 0;
+		for(char byte : stream) {
+			unpacker.feed(&byte, 1);
+			unpacker.unpack(text);
+		}
+
+		CHECK(Text::attempts == 3);
+		CHECK(text.value == std::string(1000, 'A'));
+	}
+
+	SECTION("should fail values larger than the buffer limit") {
+		packer.pack(std::string(1000, 'A'));
+		const std::string stream = ss.str();
+
+		PacketBuffer::BufferedUnpacker<> unpacker(512);
+		unpacker.feed(stream.data(), 100);
+
+		Text text;
+		CHECK(unpacker.unpack(text) == PacketBuffer::UnpackStatus::Failed);
+		CHECK(unpacker.error() == PacketBuffer::UnpackError::LimitExceeded);
+
+		SECTION("until reset") {
+			unpacker.reset();
+			unpacker.feed(stream.data(), 4);
+
+			CHECK(unpacker.unpack(text) == PacketBuffer::UnpackStatus::NeedMoreData);
+		}
+	}
+
+	SECTION("should resume containers element by element") {
+		std::vector<Text> values(50);
+		for(size_t i = 0; i < values.size(); i++) {
+			values[i].value = std::string(i, 'A');
+		}
+		packer.pack(values);
+		const std::string stream = ss.str();
+
+		PacketBuffer::BufferedUnpacker<> unpacker;
+		std::vector<Text> unpacked;
+		Text::attempts = 0;
+		size_t buffered = 0;
+		PacketBuffer::UnpackStatus status = PacketBuffer::UnpackStatus::NeedMoreData;
+		for(char byte : stream) {
+			unpacker.feed(&byte, 1);
+			status = unpacker.unpack(unpacked);
+			buffered = std::max(buffered, unpacker.buffered());
+		}
+
+		REQUIRE(status == PacketBuffer::UnpackStatus::Complete);
+		REQUIRE(unpacked.size() == values.size());
+		for(size_t i = 0; i < values.size(); i++) {
+			CHECK(unpacked[i].value == values[i].value);
+		}
+		CHECK(Text::attempts <= 3 * static_cast<int>(values.size()));
+		CHECK(buffered <= 8 + values.size());
+		CHECK_FALSE(unpacker.pending());
+	}
+
+	SECTION("should unpack arrays in place as their elements arrive") {
+		std::vector<uint64_t> values(1000);
+		for(size_t i = 0; i < values.size(); i++) {
+			values[i] = i * 0x0101010101;
+		}
+		packer.pack(values);
+		const std::string stream = ss.str();
+
+		PacketBuffer::BufferedUnpacker<> unpacker;
+		std::vector<uint64_t> unpacked;
+		REQUIRE(unpacker.unpack(unpacked) == PacketBuffer::UnpackStatus::NeedMoreData);
+
+		size_t buffered = 0;
+		PacketBuffer::UnpackStatus status = PacketBuffer::UnpackStatus::NeedMoreData;
+		for(size_t i = 0; i < stream.size(); i += 13) {
+			unpacker.feed(stream.data() + i, std::min<size_t>(13, stream.size() - i));
+			status = unpacker.unpack(unpacked);
+			buffered = std::max(buffered, unpacker.buffered());
+			if(status == PacketBuffer::UnpackStatus::NeedMoreData) {
+				REQUIRE(unpacked.size() == (i + 13 - 8) / 8);
+			}
+		}
+
+		CHECK(status == PacketBuffer::UnpackStatus::Complete);
+		CHECK(unpacked == values);
+		CHECK(buffered < 8);
+	}
+
+	SECTION("should resume Stream VByte blocks") {
+		std::stringstream varints;
+		std::vector<uint32_t> values(300);
+		for(size_t i = 0; i < values.size(); i++) {
+			values[i] = static_cast<uint32_t>(i * i * i);
+		}
+		PacketBuffer::Packer<std::ostream, boost::endian::order::little, PacketBuffer::IntegerEncoding::Varint>(varints)
+				.pack(values);
+		const std::string stream = varints.str();
+
+		PacketBuffer::BufferedUnpacker<boost::endian::order::little, PacketBuffer::IntegerEncoding::Varint> unpacker;
+		std::vector<uint32_t> unpacked;
+		PacketBuffer::UnpackStatus status = PacketBuffer::UnpackStatus::NeedMoreData;
+		for(char byte : stream) {
+			unpacker.feed(&byte, 1);
+			status = unpacker.unpack(unpacked);
+		}
+
+		CHECK(status == PacketBuffer::UnpackStatus::Complete);
+		CHECK(unpacked == values);
+	}
+
+	SECTION("should fail elements larger than the buffer limit") {
+		const std::vector<std::string> values = {"Hello", std::string(1000, 'A')};
+		packer.pack(values);
+		const std::string stream = ss.str();
+
+		PacketBuffer::BufferedUnpacker<> unpacker(512);
+		unpacker.feed(stream.data(), 100);
+
+		std::vector<std::string> unpacked;
+		CHECK(unpacker.unpack(unpacked) == PacketBuffer::UnpackStatus::Failed);
+		CHECK(unpacker.error() == PacketBuffer::UnpackError::LimitExceeded);
+		CHECK(unpacked.size() == 1);
+	}
+
+	SECTION("should fail invalid values") {
+		packer.pack(std::vector<uint16_t>(8));
+		const std::string stream = ss.str();
+
+		PacketBuffer::Limits limits;
+		limits.maxElements = 4;
+		PacketBuffer::BufferedUnpacker<> unpacker(SIZE_MAX, limits);
+		unpacker.feed(stream.data(), stream.size());
+
+		std::vector<uint16_t> values;
+		CHECK(unpacker.unpack(values) == PacketBuffer::UnpackStatus::Failed);
+		CHECK(unpacker.error() == PacketBuffer::UnpackError::LimitExceeded);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+#include <vector>
+
+#include <PacketBuffer/ByteSwap.h>
+
+namespace {
+	template<size_t Width>
+	void checkKernel(PacketBuffer::ByteSwap::Kernel kernel) {
+		for(size_t count = 0; count < 80; count++) {
+			std::vector<char> source(count * Width);
+			for(size_t i = 0; i < source.size(); i++) {
+				source[i] = static_cast<char>(i * 7 + 3);
+			}
+
+			std::vector<char> expected(source.size());
+			for(size_t i = 0; i < count; i++) {
+				for(size_t b = 0; b < Width; b++) {
+					expected[i * Width + b] = source[i * Width + Width - 1 - b];
+				}
+			}
+
+			std::vector<char> destination(source.size());
+			kernel(destination.data(), source.data(), count);
+			REQUIRE(destination == expected);
+
+			kernel(source.data(), source.data(), count);
+			REQUIRE(source == expected);
+		}
+	}
+
+	template<size_t Width>
+	void checkKernels() {
+		SECTION("scalar") {
+			checkKernel<Width>(&PacketBuffer::ByteSwap::reverseScalar<Width>);
+		}
+
+#if defined(PACKETBUFFER_BYTESWAP_X86)
+		SECTION("SSSE3") {
+			if(__builtin_cpu_supports("ssse3")) {
+				checkKernel<Width>(&PacketBuffer::ByteSwap::reverseSSSE3<Width>);
+			}
+		}
+
+		SECTION("AVX2") {
+			if(__builtin_cpu_supports("avx2")) {
+				checkKernel<Width>(&PacketBuffer::ByteSwap::reverseAVX2<Width>);
+			}
+		}
+#endif
+
+		SECTION("dispatched") {
+			checkKernel<Width>(&PacketBuffer::ByteSwap::reverse<Width>);
+		}
+	}
+}
+
+TEST_CASE("ByteSwap", "[byteswap]") {
+
+	SECTION("16-bit") {
+		checkKernels<2>();
+	}
+
+	SECTION("32-bit") {
+		checkKernels<4>();
+	}
+
+	SECTION("64-bit") {
+		checkKernels<8>();
+	}
+
+}
\ No newline at end of file
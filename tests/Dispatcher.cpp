@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <PacketBuffer/PacketBuffer.h>
+
+namespace {
+	struct Login {
+		uint64_t user;
+		std::string token;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(user, token);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			unpacker(user, token);
+		}
+	};
+
+	struct Move {
+		int32_t x;
+		int32_t y;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(x, y);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			unpacker(x, y);
+		}
+	};
+
+	struct Chat {
+		std::list<std::string> lines;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(lines);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			unpacker(lines);
+		}
+	};
+
+	using Messages = PacketBuffer::MessageRegistry<
+			PacketBuffer::MessageType<1, Login>,
+			PacketBuffer::MessageType<4, Move>
+	>;
+
+	using MessageUnpacker = PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::little,
+			PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked>;
+
+	struct Session {
+		std::vector<std::string> received;
+		const Login* lastLogin = nullptr;
+
+		void operator()(const Login& login) {
+			received.push_back("login " + login.token);
+			lastLogin = &login;
+		}
+
+		void operator()(const Move& move) {
+			received.push_back("move " + std::to_string(move.x) + "," + std::to_string(move.y));
+		}
+
+		void operator()(const Chat& chat) {
+			received.push_back("chat " + std::to_string(chat.lines.size()));
+		}
+	};
+
+	template<typename T>
+	std::string packed(const T& message) {
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>> packer(buffer);
+		packer.packVarint(Messages::idOf<T>());
+		packer.pack(message);
+		return std::string(buffer.data(), buffer.size());
+	}
+}
+
+TEST_CASE("Dispatcher", "[dispatcher]") {
+
+	static_assert(Messages::size == 2, "");
+	static_assert(Messages::maxId == 4, "");
+	static_assert(Messages::idOf<Move>() == 4, "");
+
+	Session session;
+	PacketBuffer::Dispatcher<Messages, MessageUnpacker, Session> dispatcher(session);
+
+	SECTION("should dispatch messages by id") {
+		const std::string login = packed(Login{7, "secret"});
+		const std::string move = packed(Move{-3, 12});
+
+		PacketBuffer::SpanReader first(login.data(), login.size());
+		MessageUnpacker unpacker(first);
+		CHECK(dispatcher.dispatch(unpacker));
+
+		PacketBuffer::SpanReader second(move.data(), move.size());
+		MessageUnpacker moveUnpacker(second);
+		CHECK(dispatcher.dispatch(moveUnpacker));
+
+		REQUIRE(session.received.size() == 2);
+		CHECK(session.received[0] == "login secret");
+		CHECK(session.received[1] == "move -3,12");
+	}
+
+	SECTION("should reject unknown ids") {
+		const char data[8] = {};
+		for(uint64_t id : {0, 2, 3, 5, 1000}) {
+			PacketBuffer::SpanReader reader(data, sizeof(data));
+			MessageUnpacker unpacker(reader);
+			CHECK_FALSE(dispatcher.dispatch(id, unpacker));
+		}
+		CHECK(session.received.empty());
+	}
+
+	SECTION("should reuse the slot of each message type") {
+		for(const char* token : {"first", "second"}) {
+			const std::string login = packed(Login{7, token});
+			PacketBuffer::SpanReader reader(login.data(), login.size());
+			MessageUnpacker unpacker(reader);
+			REQUIRE(dispatcher.dispatch(unpacker));
+			CHECK(session.lastLogin == &dispatcher.slot<Login>());
+		}
+		CHECK(dispatcher.slot<Login>().token == "second");
+	}
+
+	SECTION("should not keep the elements of the previous message") {
+		using Chats = PacketBuffer::MessageRegistry<
+				PacketBuffer::MessageType<1, Chat>,
+				PacketBuffer::MessageType<2, Chat>
+		>;
+		PacketBuffer::Dispatcher<Chats, MessageUnpacker, Session> chats(session);
+
+		for(uint64_t id : {1, 1, 2}) {
+			PacketBuffer::GrowableBuffer<> buffer;
+			PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>> packer(buffer);
+			packer.pack(Chat{{"Hello", "World", "!"}});
+
+			PacketBuffer::SpanReader reader(buffer.data(), buffer.size());
+			MessageUnpacker unpacker(reader);
+			REQUIRE(chats.dispatch(id, unpacker));
+		}
+
+		CHECK(session.received == std::vector<std::string>{"chat 3", "chat 3", "chat 3"});
+	}
+
+	SECTION("should keep the memory of the slot between messages") {
+		const std::string first = packed(Login{7, std::string(100, 'a')});
+		PacketBuffer::SpanReader firstReader(first.data(), first.size());
+		MessageUnpacker firstUnpacker(firstReader);
+		REQUIRE(dispatcher.dispatch(firstUnpacker));
+		const char* token = dispatcher.slot<Login>().token.data();
+		const size_t capacity = dispatcher.slot<Login>().token.capacity();
+
+		const std::string second = packed(Login{8, "short"});
+		PacketBuffer::SpanReader secondReader(second.data(), second.size());
+		MessageUnpacker secondUnpacker(secondReader);
+		REQUIRE(dispatcher.dispatch(secondUnpacker));
+		CHECK(dispatcher.slot<Login>().token == "short");
+		CHECK(dispatcher.slot<Login>().token.data() == token);
+		CHECK(dispatcher.slot<Login>().token.capacity() == capacity);
+
+		using Chats = PacketBuffer::MessageRegistry<PacketBuffer::MessageType<1, Chat>>;
+		PacketBuffer::Dispatcher<Chats, MessageUnpacker, Session> chats(session);
+		const std::string* line = nullptr;
+		for(const char* text : {"Hello", "World"}) {
+			PacketBuffer::GrowableBuffer<> buffer;
+			PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>> packer(buffer);
+			packer.pack(Chat{{text}});
+
+			PacketBuffer::SpanReader reader(buffer.data(), buffer.size());
+			MessageUnpacker unpacker(reader);
+			REQUIRE(chats.dispatch(1, unpacker));
+			CHECK(chats.slot<Chat>().lines.front() == text);
+			if(line != nullptr) {
+				CHECK(&chats.slot<Chat>().lines.front() == line);
+			}
+			line = &chats.slot<Chat>().lines.front();
+		}
+	}
+
+	SECTION("should not handle truncated messages") {
+		const std::string move = packed(Move{1, 2});
+		PacketBuffer::SpanReader reader(move.data(), move.size() - 1);
+		MessageUnpacker unpacker(reader);
+		CHECK(dispatcher.dispatch(unpacker));
+		CHECK(unpacker.error() == PacketBuffer::UnpackError::Truncated);
+		CHECK(session.received.empty());
+	}
+
+	SECTION("should dispatch reassembled frames") {
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::FramePacker<PacketBuffer::GrowableBuffer<>> framer(buffer);
+		framer.pack(Messages::idOf<Move>(), Move{5, 6});
+
+		PacketBuffer::FrameReassembler<> reassembler;
+		reassembler.feed(buffer.data(), buffer.size());
+		PacketBuffer::Frame frame;
+		REQUIRE(reassembler.next(frame) == PacketBuffer::UnpackStatus::Complete);
+
+		PacketBuffer::SpanReader reader(frame.payload.data(), frame.payload.size());
+		MessageUnpacker unpacker(reader);
+		CHECK(dispatcher.dispatch(frame.type, unpacker));
+		REQUIRE(session.received.size() == 1);
+		CHECK(session.received[0] == "move 5,6");
+	}
+
+}
\ No newline at end of file
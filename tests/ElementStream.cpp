@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <PacketBuffer/PacketBuffer.h>
+
+namespace {
+	template<PacketBuffer::IntegerEncoding Encoding, typename Container>
+	std::vector<char> pack(const Container& container) {
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>, boost::endian::order::big, Encoding> packer(buffer);
+		packer(container, uint8_t(0xAB));
+		return std::vector<char>(buffer.data(), buffer.data() + buffer.size());
+	}
+
+	template<PacketBuffer::IntegerEncoding Encoding>
+	using StreamUnpacker = PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::big,
+			Encoding, PacketBuffer::Bounds::Checked>;
+
+	template<PacketBuffer::IntegerEncoding Encoding, typename Container>
+	void requireStreamed(const Container& container) {
+		const std::vector<char> bytes = pack<Encoding>(container);
+		PacketBuffer::SpanReader reader(bytes.data(), bytes.size());
+		StreamUnpacker<Encoding> unpacker(reader);
+
+		Container streamed;
+		PacketBuffer::ElementStream<Container, StreamUnpacker<Encoding>> stream(unpacker);
+		REQUIRE(stream.size() == container.size());
+		for(const auto& element : stream) {
+			streamed.insert(streamed.end(), element);
+		}
+
+		uint8_t trailer = 0;
+		unpacker(trailer);
+		REQUIRE(unpacker.good());
+		REQUIRE(trailer == 0xAB);
+		REQUIRE(streamed == container);
+	}
+}
+
+TEST_CASE("ElementStream", "[stream]") {
+	std::vector<uint32_t> samples;
+	for(uint32_t i = 0; i < 2500; i++) {
+		samples.push_back(i * i);
+	}
+
+	SECTION("should stream vectors in chunks") {
+		requireStreamed<PacketBuffer::IntegerEncoding::Fixed>(samples);
+		requireStreamed<PacketBuffer::IntegerEncoding::Varint>(samples);
+		requireStreamed<PacketBuffer::IntegerEncoding::Fixed>(std::vector<double>{0.5, -2.0, 1e10});
+		requireStreamed<PacketBuffer::IntegerEncoding::Varint>(std::vector<int64_t>{-1, 0, 1LL << 40});
+	}
+
+	SECTION("should stream containers packed element by element") {
+		requireStreamed<PacketBuffer::IntegerEncoding::Varint>(std::list<uint32_t>(samples.begin(), samples.end()));
+		requireStreamed<PacketBuffer::IntegerEncoding::Fixed>(std::set<std::string>{"a", "bc", "def"});
+		requireStreamed<PacketBuffer::IntegerEncoding::VarintLength>(
+				std::map<uint16_t, std::string>{{1, "one"}, {2, "two"}, {300, "three hundred"}});
+		requireStreamed<PacketBuffer::IntegerEncoding::Fixed>(std::vector<std::string>{});
+	}
+
+	SECTION("should visit every element") {
+		const std::vector<char> bytes = pack<PacketBuffer::IntegerEncoding::Varint>(samples);
+		PacketBuffer::SpanReader reader(bytes.data(), bytes.size());
+		StreamUnpacker<PacketBuffer::IntegerEncoding::Varint> unpacker(reader);
+
+		uint64_t sum = 0;
+		const uint64_t visited = PacketBuffer::unpackEach<std::vector<uint32_t>>(unpacker, [&](uint32_t sample) {
+			sum += sample;
+		});
+		REQUIRE(visited == samples.size());
+
+		uint64_t expected = 0;
+		for(uint32_t sample : samples) {
+			expected += sample;
+		}
+		REQUIRE(sum == expected);
+	}
+
+	SECTION("should skip the elements that were not iterated") {
+		const std::vector<char> bytes = pack<PacketBuffer::IntegerEncoding::Varint>(samples);
+		PacketBuffer::SpanReader reader(bytes.data(), bytes.size());
+		StreamUnpacker<PacketBuffer::IntegerEncoding::Varint> unpacker(reader);
+
+		PacketBuffer::ElementStream<std::vector<uint32_t>, StreamUnpacker<PacketBuffer::IntegerEncoding::Varint>> stream(unpacker);
+		auto it = stream.begin();
+		REQUIRE(*it == 0);
+		++it;
+		REQUIRE(*it == 1);
+		stream.finish();
+
+		uint8_t trailer = 0;
+		unpacker(trailer);
+		REQUIRE(unpacker.good());
+		REQUIRE(trailer == 0xAB);
+	}
+
+	SECTION("should continue where the previous iteration stopped") {
+		const std::vector<char> bytes = pack<PacketBuffer::IntegerEncoding::Varint>(samples);
+		PacketBuffer::SpanReader reader(bytes.data(), bytes.size());
+		StreamUnpacker<PacketBuffer::IntegerEncoding::Varint> unpacker(reader);
+
+		PacketBuffer::ElementStream<std::vector<uint32_t>, StreamUnpacker<PacketBuffer::IntegerEncoding::Varint>> stream(unpacker);
+		auto it = stream.begin();
+		for(size_t i = 0; i < 10; i++) {
+			REQUIRE(*it == samples[i]);
+			++it;
+		}
+		REQUIRE(*stream.begin() == samples[10]);
+
+		std::vector<uint32_t> rest;
+		const uint64_t visited = stream.visit([&](uint32_t sample) {
+			rest.push_back(sample);
+		});
+		REQUIRE(visited == samples.size() - 10);
+		REQUIRE(rest == std::vector<uint32_t>(samples.begin() + 10, samples.end()));
+		REQUIRE(stream.begin() == stream.end());
+	}
+
+	SECTION("should stop on a truncated container") {
+		const std::vector<std::string> words(100, "truncated");
+		const std::vector<char> bytes = pack<PacketBuffer::IntegerEncoding::Fixed>(words);
+		PacketBuffer::SpanReader reader(bytes.data(), bytes.size() - 100);
+		StreamUnpacker<PacketBuffer::IntegerEncoding::Fixed> unpacker(reader);
+
+		const uint64_t visited = PacketBuffer::unpackEach<std::vector<std::string>>(unpacker, [](const std::string&) {});
+		REQUIRE(visited == 94);
+		REQUIRE(unpacker.error() == PacketBuffer::UnpackError::Truncated);
+	}
+
+	SECTION("should fail lengths larger than the input") {
+		const std::vector<char> bytes = pack<PacketBuffer::IntegerEncoding::Fixed>(samples);
+		PacketBuffer::SpanReader reader(bytes.data(), bytes.size() - 100);
+		StreamUnpacker<PacketBuffer::IntegerEncoding::Fixed> unpacker(reader);
+
+		const uint64_t visited = PacketBuffer::unpackEach<std::vector<uint32_t>>(unpacker, [](uint32_t) {});
+		REQUIRE(visited == 0);
+		REQUIRE(unpacker.error() == PacketBuffer::UnpackError::LengthTooLarge);
+	}
+
+	SECTION("should fail hostile lengths without bounds checking") {
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>> packer(buffer);
+		packer.packLength(uint64_t(1000000));
+		packer(uint64_t(1));
+
+		PacketBuffer::SpanReader reader(buffer.data(), buffer.size());
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader> unpacker(reader);
+		PacketBuffer::ElementStream<std::vector<uint64_t>, PacketBuffer::Unpacker<PacketBuffer::SpanReader>> stream(unpacker);
+		REQUIRE(stream.begin() == stream.end());
+		REQUIRE(unpacker.error() == PacketBuffer::UnpackError::LengthTooLarge);
+	}
+
+	SECTION("should fail lengths over the element limit") {
+		const std::vector<char> bytes = pack<PacketBuffer::IntegerEncoding::Fixed>(samples);
+		PacketBuffer::SpanReader reader(bytes.data(), bytes.size());
+		PacketBuffer::Limits limits;
+		limits.maxElements = 1000;
+		limits.allocationBudget = 16;
+		StreamUnpacker<PacketBuffer::IntegerEncoding::Fixed> unpacker(reader, limits);
+
+		const uint64_t visited = PacketBuffer::unpackEach<std::vector<uint32_t>>(unpacker, [](uint32_t) {});
+		REQUIRE(visited == 0);
+		REQUIRE(unpacker.error() == PacketBuffer::UnpackError::LimitExceeded);
+	}
+
+	SECTION("should not charge streamed elements against the allocation budget") {
+		const std::vector<char> bytes = pack<PacketBuffer::IntegerEncoding::Fixed>(samples);
+		PacketBuffer::SpanReader reader(bytes.data(), bytes.size());
+		PacketBuffer::Limits limits;
+		limits.allocationBudget = 16;
+		StreamUnpacker<PacketBuffer::IntegerEncoding::Fixed> unpacker(reader, limits);
+
+		const uint64_t visited = PacketBuffer::unpackEach<std::vector<uint32_t>>(unpacker, [](uint32_t) {});
+		REQUIRE(visited == samples.size());
+		REQUIRE(unpacker.good());
+		REQUIRE(unpacker.getLimits().allocationBudget == 16);
+	}
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+#include <string>
+#include <vector>
+
+#include <PacketBuffer/PacketBuffer.h>
+
+namespace {
+	struct Message {
+		uint32_t id;
+		std::string text;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(id, text);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			unpacker(id, text);
+		}
+	};
+
+	std::string frames(const std::vector<Message>& messages) {
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::FramePacker<PacketBuffer::GrowableBuffer<>> framer(buffer);
+		for(const Message& message : messages) {
+			framer.pack(message.id % 3, message);
+		}
+		return std::string(buffer.data(), buffer.size());
+	}
+
+	Message unpack(const PacketBuffer::Frame& frame) {
+		PacketBuffer::SpanReader reader(frame.payload.data(), frame.payload.size());
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::little,
+				PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked> unpacker(reader);
+		Message message;
+		unpacker.unpack(message);
+		REQUIRE(unpacker.good());
+		REQUIRE(reader.remaining() == 0);
+		return message;
+	}
+
+	std::vector<Message> reassemble(const std::string& stream, size_t fragmentLength) {
+		PacketBuffer::FrameReassembler<> reassembler;
+		std::vector<Message> messages;
+		for(size_t offset = 0; offset < stream.size(); offset += fragmentLength) {
+			std::string fragment = stream.substr(offset, fragmentLength);
+			reassembler.feed(fragment.data(), fragment.size());
+
+			PacketBuffer::Frame frame;
+			PacketBuffer::UnpackStatus status;
+			while((status = reassembler.next(frame)) == PacketBuffer::UnpackStatus::Complete) {
+				messages.push_back(unpack(frame));
+				CHECK(frame.type == messages.back().id % 3);
+			}
+			REQUIRE(status == PacketBuffer::UnpackStatus::NeedMoreData);
+			fragment.assign(fragment.size(), '\xFF');
+		}
+		CHECK(reassembler.buffered() == 0);
+		return messages;
+	}
+}
+
+TEST_CASE("Frame", "[frame]") {
+
+	SECTION("should pack compact headers") {
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::FramePacker<PacketBuffer::GrowableBuffer<>> framer(buffer);
+
+		framer.pack(uint32_t(0xDEADBEEF));
+		REQUIRE(buffer.size() == 5);
+		CHECK(buffer.data()[0] == 4 << 1);
+
+		buffer.reset();
+		framer.pack(300, uint16_t(1));
+		REQUIRE(buffer.size() == 5);
+		CHECK(std::string(buffer.data(), 3) == "\x05\xAC\x02");
+	}
+
+	SECTION("should yield frames of a single fragment in place") {
+		const std::string stream = frames({{1, "Hello"}, {2, "World"}});
+		PacketBuffer::FrameReassembler<> reassembler;
+		reassembler.feed(stream.data(), stream.size());
+
+		PacketBuffer::Frame frame;
+		REQUIRE(reassembler.next(frame) == PacketBuffer::UnpackStatus::Complete);
+		CHECK(frame.type == 1);
+		CHECK(reinterpret_cast<const char*>(frame.payload.data()) == stream.data() + 2);
+		CHECK(unpack(frame).text == "Hello");
+
+		REQUIRE(reassembler.next(frame) == PacketBuffer::UnpackStatus::Complete);
+		CHECK(frame.type == 2);
+		CHECK(unpack(frame).text == "World");
+		CHECK(reassembler.next(frame) == PacketBuffer::UnpackStatus::NeedMoreData);
+	}
+
+	SECTION("should reassemble frames split at any byte") {
+		std::vector<Message> messages;
+		for(uint32_t i = 0; i < 40; i++) {
+			messages.push_back({i, std::string(i * 7, 'a' + i % 26)});
+		}
+		const std::string stream = frames(messages);
+
+		for(size_t fragmentLength : {1, 2, 3, 7, 64, 1000, 100000}) {
+			const std::vector<Message> reassembled = reassemble(stream, fragmentLength);
+			REQUIRE(reassembled.size() == messages.size());
+			for(size_t i = 0; i < messages.size(); i++) {
+				CHECK(reassembled[i].id == messages[i].id);
+				CHECK(reassembled[i].text == messages[i].text);
+			}
+		}
+	}
+
+	SECTION("should fail frames over the limit") {
+		const std::string stream = frames({{1, std::string(100, 'x')}});
+		PacketBuffer::FrameReassembler<> reassembler(64);
+		reassembler.feed(stream.data(), 1);
+
+		PacketBuffer::Frame frame;
+		CHECK(reassembler.next(frame) == PacketBuffer::UnpackStatus::NeedMoreData);
+		reassembler.feed(stream.data() + 1, stream.size() - 1);
+		CHECK(reassembler.next(frame) == PacketBuffer::UnpackStatus::Failed);
+		CHECK(reassembler.error() == PacketBuffer::UnpackError::LimitExceeded);
+
+		reassembler.reset();
+		CHECK(reassembler.next(frame) == PacketBuffer::UnpackStatus::NeedMoreData);
+	}
+
+	SECTION("should fail invalid headers") {
+		const std::string stream(11, '\xFF');
+		PacketBuffer::FrameReassembler<> reassembler;
+		reassembler.feed(stream.data(), stream.size());
+
+		PacketBuffer::Frame frame;
+		CHECK(reassembler.next(frame) == PacketBuffer::UnpackStatus::Failed);
+		CHECK(reassembler.error() == PacketBuffer::UnpackError::Overflow);
+	}
+
+}
\ No newline at end of file
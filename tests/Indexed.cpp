@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <PacketBuffer/PacketBuffer.h>
+
+namespace {
+	struct Attribute {
+		std::string key;
+		std::string value;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(PacketBuffer::indexed(key, value));
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			auto fields = PacketBuffer::indexed(key, value);
+			unpacker(fields);
+		}
+	};
+
+	struct Counted {
+		static int packs;
+
+		uint32_t value;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packs++;
+			packer(value);
+		}
+	};
+
+	int Counted::packs = 0;
+
+	struct Record {
+		uint64_t id;
+		std::string name;
+		std::vector<Attribute> attributes;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(PacketBuffer::indexed(id, name, PacketBuffer::indexedArray(attributes)));
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			auto fields = PacketBuffer::indexed(id, name, PacketBuffer::indexedArray(attributes));
+			unpacker(fields);
+		}
+	};
+
+	Record makeRecord() {
+		Record record{42, "record", {}};
+		for(int i = 0; i < 1000; i++) {
+			record.attributes.push_back({"key" + std::to_string(i), std::string(static_cast<size_t>(i % 7), 'v')});
+		}
+		return record;
+	}
+
+	template<boost::endian::order Endianess, PacketBuffer::IntegerEncoding Encoding>
+	std::vector<char> pack(const Record& record) {
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>, Endianess, Encoding> packer(buffer);
+		packer.pack(record, uint32_t(0xCAFE));
+		return std::vector<char>(buffer.data(), buffer.data() + buffer.size());
+	}
+
+	template<boost::endian::order Endianess, PacketBuffer::IntegerEncoding Encoding>
+	void requireRoundTrip(const Record& record) {
+		const std::vector<char> bytes = pack<Endianess, Encoding>(record);
+		PacketBuffer::SpanReader reader(bytes.data(), bytes.size());
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader, Endianess, Encoding, PacketBuffer::Bounds::Checked> unpacker(reader);
+
+		Record unpacked;
+		uint32_t trailer = 0;
+		unpacker(unpacked, trailer);
+		REQUIRE(unpacker.good());
+		REQUIRE(unpacked.id == record.id);
+		REQUIRE(unpacked.name == record.name);
+		REQUIRE(unpacked.attributes.size() == record.attributes.size());
+		REQUIRE(unpacked.attributes[999].key == "key999");
+		REQUIRE(trailer == 0xCAFE);
+	}
+}
+
+TEST_CASE("Indexed", "[indexed]") {
+	const Record record = makeRecord();
+
+	SECTION("should unpack indexed sections in order") {
+		requireRoundTrip<boost::endian::order::little, PacketBuffer::IntegerEncoding::Fixed>(record);
+		requireRoundTrip<boost::endian::order::big, PacketBuffer::IntegerEncoding::Fixed>(record);
+		requireRoundTrip<boost::endian::order::big, PacketBuffer::IntegerEncoding::Varint>(record);
+	}
+
+	SECTION("should jump to a single field and element") {
+		using View = PacketBuffer::IndexedView<boost::endian::order::big, PacketBuffer::IntegerEncoding::Varint>;
+		const std::vector<char> bytes = pack<boost::endian::order::big, PacketBuffer::IntegerEncoding::Varint>(record);
+		PacketBuffer::SpanReader reader(bytes.data(), bytes.size());
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::big,
+				PacketBuffer::IntegerEncoding::Varint, PacketBuffer::Bounds::Checked> unpacker(reader);
+
+		View view;
+		uint32_t trailer = 0;
+		unpacker(view, trailer);
+		REQUIRE(unpacker.good());
+		REQUIRE(trailer == 0xCAFE);
+		REQUIRE(view.size() == 3);
+
+		std::string name;
+		REQUIRE(view.get(1, name) == PacketBuffer::UnpackError::None);
+		REQUIRE(name == "record");
+
+		View attributes;
+		REQUIRE(view.get(2, attributes) == PacketBuffer::UnpackError::None);
+		REQUIRE(attributes.size() == 1000);
+
+		Attribute attribute;
+		REQUIRE(attributes.get(734, attribute) == PacketBuffer::UnpackError::None);
+		REQUIRE(attribute.key == "key734");
+		REQUIRE(attribute.value == std::string(734 % 7, 'v'));
+
+		View fields;
+		REQUIRE(attributes.get(999, fields) == PacketBuffer::UnpackError::None);
+		std::string key;
+		REQUIRE(fields.get(0, key) == PacketBuffer::UnpackError::None);
+		REQUIRE(key == "key999");
+
+		REQUIRE(view.item(3).empty());
+		REQUIRE(view.get(3, name) == PacketBuffer::UnpackError::Truncated);
+	}
+
+	SECTION("should skip fields appended by a newer message") {
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>> packer(buffer);
+		packer(PacketBuffer::indexed(uint32_t(1), std::string("two"), std::vector<uint16_t>{3, 4}), uint8_t(5));
+
+		PacketBuffer::SpanReader reader(buffer.data(), buffer.size());
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::little,
+				PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked> unpacker(reader);
+		uint32_t one = 0;
+		std::string two;
+		auto fields = PacketBuffer::indexed(one, two);
+		uint8_t five = 0;
+		unpacker(fields, five);
+		REQUIRE(unpacker.good());
+		REQUIRE(one == 1);
+		REQUIRE(two == "two");
+		REQUIRE(five == 5);
+	}
+
+	SECTION("should leave fields missing from an older message untouched") {
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>> packer(buffer);
+		packer(PacketBuffer::indexed(uint32_t(1)));
+
+		PacketBuffer::SpanReader reader(buffer.data(), buffer.size());
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::little,
+				PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked> unpacker(reader);
+		uint32_t one = 0;
+		std::string two = "default";
+		auto fields = PacketBuffer::indexed(one, two);
+		unpacker(fields);
+		REQUIRE(unpacker.good());
+		REQUIRE(one == 1);
+		REQUIRE(two == "default");
+	}
+
+	SECTION("should reject offsets outside of the section") {
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>> packer(buffer);
+		packer(PacketBuffer::indexed(uint32_t(1), uint32_t(2)));
+
+		std::vector<char> bytes(buffer.data(), buffer.data() + buffer.size());
+		bytes[8] = 9;
+
+		PacketBuffer::SpanReader reader(bytes.data(), bytes.size());
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::little,
+				PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked> unpacker(reader);
+		PacketBuffer::IndexedView<> view;
+		unpacker(view);
+		REQUIRE(unpacker.good());
+
+		uint32_t value = 0;
+		REQUIRE(view.get(0, value) == PacketBuffer::UnpackError::Truncated);
+		REQUIRE(view.get(1, value) == PacketBuffer::UnpackError::Truncated);
+		REQUIRE(view.item(1).empty());
+
+		std::tuple<> nothing;
+		REQUIRE(view.get(1, nothing) == PacketBuffer::UnpackError::Truncated);
+		REQUIRE(view.get(2, nothing) == PacketBuffer::UnpackError::Truncated);
+	}
+
+	SECTION("should measure nested sections once") {
+		const Counted leaf{7};
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>> packer(buffer);
+		Counted::packs = 0;
+		packer(PacketBuffer::indexed(PacketBuffer::indexed(PacketBuffer::indexed(PacketBuffer::indexed(leaf)))));
+
+		CHECK(Counted::packs == 2);
+		CHECK(buffer.size() == 4 * (8 + 4) + 4);
+	}
+
+	SECTION("should pack with the endianess chosen at runtime") {
+		const std::vector<char> expected = pack<boost::endian::order::big, PacketBuffer::IntegerEncoding::Fixed>(record);
+
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::BasicPacker<PacketBuffer::GrowableBuffer<>, PacketBuffer::RuntimeEndianPolicy<>> packer(buffer);
+		packer.setEndianess(boost::endian::order::big);
+		packer.pack(record, uint32_t(0xCAFE));
+
+		CHECK(std::vector<char>(buffer.data(), buffer.data() + buffer.size()) == expected);
+	}
+
+	SECTION("should check the endianess chosen at runtime") {
+		using View = PacketBuffer::IndexedView<boost::endian::order::big, PacketBuffer::IntegerEncoding::Fixed>;
+		const std::vector<char> bytes = pack<boost::endian::order::big, PacketBuffer::IntegerEncoding::Fixed>(record);
+
+		PacketBuffer::SpanReader reader(bytes.data(), bytes.size());
+		PacketBuffer::BasicUnpacker<PacketBuffer::SpanReader, PacketBuffer::RuntimeEndianPolicy<>> unpacker(reader);
+		unpacker.setEndianess(boost::endian::order::big);
+		View view;
+		uint32_t trailer = 0;
+		unpacker(view, trailer);
+		REQUIRE(unpacker.good());
+		REQUIRE(trailer == 0xCAFE);
+		REQUIRE(view.size() == 3);
+
+		PacketBuffer::SpanReader mismatched(bytes.data(), bytes.size());
+		PacketBuffer::BasicUnpacker<PacketBuffer::SpanReader, PacketBuffer::RuntimeEndianPolicy<>> little(mismatched);
+		little.setEndianess(boost::endian::order::little);
+		little(view);
+		REQUIRE(little.error() == PacketBuffer::UnpackError::EndianessMismatch);
+		REQUIRE(view.empty());
+	}
+
+	SECTION("should refuse sections larger than 4 GiB") {
+		PacketBuffer::IndexedSection::SizeRecorder recorder;
+		const size_t table = recorder.open(1);
+		CHECK_THROWS_AS(recorder.record(table, size_t(1) << 32), std::length_error);
+	}
+
+	SECTION("should check the array length before skipping the offset table") {
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>> packer(buffer);
+		packer(uint64_t(4), uint64_t(0));
+
+		std::vector<uint8_t> values;
+		PacketBuffer::SpanReader reader(buffer.data(), buffer.size());
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::little,
+				PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked> unpacker(reader);
+		auto array = PacketBuffer::indexedArray(values);
+		unpacker(array);
+		REQUIRE(unpacker.error() == PacketBuffer::UnpackError::LengthTooLarge);
+		REQUIRE(values.empty());
+
+		PacketBuffer::Limits limits;
+		limits.maxElements = 2;
+		PacketBuffer::SpanReader limited(buffer.data(), buffer.size());
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::little,
+				PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked> limitedUnpacker(limited, limits);
+		limitedUnpacker(array);
+		REQUIRE(limitedUnpacker.error() == PacketBuffer::UnpackError::LimitExceeded);
+	}
+
+	SECTION("should fail on a truncated section") {
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>> packer(buffer);
+		packer(PacketBuffer::indexed(uint32_t(1), std::string("two")));
+
+		PacketBuffer::SpanReader reader(buffer.data(), buffer.size() - 1);
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::little,
+				PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked> unpacker(reader);
+		PacketBuffer::IndexedView<> view;
+		unpacker(view);
+		REQUIRE(unpacker.error() == PacketBuffer::UnpackError::Truncated);
+		REQUIRE(view.empty());
+	}
+}
\ No newline at end of file
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+#include <array>
+#include <string>
+#include <vector>
+
+#include <PacketBuffer/PacketBuffer.h>
+
+namespace {
+	enum class Side : uint8_t {
+		Buy = 1,
+		Sell = 2
+	};
+
+	struct Price {
+		int64_t mantissa;
+		int8_t exponent;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(mantissa, exponent);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			unpacker(mantissa, exponent);
+		}
+	};
+
+	struct OrderHeader {
+		uint64_t sequence;
+		Side side;
+		bool urgent;
+		int16_t venue;
+		Price price;
+		double quantity;
+		std::array<uint32_t, 3> legs;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(sequence, side, urgent, venue, price, quantity, legs);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			unpacker(sequence, side, urgent, venue, price, quantity, legs);
+		}
+	};
+
+	struct Named {
+		uint32_t id;
+		std::string name;
+	};
+
+	struct Misdeclared {
+		uint16_t venue;
+		uint32_t id;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(venue, id);
+		}
+	};
+}
+
+namespace PacketBuffer {
+	template<IntegerEncoding Encoding>
+	struct MaxPackedSize<Price, Encoding> : MaxPackedSizeOf<Encoding, int64_t, int8_t> {
+	};
+
+	template<IntegerEncoding Encoding>
+	struct MaxPackedSize<OrderHeader, Encoding> : MaxPackedSizeOf<Encoding,
+			uint64_t, Side, bool, int16_t, Price, double, std::array<uint32_t, 3>> {
+	};
+
+	template<IntegerEncoding Encoding>
+	struct MaxPackedSize<Misdeclared, Encoding> : MaxPackedSizeOf<Encoding, uint32_t, uint16_t> {
+	};
+}
+
+TEST_CASE("Overlay", "[overlay]") {
+	const OrderHeader header = {0x0102030405060708, Side::Sell, true, -12, {-12345, -2}, 2.5, {{7, 0x01020304, 9}}};
+
+	SECTION("should detect fixed layout types") {
+		static_assert(PacketBuffer::IsFixedLayout<uint16_t>::value, "");
+		static_assert(PacketBuffer::IsFixedLayout<Side>::value, "");
+		static_assert(PacketBuffer::IsFixedLayout<std::array<double, 4>>::value, "");
+		static_assert(PacketBuffer::IsFixedLayout<std::pair<uint8_t, int32_t>>::value, "");
+		static_assert(PacketBuffer::IsFixedLayout<OrderHeader>::value, "");
+		static_assert(!PacketBuffer::IsFixedLayout<std::string>::value, "");
+		static_assert(!PacketBuffer::IsFixedLayout<std::vector<uint32_t>>::value, "");
+		static_assert(!PacketBuffer::IsFixedLayout<Named>::value, "");
+		static_assert(!PacketBuffer::IsFixedLayout<std::pair<uint32_t, std::string>>::value, "");
+		static_assert(PacketBuffer::Overlay<OrderHeader>::size() == 8 + 1 + 1 + 2 + 9 + 8 + 12, "");
+	}
+
+	SECTION("should check field lists against packed samples") {
+		CHECK(PacketBuffer::Overlay<OrderHeader>::checkLayout(header));
+		CHECK(PacketBuffer::Overlay<OrderHeader, boost::endian::order::big>::checkLayout(header));
+		CHECK(PacketBuffer::Overlay<std::array<Price, 2>>::checkLayout({{{1, 2}, {3, 4}}}));
+		CHECK_FALSE(PacketBuffer::Overlay<Misdeclared>::checkLayout({1, 2}));
+	}
+
+	SECTION("should read fields packed in big endian") {
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>, boost::endian::order::big> packer(buffer);
+		packer.pack(header);
+		REQUIRE(buffer.size() == PacketBuffer::Overlay<OrderHeader>::size());
+
+		PacketBuffer::Overlay<OrderHeader, boost::endian::order::big> overlay(buffer.data());
+		REQUIRE(overlay.get<0>() == 0x0102030405060708);
+		REQUIRE(overlay.get<1>() == Side::Sell);
+		REQUIRE(overlay.get<2>() == true);
+		REQUIRE(overlay.get<3>() == -12);
+		REQUIRE(overlay.get<4>().get<0>() == -12345);
+		REQUIRE(overlay.get<4>().get<1>() == -2);
+		REQUIRE(overlay.get<5>() == 2.5);
+		REQUIRE(overlay.get<6>()[0] == 7);
+		REQUIRE(overlay.get<6>()[1] == 0x01020304);
+		REQUIRE(overlay.get<6>()[2] == 9);
+	}
+
+	SECTION("should read fields packed in little endian") {
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>, boost::endian::order::little> packer(buffer);
+		packer.pack(header);
+
+		PacketBuffer::Overlay<OrderHeader> overlay(buffer.data());
+		REQUIRE(overlay.data() == buffer.data());
+		REQUIRE(overlay.get<0>() == 0x0102030405060708);
+		REQUIRE(overlay.get<3>() == -12);
+		REQUIRE(overlay.get<4>().get<0>() == -12345);
+		REQUIRE(overlay.get<5>() == 2.5);
+		REQUIRE(overlay.get<6>()[1] == 0x01020304);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+#include <functional>
+#include <map>
+#include <utility>
+
+#include <PacketBuffer/PacketBuffer.h>
+
+namespace {
+	struct Symbol {
+		uint32_t venue;
+		double tickSize;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(venue, tickSize);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			unpacker(venue, tickSize);
+		}
+	};
+
+	/**
+	 * A comparison functor whose order is chosen at runtime
+	 */
+	struct Ordering {
+		bool descending = false;
+
+		bool operator()(int16_t a, int16_t b) const {
+			return descending ? b < a : a < b;
+		}
+	};
+}
+
+namespace PacketBuffer {
+	template<IntegerEncoding Encoding>
+	struct MaxPackedSize<Symbol, Encoding> : MaxPackedSizeOf<Encoding, uint32_t, double> {
+	};
+}
+
+TEST_CASE("PackedMapView", "[view]") {
+
+	SECTION("should find keys without decoding the map") {
+		std::map<uint64_t, Symbol> symbols;
+		for(uint64_t i = 0; i < 10000; i++) {
+			symbols[i * 2] = Symbol{static_cast<uint32_t>(i % 13), 0.25 * static_cast<double>(i)};
+		}
+
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>, boost::endian::order::big> packer(buffer);
+		packer(symbols, uint8_t(9));
+
+		PacketBuffer::SpanReader reader(buffer.data(), buffer.size());
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::big,
+				PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked> unpacker(reader);
+		PacketBuffer::PackedMapView<uint64_t, Symbol, boost::endian::order::big> view;
+		uint8_t trailer = 0;
+		unpacker(view, trailer);
+		REQUIRE(unpacker.good());
+		REQUIRE(trailer == 9);
+		REQUIRE(view.size() == symbols.size());
+
+		auto it = view.find(4242);
+		REQUIRE(it != view.end());
+		REQUIRE((*it).first == 4242);
+		REQUIRE((*it).second.venue == 2121 % 13);
+		REQUIRE((*it).second.tickSize == 0.25 * 2121);
+
+		REQUIRE(view.find(4243) == view.end());
+		REQUIRE(view.find(20000) == view.end());
+		REQUIRE(view.count(0) == 1);
+		REQUIRE(view.count(19998) == 1);
+		REQUIRE((*view.lower_bound(4243)).first == 4244);
+		REQUIRE(view.lower_bound(19999) == view.end());
+	}
+
+	SECTION("should follow the comparison functor of the map") {
+		const std::map<int16_t, uint8_t, std::greater<int16_t>> values = {{-5, 1}, {0, 2}, {300, 3}};
+
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>> packer(buffer);
+		packer(values);
+
+		PacketBuffer::SpanReader reader(buffer.data(), buffer.size());
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::little,
+				PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked> unpacker(reader);
+		PacketBuffer::PackedMapView<int16_t, uint8_t, boost::endian::order::little, PacketBuffer::IntegerEncoding::Fixed,
+				std::greater<int16_t>> view;
+		unpacker(view);
+		REQUIRE(unpacker.good());
+		REQUIRE((*view.begin()).first == 300);
+		REQUIRE((*view.find(-5)).second == 1);
+		REQUIRE(view.find(1) == view.end());
+	}
+
+	SECTION("should keep the comparison functor it was created with") {
+		const std::map<int16_t, uint8_t, Ordering> values({{-5, 1}, {0, 2}, {300, 3}}, Ordering{true});
+
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>> packer(buffer);
+		packer(values);
+
+		PacketBuffer::SpanReader reader(buffer.data(), buffer.size());
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::little,
+				PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked> unpacker(reader);
+		PacketBuffer::PackedMapView<int16_t, uint8_t, boost::endian::order::little, PacketBuffer::IntegerEncoding::Fixed,
+				Ordering> view(nullptr, 0, Ordering{true});
+		unpacker(view);
+		REQUIRE(unpacker.good());
+		REQUIRE(view.key_comp().descending);
+		REQUIRE((*view.begin()).first == 300);
+		REQUIRE((*view.find(-5)).second == 1);
+		REQUIRE((*view.find(300)).second == 3);
+		REQUIRE(view.find(1) == view.end());
+	}
+
+	SECTION("should check the endianess chosen at runtime") {
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>, boost::endian::order::big> packer(buffer);
+		packer(std::map<uint32_t, uint32_t>{{1, 2}, {3, 4}});
+
+		PacketBuffer::SpanReader reader(buffer.data(), buffer.size());
+		PacketBuffer::BasicUnpacker<PacketBuffer::SpanReader, PacketBuffer::RuntimeEndianPolicy<>> unpacker(reader);
+		unpacker.setEndianess(boost::endian::order::big);
+		PacketBuffer::PackedMapView<uint32_t, uint32_t, boost::endian::order::big> view;
+		unpacker(view);
+		REQUIRE(unpacker.good());
+		REQUIRE((*view.find(3)).second == 4);
+
+		PacketBuffer::SpanReader mismatched(buffer.data(), buffer.size());
+		PacketBuffer::BasicUnpacker<PacketBuffer::SpanReader, PacketBuffer::RuntimeEndianPolicy<>> little(mismatched);
+		little.setEndianess(boost::endian::order::little);
+		little(view);
+		REQUIRE(little.error() == PacketBuffer::UnpackError::EndianessMismatch);
+		REQUIRE(view.empty());
+	}
+
+	SECTION("should refuse values packed in single precision") {
+		using SinglePolicy = PacketBuffer::PackingPolicy<boost::endian::order::little,
+				PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked,
+				PacketBuffer::FloatEncoding::Single>;
+		const std::map<uint32_t, double> prices = {{1, 0.5}, {2, 1.5}, {3, 2.5}};
+
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::BasicPacker<PacketBuffer::GrowableBuffer<>, SinglePolicy> packer(buffer);
+		packer(prices);
+
+		PacketBuffer::SpanReader reader(buffer.data(), buffer.size());
+		PacketBuffer::BasicUnpacker<PacketBuffer::SpanReader, SinglePolicy> unpacker(reader);
+		PacketBuffer::PackedMapView<uint32_t, double> view;
+		unpacker(view);
+		REQUIRE(unpacker.error() == PacketBuffer::UnpackError::FloatEncodingMismatch);
+		REQUIRE(view.empty());
+		REQUIRE(view.find(2) == view.end());
+	}
+
+	SECTION("should find keys next to double values") {
+		const std::map<uint32_t, double> prices = {{1, 0.5}, {2, 1.5}, {3, 2.5}};
+
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>> packer(buffer);
+		packer(prices);
+
+		PacketBuffer::SpanReader reader(buffer.data(), buffer.size());
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::little,
+				PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked> unpacker(reader);
+		PacketBuffer::PackedMapView<uint32_t, double> view;
+		unpacker(view);
+		REQUIRE(unpacker.good());
+		for(const auto& price : prices) {
+			REQUIRE(view.find(price.first) != view.end());
+			CHECK((*view.find(price.first)).second == price.second);
+		}
+		CHECK(view.find(4) == view.end());
+	}
+
+	SECTION("should be empty when the input is truncated") {
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>> packer(buffer);
+		packer(std::map<uint32_t, uint32_t>{{1, 2}});
+
+		PacketBuffer::SpanReader reader(buffer.data(), buffer.size() - 1);
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::little,
+				PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked> unpacker(reader);
+		PacketBuffer::PackedMapView<uint32_t, uint32_t> view;
+		unpacker(view);
+		REQUIRE(unpacker.error() == PacketBuffer::UnpackError::Truncated);
+		REQUIRE(view.empty());
+		REQUIRE(view.find(1) == view.end());
+	}
+}
\ No newline at end of file
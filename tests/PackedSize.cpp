@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+#include <sstream>
+
+#include <PacketBuffer/PacketBuffer.h>
+
+namespace {
+	enum class Color : uint16_t {
+		Red, Green, Blue
+	};
+
+	struct Point {
+		uint32_t x;
+		int32_t y;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(x, y);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			unpacker(x, y);
+		}
+	};
+
+	template<PacketBuffer::IntegerEncoding Encoding, typename T>
+	size_t actualPackedSize(const T& value) {
+		std::stringstream ss;
+		PacketBuffer::Packer<std::ostream, boost::endian::order::little, Encoding> packer(ss);
+		packer.pack(value);
+		return ss.str().size();
+	}
+
+	template<typename T>
+	void checkPackedSize(const T& value) {
+		using PacketBuffer::IntegerEncoding;
+		CHECK(PacketBuffer::packedSize(value) == actualPackedSize<IntegerEncoding::Fixed>(value));
+		CHECK(PacketBuffer::packedSize<IntegerEncoding::VarintLength>(value) ==
+			  actualPackedSize<IntegerEncoding::VarintLength>(value));
+		CHECK(PacketBuffer::packedSize<IntegerEncoding::Varint>(value) ==
+			  actualPackedSize<IntegerEncoding::Varint>(value));
+	}
+}
+
+namespace PacketBuffer {
+	template<IntegerEncoding Encoding>
+	struct MaxPackedSize<Point, Encoding> : MaxPackedSizeOf<Encoding, uint32_t, int32_t> {
+	};
+}
+
+TEST_CASE("PackedSize/Fixed", "[packedsize]") {
+	using PacketBuffer::IntegerEncoding;
+	using PacketBuffer::fixedPackedSize;
+	using PacketBuffer::maxPackedSize;
+
+	static_assert(fixedPackedSize<uint8_t>() == 1, "");
+	static_assert(fixedPackedSize<int64_t>() == 8, "");
+	static_assert(fixedPackedSize<double>() == 8, "");
+	static_assert(fixedPackedSize<Color>() == 2, "");
+	static_assert(fixedPackedSize<Point>() == 8, "");
+	static_assert(fixedPackedSize<std::pair<const uint16_t, Point>>() == 10, "");
+	static_assert(fixedPackedSize<std::tuple<bool, float, Color>>() == 7, "");
+	static_assert(fixedPackedSize<std::array<Point, 4>>() == 32, "");
+	static_assert(fixedPackedSize<uint64_t[3]>() == 24, "");
+	static_assert(fixedPackedSize<std::chrono::milliseconds>() == 8, "");
+
+	static_assert(maxPackedSize<uint16_t, IntegerEncoding::Varint>() == 3, "");
+	static_assert(maxPackedSize<int32_t, IntegerEncoding::Varint>() == 5, "");
+	static_assert(maxPackedSize<uint64_t, IntegerEncoding::Varint>() == 10, "");
+	static_assert(maxPackedSize<float, IntegerEncoding::Varint>() == 4, "");
+	static_assert(maxPackedSize<Point, IntegerEncoding::Varint>() == 10, "");
+	static_assert(maxPackedSize<std::array<uint32_t, 5>, IntegerEncoding::Varint>() == 22, "");
+
+	SECTION("fixed size types should pack into a stack buffer") {
+		const std::array<Point, 4> points = {{{1, -1}, {2, -2}, {3, -3}, {4, -4}}};
+
+		char storage[fixedPackedSize<std::array<Point, 4>>()];
+		PacketBuffer::SpanWriter writer(storage);
+		PacketBuffer::Packer<PacketBuffer::SpanWriter> packer(writer);
+		packer.pack(points);
+
+		CHECK(writer.size() == sizeof(storage));
+	}
+
+}
+
+TEST_CASE("PackedSize/Runtime", "[packedsize]") {
+
+	SECTION("fixed size types") {
+		checkPackedSize(uint32_t(300));
+		checkPackedSize(int64_t(-1));
+		checkPackedSize(Color::Blue);
+		checkPackedSize(std::make_pair(uint16_t(1), 2.0));
+		checkPackedSize(std::array<uint32_t, 9>{{1, 2, 3, 300, 70000, 5, 6, 7, 0xFFFFFFFF}});
+	}
+
+	SECTION("variable length types") {
+		checkPackedSize(std::string("Hello world!"));
+		checkPackedSize(std::vector<uint32_t>{1, 2, 3, 0xFFFFFFFF});
+		checkPackedSize(std::vector<std::string>{"a", "bc", ""});
+		checkPackedSize(std::map<std::string, uint64_t>{{"a", 1}, {"b", 1ull << 40}});
+	}
+
+	SECTION("should follow the packing policy") {
+		using SinglePolicy = PacketBuffer::PackingPolicy<boost::endian::order::big, PacketBuffer::IntegerEncoding::Varint,
+				PacketBuffer::Bounds::Unchecked, PacketBuffer::FloatEncoding::Single>;
+		const std::vector<double> values = {1.5, 2.5, 300.0};
+
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::BasicPacker<PacketBuffer::GrowableBuffer<>, SinglePolicy> packer(buffer);
+		packer.pack(values);
+
+		CHECK(PacketBuffer::packedSize<SinglePolicy>(values) == buffer.size());
+		CHECK(PacketBuffer::packedSize<SinglePolicy>(values) == 1 + 3 * sizeof(float));
+		CHECK(PacketBuffer::packedSize<PacketBuffer::PackingPolicy<>>(values) == PacketBuffer::packedSize(values));
+	}
+
+	SECTION("should reserve the output once") {
+		const std::vector<std::string> strings = {"Hello", "world", "!"};
+
+		PacketBuffer::GrowableBuffer<> buffer;
+		buffer.reserve(PacketBuffer::packedSize(strings));
+		const size_t capacity = buffer.capacity();
+
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>> packer(buffer);
+		packer.pack(strings);
+
+		CHECK(buffer.size() == PacketBuffer::packedSize(strings));
+		CHECK(buffer.capacity() == capacity);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <PacketBuffer/PacketBuffer.h>
+
+TEST_CASE("PackedVectorView", "[view]") {
+
+	SECTION("should decode integers in big endian") {
+		std::vector<uint32_t> values;
+		for(uint32_t i = 0; i < 1000; i++) {
+			values.push_back(i * 3 + 0x01000000);
+		}
+
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>, boost::endian::order::big> packer(buffer);
+		packer(values, uint8_t(7));
+
+		PacketBuffer::SpanReader reader(buffer.data(), buffer.size());
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::big,
+				PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked> unpacker(reader);
+		PacketBuffer::PackedVectorView<uint32_t, boost::endian::order::big> view;
+		uint8_t trailer = 0;
+		unpacker(view, trailer);
+		REQUIRE(unpacker.good());
+		REQUIRE(trailer == 7);
+		REQUIRE(view.size() == values.size());
+		REQUIRE(view[0] == values[0]);
+		REQUIRE(view[999] == values[999]);
+		REQUIRE(std::equal(view.begin(), view.end(), values.begin()));
+
+		auto it = std::lower_bound(view.begin(), view.end(), values[613]);
+		REQUIRE(it - view.begin() == 613);
+		REQUIRE(*it == values[613]);
+		REQUIRE(std::lower_bound(view.begin(), view.end(), 0xFFFFFFFF) == view.end());
+	}
+
+	SECTION("should decode fixed size structures") {
+		const std::vector<std::pair<uint16_t, double>> values = {{1, 0.5}, {2, -1.5}, {0x0102, 3.25}};
+
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>, boost::endian::order::little,
+				PacketBuffer::IntegerEncoding::VarintLength> packer(buffer);
+		packer(values);
+
+		PacketBuffer::SpanReader reader(buffer.data(), buffer.size());
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::little,
+				PacketBuffer::IntegerEncoding::VarintLength, PacketBuffer::Bounds::Checked> unpacker(reader);
+		PacketBuffer::PackedVectorView<std::pair<uint16_t, double>, boost::endian::order::little,
+				PacketBuffer::IntegerEncoding::VarintLength> view;
+		unpacker(view);
+		REQUIRE(unpacker.good());
+		REQUIRE(view.size() == 3);
+		REQUIRE(view[2] == values[2]);
+		REQUIRE(*(view.end() - 1) == values[2]);
+		REQUIRE(std::vector<std::pair<uint16_t, double>>(view.begin(), view.end()) == values);
+	}
+
+	SECTION("should check the endianess chosen at runtime") {
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>, boost::endian::order::big> packer(buffer);
+		packer(std::vector<uint32_t>{1, 2, 3});
+
+		PacketBuffer::SpanReader reader(buffer.data(), buffer.size());
+		PacketBuffer::BasicUnpacker<PacketBuffer::SpanReader, PacketBuffer::RuntimeEndianPolicy<>> unpacker(reader);
+		unpacker.setEndianess(boost::endian::order::big);
+		PacketBuffer::PackedVectorView<uint32_t, boost::endian::order::big> view;
+		unpacker(view);
+		REQUIRE(unpacker.good());
+		REQUIRE(std::vector<uint32_t>(view.begin(), view.end()) == std::vector<uint32_t>{1, 2, 3});
+
+		PacketBuffer::SpanReader mismatched(buffer.data(), buffer.size());
+		PacketBuffer::BasicUnpacker<PacketBuffer::SpanReader, PacketBuffer::RuntimeEndianPolicy<>> little(mismatched);
+		little.setEndianess(boost::endian::order::little);
+		little(view);
+		REQUIRE(little.error() == PacketBuffer::UnpackError::EndianessMismatch);
+		REQUIRE(view.empty());
+	}
+
+	SECTION("should refuse doubles packed in single precision") {
+		using SinglePolicy = PacketBuffer::PackingPolicy<boost::endian::order::little,
+				PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked,
+				PacketBuffer::FloatEncoding::Single>;
+
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::BasicPacker<PacketBuffer::GrowableBuffer<>, SinglePolicy> packer(buffer);
+		packer(std::vector<uint32_t>{1, 2}, std::vector<std::pair<uint16_t, double>>{{1, 0.5}, {2, 1.5}});
+
+		PacketBuffer::SpanReader reader(buffer.data(), buffer.size());
+		PacketBuffer::BasicUnpacker<PacketBuffer::SpanReader, SinglePolicy> unpacker(reader);
+		PacketBuffer::PackedVectorView<uint32_t> integers;
+		unpacker(integers);
+		REQUIRE(unpacker.good());
+		REQUIRE(integers.size() == 2);
+		REQUIRE(integers[1] == 2);
+
+		PacketBuffer::PackedVectorView<std::pair<uint16_t, double>> pairs;
+		unpacker(pairs);
+		REQUIRE(unpacker.error() == PacketBuffer::UnpackError::FloatEncodingMismatch);
+		REQUIRE(pairs.empty());
+
+		PacketBuffer::SpanReader doubles(buffer.data(), buffer.size());
+		PacketBuffer::BasicUnpacker<PacketBuffer::SpanReader, SinglePolicy> doubleUnpacker(doubles);
+		PacketBuffer::PackedVectorView<double> view;
+		doubleUnpacker(view);
+		REQUIRE(doubleUnpacker.error() == PacketBuffer::UnpackError::FloatEncodingMismatch);
+	}
+
+	SECTION("should fail on a truncated vector") {
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>> packer(buffer);
+		packer(std::vector<uint64_t>{1, 2, 3});
+
+		PacketBuffer::SpanReader reader(buffer.data(), buffer.size() - 1);
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::little,
+				PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked> unpacker(reader);
+		PacketBuffer::PackedVectorView<uint64_t> view;
+		unpacker(view);
+		REQUIRE(unpacker.error() == PacketBuffer::UnpackError::Truncated);
+		REQUIRE(view.empty());
+	}
+}
\ No newline at end of file
@@ -46,352 +46,423 @@ std::string string_to_hex(const std::string& input) {
 	return output;
 }
 
-TEST_CASE("Packer", "[packer]") {
-
-	std::stringstream ss;
-
-	SECTION("little endian") {
-		PacketBuffer::Packer<std::ostream, boost::endian::order::little> packer(ss);
-
-		SECTION("uint8_t") {
-			SECTION("min") {
-				packer.pack(std::numeric_limits<uint8_t>::min());
-				CHECK(string_to_hex(ss.str()) == "00");
-			}
-
-			SECTION("one") {
-				packer.pack(uint8_t(1));
-				CHECK(string_to_hex(ss.str()) == "01");
-			}
-
-			SECTION("max") {
-				packer.pack(std::numeric_limits<uint8_t>::max());
-				CHECK(string_to_hex(ss.str()) == "FF");
-			}
-		}
-
-		SECTION("int8_t") {
-			SECTION("min") {
-				packer.pack(std::numeric_limits<int8_t>::min());
-				CHECK(string_to_hex(ss.str()) == "80");
-			}
-
-			SECTION("zero") {
-				packer.pack(int8_t(0));
-				CHECK(string_to_hex(ss.str()) == "00");
-			}
-
-			SECTION("one") {
-				packer.pack(int8_t(1));
-				CHECK(string_to_hex(ss.str()) == "01");
-			}
-
-			SECTION("max") {
-				packer.pack(std::numeric_limits<int8_t>::max());
-				CHECK(string_to_hex(ss.str()) == "7F");
-			}
-		}
-
-		SECTION("uint16_t") {
-			SECTION("min") {
-				packer.pack(std::numeric_limits<uint16_t>::min());
-				CHECK(string_to_hex(ss.str()) == "0000");
-			}
-
-			SECTION("one") {
-				packer.pack(uint16_t(1));
-				CHECK(string_to_hex(ss.str()) == "0100");
-			}
-
-			SECTION("max") {
-				packer.pack(std::numeric_limits<uint16_t>::max());
-				CHECK(string_to_hex(ss.str()) == "FFFF");
-			}
-		}
-
-		SECTION("int16_t") {
-			SECTION("min") {
-				packer.pack(std::numeric_limits<int16_t>::min());
-				CHECK(string_to_hex(ss.str()) == "0080");
-			}
-
-			SECTION("zero") {
-				packer.pack(int16_t(0));
-				CHECK(string_to_hex(ss.str()) == "0000");
-			}
-
-			SECTION("one") {
-				packer.pack(int16_t(1));
-				CHECK(string_to_hex(ss.str()) == "0100");
-			}
-
-			SECTION("max") {
-				packer.pack(std::numeric_limits<int16_t>::max());
-				CHECK(string_to_hex(ss.str()) == "FF7F");
-			}
-		}
-
-		SECTION("uint32_t") {
-			SECTION("min") {
-				packer.pack(std::numeric_limits<uint32_t>::min());
-				CHECK(string_to_hex(ss.str()) == "00000000");
-			}
-
-			SECTION("one") {
-				packer.pack(uint32_t(1));
-				CHECK(string_to_hex(ss.str()) == "01000000");
-			}
-
-			SECTION("max") {
-				packer.pack(std::numeric_limits<uint32_t>::max());
-				CHECK(string_to_hex(ss.str()) == "FFFFFFFF");
-			}
-		}
-
-		SECTION("int32_t") {
-			SECTION("min") {
-				packer.pack(std::numeric_limits<int32_t>::min());
-				CHECK(string_to_hex(ss.str()) == "00000080");
-			}
-
-			SECTION("zero") {
-				packer.pack(int32_t(0));
-				CHECK(string_to_hex(ss.str()) == "00000000");
-			}
-
-			SECTION("one") {
-				packer.pack(int32_t(1));
-				CHECK(string_to_hex(ss.str()) == "01000000");
-			}
-
-			SECTION("max") {
-				packer.pack(std::numeric_limits<int32_t>::max());
-				CHECK(string_to_hex(ss.str()) == "FFFFFF7F");
-			}
-		}
+namespace {
+	/**
+	 * Packs into a std::stringstream.
+	 */
+	struct StreamOutput {
+		using Buffer = std::ostream;
 
-		SECTION("uint64_t") {
-			SECTION("min") {
-				packer.pack(std::numeric_limits<uint64_t>::min());
-				CHECK(string_to_hex(ss.str()) == "0000000000000000");
-			}
-
-			SECTION("one") {
-				packer.pack(uint64_t(1));
-				CHECK(string_to_hex(ss.str()) == "0100000000000000");
-			}
+		std::stringstream ss;
 
-			SECTION("max") {
-				packer.pack(std::numeric_limits<uint64_t>::max());
-				CHECK(string_to_hex(ss.str()) == "FFFFFFFFFFFFFFFF");
-			}
-		}
-
-		SECTION("int64_t") {
-			SECTION("min") {
-				packer.pack(std::numeric_limits<int64_t>::min());
-				CHECK(string_to_hex(ss.str()) == "0000000000000080");
-			}
-
-			SECTION("zero") {
-				packer.pack(int64_t(0));
-				CHECK(string_to_hex(ss.str()) == "0000000000000000");
-			}
-
-			SECTION("one") {
-				packer.pack(int64_t(1));
-				CHECK(string_to_hex(ss.str()) == "0100000000000000");
-			}
-
-			SECTION("max") {
-				packer.pack(std::numeric_limits<int64_t>::max());
-				CHECK(string_to_hex(ss.str()) == "FFFFFFFFFFFFFF7F");
-			}
+		std::ostream& buffer() {
+			return ss;
 		}
 
-		SECTION("bool") {
-			SECTION("true") {
-				packer.pack(true);
-				CHECK(string_to_hex(ss.str()) == "01");
-			}
-
-			SECTION("false") {
-				packer.pack(false);
-				CHECK(string_to_hex(ss.str()) == "00");
-			}
+		std::string hex() const {
+			return string_to_hex(ss.str());
 		}
-	}
+	};
 
-	SECTION("big endian") {
-		PacketBuffer::Packer<std::ostream, boost::endian::order::big> packer(ss);
+	/**
+	 * Packs into a SpanWriter over a stack array.
+	 */
+	struct SpanOutput {
+		using Buffer = PacketBuffer::SpanWriter;
 
-		SECTION("uint8_t") {
-			SECTION("min") {
-				packer.pack(std::numeric_limits<uint8_t>::min());
-				CHECK(string_to_hex(ss.str()) == "00");
-			}
-
-			SECTION("one") {
-				packer.pack(uint8_t(1));
-				CHECK(string_to_hex(ss.str()) == "01");
-			}
+		char storage[16];
+		PacketBuffer::SpanWriter writer{storage};
 
-			SECTION("max") {
-				packer.pack(std::numeric_limits<uint8_t>::max());
-				CHECK(string_to_hex(ss.str()) == "FF");
-			}
+		PacketBuffer::SpanWriter& buffer() {
+			return writer;
 		}
 
-		SECTION("int8_t") {
-			SECTION("min") {
-				packer.pack(std::numeric_limits<int8_t>::min());
-				CHECK(string_to_hex(ss.str()) == "80");
-			}
-
-			SECTION("zero") {
-				packer.pack(int8_t(0));
-				CHECK(string_to_hex(ss.str()) == "00");
-			}
-
-			SECTION("one") {
-				packer.pack(int8_t(1));
-				CHECK(string_to_hex(ss.str()) == "01");
-			}
-
-			SECTION("max") {
-				packer.pack(std::numeric_limits<int8_t>::max());
-				CHECK(string_to_hex(ss.str()) == "7F");
-			}
+		std::string hex() const {
+			return string_to_hex(std::string(writer.data(), writer.size()));
 		}
+	};
+
+	/**
+	 * Checks the packed representation of every arithmetic type in both byte
+	 * orders when packed into the buffer provided by <tt>Output</tt>.
+	 */
+	template<typename Output>
+	void checkPacker() {
+
+		Output output;
+
+		SECTION("little endian") {
+			PacketBuffer::Packer<typename Output::Buffer, boost::endian::order::little> packer(output.buffer());
+
+			SECTION("uint8_t") {
+				SECTION("min") {
+					packer.pack(std::numeric_limits<uint8_t>::min());
+					CHECK(output.hex() == "00");
+				}
+
+				SECTION("one") {
+					packer.pack(uint8_t(1));
+					CHECK(output.hex() == "01");
+				}
+
+				SECTION("max") {
+					packer.pack(std::numeric_limits<uint8_t>::max());
+					CHECK(output.hex() == "FF");
+				}
+			}
+
+			SECTION("int8_t") {
+				SECTION("min") {
+					packer.pack(std::numeric_limits<int8_t>::min());
+					CHECK(output.hex() == "80");
+				}
+
+				SECTION("zero") {
+					packer.pack(int8_t(0));
+					CHECK(output.hex() == "00");
+				}
+
+				SECTION("one") {
+					packer.pack(int8_t(1));
+					CHECK(output.hex() == "01");
+				}
+
+				SECTION("max") {
+					packer.pack(std::numeric_limits<int8_t>::max());
+					CHECK(output.hex() == "7F");
+				}
+			}
+
+			SECTION("uint16_t") {
+				SECTION("min") {
+					packer.pack(std::numeric_limits<uint16_t>::min());
+					CHECK(output.hex() == "0000");
+				}
+
+				SECTION("one") {
+					packer.pack(uint16_t(1));
+					CHECK(output.hex() == "0100");
+				}
+
+				SECTION("max") {
+					packer.pack(std::numeric_limits<uint16_t>::max());
+					CHECK(output.hex() == "FFFF");
+				}
+			}
+
+			SECTION("int16_t") {
+				SECTION("min") {
+					packer.pack(std::numeric_limits<int16_t>::min());
+					CHECK(output.hex() == "0080");
+				}
+
+				SECTION("zero") {
+					packer.pack(int16_t(0));
+					CHECK(output.hex() == "0000");
+				}
+
+				SECTION("one") {
+					packer.pack(int16_t(1));
+					CHECK(output.hex() == "0100");
+				}
+
+				SECTION("max") {
+					packer.pack(std::numeric_limits<int16_t>::max());
+					CHECK(output.hex() == "FF7F");
+				}
+			}
+
+			SECTION("uint32_t") {
+				SECTION("min") {
+					packer.pack(std::numeric_limits<uint32_t>::min());
+					CHECK(output.hex() == "00000000");
+				}
+
+				SECTION("one") {
+					packer.pack(uint32_t(1));
+					CHECK(output.hex() == "01000000");
+				}
+
+				SECTION("max") {
+					packer.pack(std::numeric_limits<uint32_t>::max());
+					CHECK(output.hex() == "FFFFFFFF");
+				}
+			}
 
-		SECTION("uint16_t") {
-			SECTION("min") {
-				packer.pack(std::numeric_limits<uint16_t>::min());
-				CHECK(string_to_hex(ss.str()) == "0000");
-			}
+			SECTION("int32_t") {
+				SECTION("min") {
+					packer.pack(std::numeric_limits<int32_t>::min());
+					CHECK(output.hex() == "00000080");
+				}
+
+				SECTION("zero") {
+					packer.pack(int32_t(0));
+					CHECK(output.hex() == "00000000");
+				}
+
+				SECTION("one") {
+					packer.pack(int32_t(1));
+					CHECK(output.hex() == "01000000");
+				}
 
-			SECTION("one") {
-				packer.pack(uint16_t(1));
-				CHECK(string_to_hex(ss.str()) == "0001");
+				SECTION("max") {
+					packer.pack(std::numeric_limits<int32_t>::max());
+					CHECK(output.hex() == "FFFFFF7F");
+				}
 			}
 
-			SECTION("max") {
-				packer.pack(std::numeric_limits<uint16_t>::max());
-				CHECK(string_to_hex(ss.str()) == "FFFF");
-			}
-		}
+			SECTION("uint64_t") {
+				SECTION("min") {
+					packer.pack(std::numeric_limits<uint64_t>::min());
+					CHECK(output.hex() == "0000000000000000");
+				}
+
+				SECTION("one") {
+					packer.pack(uint64_t(1));
+					CHECK(output.hex() == "0100000000000000");
+				}
 
-		SECTION("int16_t") {
-			SECTION("min") {
-				packer.pack(std::numeric_limits<int16_t>::min());
-				CHECK(string_to_hex(ss.str()) == "8000");
+				SECTION("max") {
+					packer.pack(std::numeric_limits<uint64_t>::max());
+					CHECK(output.hex() == "FFFFFFFFFFFFFFFF");
+				}
 			}
 
-			SECTION("zero") {
-				packer.pack(int16_t(0));
-				CHECK(string_to_hex(ss.str()) == "0000");
-			}
+			SECTION("int64_t") {
+				SECTION("min") {
+					packer.pack(std::numeric_limits<int64_t>::min());
+					CHECK(output.hex() == "0000000000000080");
+				}
+
+				SECTION("zero") {
+					packer.pack(int64_t(0));
+					CHECK(output.hex() == "0000000000000000");
+				}
+
+				SECTION("one") {
+					packer.pack(int64_t(1));
+					CHECK(output.hex() == "0100000000000000");
+				}
 
-			SECTION("one") {
-				packer.pack(int16_t(1));
-				CHECK(string_to_hex(ss.str()) == "0001");
+				SECTION("max") {
+					packer.pack(std::numeric_limits<int64_t>::max());
+					CHECK(output.hex() == "FFFFFFFFFFFFFF7F");
+				}
 			}
 
-			SECTION("max") {
-				packer.pack(std::numeric_limits<int16_t>::max());
-				CHECK(string_to_hex(ss.str()) == "7FFF");
-			}
-		}
+			SECTION("bool") {
+				SECTION("true") {
+					packer.pack(true);
+					CHECK(output.hex() == "01");
+				}
 
-		SECTION("uint32_t") {
-			SECTION("min") {
-				packer.pack(std::numeric_limits<uint32_t>::min());
-				CHECK(string_to_hex(ss.str()) == "00000000");
+				SECTION("false") {
+					packer.pack(false);
+					CHECK(output.hex() == "00");
+				}
 			}
 
-			SECTION("one") {
-				packer.pack(uint32_t(1));
-				CHECK(string_to_hex(ss.str()) == "00000001");
+			SECTION("float") {
+				packer.pack(1.0f);
+				CHECK(output.hex() == "0000803F");
 			}
 
-			SECTION("max") {
-				packer.pack(std::numeric_limits<uint32_t>::max());
-				CHECK(string_to_hex(ss.str()) == "FFFFFFFF");
+			SECTION("double") {
+				packer.pack(-1.0);
+				CHECK(output.hex() == "000000000000F0BF");
 			}
 		}
 
-		SECTION("int32_t") {
-			SECTION("min") {
-				packer.pack(std::numeric_limits<int32_t>::min());
-				CHECK(string_to_hex(ss.str()) == "80000000");
-			}
+		SECTION("big endian") {
+			PacketBuffer::Packer<typename Output::Buffer, boost::endian::order::big> packer(output.buffer());
+
+			SECTION("uint8_t") {
+				SECTION("min") {
+					packer.pack(std::numeric_limits<uint8_t>::min());
+					CHECK(output.hex() == "00");
+				}
+
+				SECTION("one") {
+					packer.pack(uint8_t(1));
+					CHECK(output.hex() == "01");
+				}
+
+				SECTION("max") {
+					packer.pack(std::numeric_limits<uint8_t>::max());
+					CHECK(output.hex() == "FF");
+				}
+			}
+
+			SECTION("int8_t") {
+				SECTION("min") {
+					packer.pack(std::numeric_limits<int8_t>::min());
+					CHECK(output.hex() == "80");
+				}
+
+				SECTION("zero") {
+					packer.pack(int8_t(0));
+					CHECK(output.hex() == "00");
+				}
+
+				SECTION("one") {
+					packer.pack(int8_t(1));
+					CHECK(output.hex() == "01");
+				}
+
+				SECTION("max") {
+					packer.pack(std::numeric_limits<int8_t>::max());
+					CHECK(output.hex() == "7F");
+				}
+			}
+
+			SECTION("uint16_t") {
+				SECTION("min") {
+					packer.pack(std::numeric_limits<uint16_t>::min());
+					CHECK(output.hex() == "0000");
+				}
+
+				SECTION("one") {
+					packer.pack(uint16_t(1));
+					CHECK(output.hex() == "0001");
+				}
+
+				SECTION("max") {
+					packer.pack(std::numeric_limits<uint16_t>::max());
+					CHECK(output.hex() == "FFFF");
+				}
+			}
+
+			SECTION("int16_t") {
+				SECTION("min") {
+					packer.pack(std::numeric_limits<int16_t>::min());
+					CHECK(output.hex() == "8000");
+				}
+
+				SECTION("zero") {
+					packer.pack(int16_t(0));
+					CHECK(output.hex() == "0000");
+				}
+
+				SECTION("one") {
+					packer.pack(int16_t(1));
+					CHECK(output.hex() == "0001");
+				}
+
+				SECTION("max") {
+					packer.pack(std::numeric_limits<int16_t>::max());
+					CHECK(output.hex() == "7FFF");
+				}
+			}
+
+			SECTION("uint32_t") {
+				SECTION("min") {
+					packer.pack(std::numeric_limits<uint32_t>::min());
+					CHECK(output.hex() == "00000000");
+				}
+
+				SECTION("one") {
+					packer.pack(uint32_t(1));
+					CHECK(output.hex() == "00000001");
+				}
+
+				SECTION("max") {
+					packer.pack(std::numeric_limits<uint32_t>::max());
+					CHECK(output.hex() == "FFFFFFFF");
+				}
+			}
+
+			SECTION("int32_t") {
+				SECTION("min") {
+					packer.pack(std::numeric_limits<int32_t>::min());
+					CHECK(output.hex() == "80000000");
+				}
+
+				SECTION("zero") {
+					packer.pack(int32_t(0));
+					CHECK(output.hex() == "00000000");
+				}
+
+				SECTION("one") {
+					packer.pack(int32_t(1));
+					CHECK(output.hex() == "00000001");
+				}
 
-			SECTION("zero") {
-				packer.pack(int32_t(0));
-				CHECK(string_to_hex(ss.str()) == "00000000");
+				SECTION("max") {
+					packer.pack(std::numeric_limits<int32_t>::max());
+					CHECK(output.hex() == "7FFFFFFF");
+				}
 			}
 
-			SECTION("one") {
-				packer.pack(int32_t(1));
-				CHECK(string_to_hex(ss.str()) == "00000001");
-			}
+			SECTION("uint64_t") {
+				SECTION("min") {
+					packer.pack(std::numeric_limits<uint64_t>::min());
+					CHECK(output.hex() == "0000000000000000");
+				}
+
+				SECTION("one") {
+					packer.pack(uint64_t(1));
+					CHECK(output.hex() == "0000000000000001");
+				}
 
-			SECTION("max") {
-				packer.pack(std::numeric_limits<int32_t>::max());
-				CHECK(string_to_hex(ss.str()) == "7FFFFFFF");
+				SECTION("max") {
+					packer.pack(std::numeric_limits<uint64_t>::max());
+					CHECK(output.hex() == "FFFFFFFFFFFFFFFF");
+				}
 			}
-		}
 
-		SECTION("uint64_t") {
-			SECTION("min") {
-				packer.pack(std::numeric_limits<uint64_t>::min());
-				CHECK(string_to_hex(ss.str()) == "0000000000000000");
-			}
+			SECTION("int64_t") {
+				SECTION("min") {
+					packer.pack(std::numeric_limits<int64_t>::min());
+					CHECK(output.hex() == "8000000000000000");
+				}
+
+				SECTION("zero") {
+					packer.pack(int64_t(0));
+					CHECK(output.hex() == "0000000000000000");
+				}
+
+				SECTION("one") {
+					packer.pack(int64_t(1));
+					CHECK(output.hex() == "0000000000000001");
+				}
 
-			SECTION("one") {
-				packer.pack(uint64_t(1));
-				CHECK(string_to_hex(ss.str()) == "0000000000000001");
+				SECTION("max") {
+					packer.pack(std::numeric_limits<int64_t>::max());
+					CHECK(output.hex() == "7FFFFFFFFFFFFFFF");
+				}
 			}
 
-			SECTION("max") {
-				packer.pack(std::numeric_limits<uint64_t>::max());
-				CHECK(string_to_hex(ss.str()) == "FFFFFFFFFFFFFFFF");
-			}
-		}
-
-		SECTION("int64_t") {
-			SECTION("min") {
-				packer.pack(std::numeric_limits<int64_t>::min());
-				CHECK(string_to_hex(ss.str()) == "8000000000000000");
-			}
+			SECTION("bool") {
+				SECTION("true") {
+					packer.pack(true);
+					CHECK(output.hex() == "01");
+				}
 
-			SECTION("zero") {
-				packer.pack(int64_t(0));
-				CHECK(string_to_hex(ss.str()) == "0000000000000000");
+				SECTION("false") {
+					packer.pack(false);
+					CHECK(output.hex() == "00");
+				}
 			}
 
-			SECTION("one") {
-				packer.pack(int64_t(1));
-				CHECK(string_to_hex(ss.str()) == "0000000000000001");
+			SECTION("float") {
+				packer.pack(1.0f);
+				CHECK(output.hex() == "3F800000");
 			}
 
-			SECTION("max") {
-				packer.pack(std::numeric_limits<int64_t>::max());
-				CHECK(string_to_hex(ss.str()) == "7FFFFFFFFFFFFFFF");
+			SECTION("double") {
+				packer.pack(-1.0);
+				CHECK(output.hex() == "BFF0000000000000");
 			}
 		}
+	}
+}
 
-		SECTION("bool") {
-			SECTION("true") {
-				packer.pack(true);
-				CHECK(string_to_hex(ss.str()) == "01");
-			}
-
-			SECTION("false") {
-				packer.pack(false);
-				CHECK(string_to_hex(ss.str()) == "00");
-			}
-		}
+TEST_CASE("Packer", "[packer]") {
+	SECTION("std::ostream") {
+		checkPacker<StreamOutput>();
 	}
 
-}
\ No newline at end of file
+	SECTION("SpanWriter") {
+		checkPacker<SpanOutput>();
+	}
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+#include <type_traits>
+#include <vector>
+
+#include <PacketBuffer/PacketBuffer.h>
+
+namespace {
+	struct CountingStats {
+		static size_t packedBytes;
+		static size_t unpackedBytes;
+		static int failures;
+
+		static void packed(size_t length) noexcept {
+			packedBytes += length;
+		}
+
+		static void unpacked(size_t length) noexcept {
+			unpackedBytes += length;
+		}
+
+		static void failed(PacketBuffer::UnpackError) noexcept {
+			failures++;
+		}
+	};
+
+	size_t CountingStats::packedBytes = 0;
+	size_t CountingStats::unpackedBytes = 0;
+	int CountingStats::failures = 0;
+}
+
+TEST_CASE("Policy", "[policy]") {
+
+	SECTION("should keep the Packer and Unpacker aliases") {
+		static_assert(std::is_same<PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>>,
+				PacketBuffer::BasicPacker<PacketBuffer::GrowableBuffer<>>>::value, "");
+		static_assert(std::is_same<PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::big,
+				PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked>,
+				PacketBuffer::BasicUnpacker<PacketBuffer::SpanReader, PacketBuffer::PackingPolicy<
+						boost::endian::order::big, PacketBuffer::IntegerEncoding::Fixed,
+						PacketBuffer::Bounds::Checked>>>::value, "");
+	}
+
+	SECTION("should pack doubles in single precision") {
+		using SinglePolicy = PacketBuffer::PackingPolicy<boost::endian::order::big,
+				PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked,
+				PacketBuffer::FloatEncoding::Single>;
+
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::BasicPacker<PacketBuffer::GrowableBuffer<>, SinglePolicy> packer(buffer);
+		const std::vector<double> values = {1.5, -0.25, 0.1};
+		packer.pack(2.5, values);
+		REQUIRE(buffer.size() == 4 + 8 + 3 * 4);
+		CHECK(std::string(buffer.data(), 4) == std::string("\x40\x20\x00\x00", 4));
+
+		PacketBuffer::SpanReader reader(buffer.data(), buffer.size());
+		PacketBuffer::BasicUnpacker<PacketBuffer::SpanReader, SinglePolicy> unpacker(reader);
+		double value = 0;
+		std::vector<double> unpacked;
+		unpacker.unpack(value, unpacked);
+		REQUIRE(unpacker.good());
+		CHECK(value == 2.5);
+		REQUIRE(unpacked.size() == 3);
+		CHECK(unpacked[0] == 1.5);
+		CHECK(unpacked[1] == -0.25);
+		CHECK(unpacked[2] == static_cast<float>(0.1));
+	}
+
+	SECTION("should notify the statistics hook") {
+		using StatsPolicy = PacketBuffer::PackingPolicy<boost::endian::order::little,
+				PacketBuffer::IntegerEncoding::VarintLength, PacketBuffer::Bounds::Checked,
+				PacketBuffer::FloatEncoding::Exact, CountingStats>;
+		CountingStats::packedBytes = 0;
+		CountingStats::unpackedBytes = 0;
+		CountingStats::failures = 0;
+
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::BasicPacker<PacketBuffer::GrowableBuffer<>, StatsPolicy> packer(buffer);
+		packer.pack(uint32_t(7), std::string("stats"));
+		CHECK(CountingStats::packedBytes == buffer.size());
+
+		PacketBuffer::SpanReader reader(buffer.data(), buffer.size() - 1);
+		PacketBuffer::BasicUnpacker<PacketBuffer::SpanReader, StatsPolicy> unpacker(reader);
+		uint32_t id = 0;
+		std::string text;
+		unpacker.unpack(id, text);
+		CHECK(unpacker.error() == PacketBuffer::UnpackError::LengthTooLarge);
+		CHECK(CountingStats::unpackedBytes == 5);
+		CHECK(CountingStats::failures == 1);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+#include <vector>
+
+#include <PacketBuffer/PacketBuffer.h>
+
+namespace {
+	struct Sample {
+		uint64_t id;
+		int16_t delta;
+		double value;
+		std::vector<uint32_t> counters;
+		std::vector<uint16_t> flags;
+		std::vector<double> readings;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(id, delta, value, counters, flags, readings);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			unpacker(id, delta, value, counters, flags, readings);
+		}
+	};
+
+	Sample makeSample() {
+		return Sample{0x0102030405060708, -300, 2.75, {1, 0x01020304, 0xFFFFFFFF}, {7, 0x0A0B}, {0.5, -1.25}};
+	}
+
+	template<boost::endian::order Endianess>
+	std::vector<char> packStatic(const Sample& sample) {
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>, Endianess> packer(buffer);
+		packer.pack(sample);
+		return std::vector<char>(buffer.data(), buffer.data() + buffer.size());
+	}
+
+	std::vector<char> packRuntime(const Sample& sample, boost::endian::order endianess) {
+		PacketBuffer::GrowableBuffer<> buffer;
+		PacketBuffer::BasicPacker<PacketBuffer::GrowableBuffer<>, PacketBuffer::RuntimeEndianPolicy<>> packer(buffer);
+		packer.setEndianess(endianess);
+		packer.pack(sample);
+		return std::vector<char>(buffer.data(), buffer.data() + buffer.size());
+	}
+
+	void requireEqual(const Sample& a, const Sample& b) {
+		REQUIRE(a.id == b.id);
+		REQUIRE(a.delta == b.delta);
+		REQUIRE(a.value == b.value);
+		REQUIRE(a.counters == b.counters);
+		REQUIRE(a.flags == b.flags);
+		REQUIRE(a.readings == b.readings);
+	}
+}
+
+TEST_CASE("RuntimeEndian", "[runtime-endian]") {
+	using RuntimePacker = PacketBuffer::BasicPacker<PacketBuffer::GrowableBuffer<>, PacketBuffer::RuntimeEndianPolicy<>>;
+	using RuntimeUnpacker = PacketBuffer::BasicUnpacker<PacketBuffer::SpanReader,
+			PacketBuffer::RuntimeEndianPolicy<PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked>>;
+
+	SECTION("should default to little endian") {
+		PacketBuffer::GrowableBuffer<> buffer;
+		RuntimePacker packer(buffer);
+		REQUIRE(packer.getEndianess() == boost::endian::order::little);
+
+		packer.setEndianess(boost::endian::order::big);
+		REQUIRE(packer.getEndianess() == boost::endian::order::big);
+
+		PacketBuffer::Packer<PacketBuffer::GrowableBuffer<>, boost::endian::order::big> fixed(buffer);
+		REQUIRE(fixed.getEndianess() == boost::endian::order::big);
+	}
+
+	SECTION("should pack the same bytes as the static big endian packer") {
+		const Sample sample = makeSample();
+		REQUIRE(packRuntime(sample, boost::endian::order::big) == packStatic<boost::endian::order::big>(sample));
+	}
+
+	SECTION("should pack the same bytes as the static little endian packer") {
+		const Sample sample = makeSample();
+		REQUIRE(packRuntime(sample, boost::endian::order::little) == packStatic<boost::endian::order::little>(sample));
+	}
+
+	SECTION("should unpack what the static packers pack") {
+		const Sample sample = makeSample();
+		for(auto endianess : {boost::endian::order::big, boost::endian::order::little}) {
+			const std::vector<char> bytes = endianess == boost::endian::order::big ?
+											packStatic<boost::endian::order::big>(sample) :
+											packStatic<boost::endian::order::little>(sample);
+
+			PacketBuffer::SpanReader reader(bytes.data(), bytes.size());
+			RuntimeUnpacker unpacker(reader);
+			unpacker.setEndianess(endianess);
+			REQUIRE(unpacker.getEndianess() == endianess);
+
+			Sample unpacked;
+			unpacker.unpack(unpacked);
+			REQUIRE(unpacker.good());
+			requireEqual(unpacked, sample);
+		}
+	}
+
+	SECTION("should read scalars in the negotiated order") {
+		const char bytes[] = {0x01, 0x02};
+		PacketBuffer::SpanReader reader(bytes, sizeof(bytes));
+		RuntimeUnpacker unpacker(reader);
+		unpacker.setEndianess(boost::endian::order::big);
+
+		uint16_t value = 0;
+		unpacker.unpack(value);
+		REQUIRE(value == 0x0102);
+	}
+
+	SECTION("should pack with the endianess fixed by withEndianess()") {
+		const Sample sample = makeSample();
+		for(auto endianess : {boost::endian::order::big, boost::endian::order::little}) {
+			PacketBuffer::GrowableBuffer<> buffer;
+			RuntimePacker packer(buffer);
+			packer.setEndianess(endianess);
+			packer.withEndianess([&](auto& fixed) {
+				REQUIRE(fixed.getEndianess() == endianess);
+				fixed.pack(sample);
+			});
+
+			const std::vector<char> bytes(buffer.data(), buffer.data() + buffer.size());
+			REQUIRE(bytes == packRuntime(sample, endianess));
+		}
+	}
+
+	SECTION("should carry on from withEndianess()") {
+		const Sample sample = makeSample();
+		std::vector<char> bytes = packStatic<boost::endian::order::big>(sample);
+		bytes.push_back(0x01);
+		bytes.push_back(0x02);
+
+		PacketBuffer::Limits limits;
+		limits.allocationBudget = 1024;
+		PacketBuffer::SpanReader reader(bytes.data(), bytes.size());
+		RuntimeUnpacker unpacker(reader, limits);
+		unpacker.setEndianess(boost::endian::order::big);
+
+		Sample unpacked;
+		unpacker.withEndianess([&](auto& fixed) {
+			REQUIRE(fixed.getEndianess() == boost::endian::order::big);
+			fixed.unpack(unpacked);
+		});
+		requireEqual(unpacked, sample);
+		REQUIRE(unpacker.getLimits().allocationBudget == 1024 - 3 * sizeof(uint32_t) - 2 * sizeof(uint16_t) - 2 * sizeof(double));
+
+		uint16_t value = 0;
+		unpacker.unpack(value);
+		REQUIRE(value == 0x0102);
+		REQUIRE(unpacker.good());
+	}
+
+	SECTION("should carry errors back from withEndianess()") {
+		const std::vector<char> bytes = packStatic<boost::endian::order::little>(makeSample());
+		PacketBuffer::SpanReader reader(bytes.data(), sizeof(uint32_t));
+		RuntimeUnpacker unpacker(reader);
+
+		Sample unpacked;
+		unpacker.withEndianess([&](auto& fixed) {
+			fixed.unpack(unpacked);
+		});
+		REQUIRE(unpacker.error() == PacketBuffer::UnpackError::Truncated);
+	}
+}
\ No newline at end of file
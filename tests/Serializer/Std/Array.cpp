@@ -88,6 +88,58 @@ TEST_CASE("Serializer/Std/Array", "[serializer][std][array]") {
 
 }
 
+TEST_CASE("Serializer/Std/Array/Wide", "[serializer][std][array]") {
+
+	std::stringstream ss;
+
+	SECTION("little endian") {
+		PacketBuffer::Packer<std::ostream, boost::endian::order::little> packer(ss);
+		PacketBuffer::Unpacker<std::istream, boost::endian::order::little> unpacker(ss);
+
+		std::array<uint16_t, 3> array = {1, 2, 0xABCD};
+		packer.pack(array);
+
+		CHECK(string_to_hex(ss.str()) == "01000200CDAB");
+
+		SECTION("and should unpack back") {
+			CHECK(unpacker.unpack<std::array<uint16_t, 3>>() == array);
+		}
+	}
+
+	SECTION("big endian") {
+		PacketBuffer::Packer<std::ostream, boost::endian::order::big> packer(ss);
+		PacketBuffer::Unpacker<std::istream, boost::endian::order::big> unpacker(ss);
+
+		std::array<uint16_t, 3> array = {1, 2, 0xABCD};
+		packer.pack(array);
+
+		CHECK(string_to_hex(ss.str()) == "00010002ABCD");
+
+		SECTION("and should unpack back") {
+			CHECK(unpacker.unpack<std::array<uint16_t, 3>>() == array);
+		}
+	}
+
+	SECTION("C array") {
+		PacketBuffer::Packer<std::ostream> packer(ss);
+		PacketBuffer::Unpacker<std::istream> unpacker(ss);
+
+		uint32_t array[2] = {1, 2};
+		packer.pack(array);
+
+		CHECK(string_to_hex(ss.str()) == "0100000002000000");
+
+		SECTION("and should unpack back") {
+			uint32_t unpacked[2];
+			unpacker.unpack(unpacked);
+
+			CHECK(unpacked[0] == array[0]);
+			CHECK(unpacked[1] == array[1]);
+		}
+	}
+
+}
+
 TEST_CASE("Serializer/Std/CArray", "[serializer][std][c-array]") {
 	std::stringstream ss;
 	PacketBuffer::Packer<std::ostream> packer(ss);
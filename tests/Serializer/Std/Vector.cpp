@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+#include <sstream>
+
+#include <PacketBuffer/PacketBuffer.h>
+
+namespace {
+	std::string string_to_hex(const std::string& input) {
+		static const char* const lut = "0123456789ABCDEF";
+		size_t len = input.length();
+
+		std::string output;
+		output.reserve(2 * len);
+		for(size_t i = 0; i < len; ++i) {
+			const unsigned char c = input[i];
+			output.push_back(lut[c >> 4]);
+			output.push_back(lut[c & 15]);
+		}
+		return output;
+	}
+
+	struct Sample {
+		uint32_t timestamp;
+		uint16_t channel;
+		uint16_t value;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(timestamp, channel, value);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			unpacker(timestamp, channel, value);
+		}
+
+		bool operator==(const Sample& other) const {
+			return timestamp == other.timestamp && channel == other.channel && value == other.value;
+		}
+	};
+}
+
+namespace PacketBuffer {
+	template<>
+	struct IsBitwisePackable<Sample> : std::true_type {
+	};
+}
+
+TEST_CASE("Serializer/Std/Vector", "[serializer][std][vector]") {
+
+	std::stringstream ss;
+
+	SECTION("empty vector") {
+		PacketBuffer::Packer<std::ostream> packer(ss);
+		PacketBuffer::Unpacker<std::istream> unpacker(ss);
+
+		SECTION("should be correctly packed") {
+			std::vector<uint32_t> vector;
+			packer.pack(vector);
+
+			CHECK(string_to_hex(ss.str()) == "0000000000000000");
+
+			SECTION("and should unpack back") {
+				CHECK(unpacker.unpack<std::vector<uint32_t>>().empty());
+			}
+		}
+	}
+
+	SECTION("little endian") {
+		PacketBuffer::Packer<std::ostream, boost::endian::order::little> packer(ss);
+		PacketBuffer::Unpacker<std::istream, boost::endian::order::little> unpacker(ss);
+
+		SECTION("should be correctly packed") {
+			std::vector<uint32_t> vector = {1, 0xDEADBEEF};
+			packer.pack(vector);
+
+			CHECK(string_to_hex(ss.str()) == "020000000000000001000000EFBEADDE");
+
+			SECTION("and should unpack back") {
+				CHECK(unpacker.unpack<std::vector<uint32_t>>() == vector);
+			}
+		}
+
+		SECTION("with floats") {
+			std::vector<float> vector = {1.0f, -2.5f};
+			packer.pack(vector);
+
+			CHECK(string_to_hex(ss.str()) == "02000000000000000000803F000020C0");
+
+			SECTION("and should unpack back") {
+				CHECK(unpacker.unpack<std::vector<float>>() == vector);
+			}
+		}
+
+		SECTION("with bitwise packable structs") {
+			std::vector<Sample> vector = {{1, 2, 3}, {4, 5, 6}};
+			packer.pack(vector);
+
+			CHECK(string_to_hex(ss.str()) == "020000000000000001000000020003000400000005000600");
+
+			SECTION("and should unpack back") {
+				CHECK(unpacker.unpack<std::vector<Sample>>() == vector);
+			}
+		}
+	}
+
+	SECTION("big endian") {
+		PacketBuffer::Packer<std::ostream, boost::endian::order::big> packer(ss);
+		PacketBuffer::Unpacker<std::istream, boost::endian::order::big> unpacker(ss);
+
+		SECTION("should be correctly packed") {
+			std::vector<uint32_t> vector = {1, 0xDEADBEEF};
+			packer.pack(vector);
+
+			CHECK(string_to_hex(ss.str()) == "000000000000000200000001DEADBEEF");
+
+			SECTION("and should unpack back") {
+				CHECK(unpacker.unpack<std::vector<uint32_t>>() == vector);
+			}
+		}
+
+		SECTION("with floats") {
+			std::vector<float> vector = {1.0f, -2.5f};
+			packer.pack(vector);
+
+			CHECK(string_to_hex(ss.str()) == "00000000000000023F800000C0200000");
+
+			SECTION("and should unpack back") {
+				CHECK(unpacker.unpack<std::vector<float>>() == vector);
+			}
+		}
+
+		SECTION("with more elements than a swap chunk") {
+			std::vector<uint64_t> vector(5000);
+			for(size_t i = 0; i < vector.size(); i++) {
+				vector[i] = (uint64_t(i) << 32) | 0xA1B2C3D4;
+			}
+			packer.pack(vector);
+
+			REQUIRE(ss.str().size() == 8 + 5000 * 8);
+			CHECK(string_to_hex(ss.str().substr(8 + 4999 * 8)) == "00001387A1B2C3D4");
+
+			SECTION("and should unpack back") {
+				CHECK(unpacker.unpack<std::vector<uint64_t>>() == vector);
+			}
+		}
+
+		SECTION("through contiguous buffers") {
+			std::vector<uint16_t> vector = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 0xABCD};
+
+			char storage[64];
+			PacketBuffer::SpanWriter writer(storage);
+			PacketBuffer::Packer<PacketBuffer::SpanWriter, boost::endian::order::big> spanPacker(writer);
+			spanPacker.pack(vector);
+
+			REQUIRE(writer.size() == 8 + 17 * 2);
+			CHECK(string_to_hex(std::string(writer.data() + 8 + 15 * 2, 4)) == "0010ABCD");
+
+			SECTION("and should unpack back") {
+				PacketBuffer::SpanReader reader(writer.data(), writer.size());
+				PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::big> spanUnpacker(reader);
+
+				CHECK(spanUnpacker.unpack<std::vector<uint16_t>>() == vector);
+				CHECK(reader.remaining() == 0);
+			}
+
+			SECTION("and should zero-fill a truncated range") {
+				PacketBuffer::SpanReader reader(writer.data() + 8, writer.size() - 10);
+				PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::big,
+						PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked> spanUnpacker(reader);
+
+				std::vector<uint16_t> unpacked(17, 0xFFFF);
+				spanUnpacker.unpackArray(unpacked.data(), unpacked.size());
+
+				CHECK(spanUnpacker.error() == PacketBuffer::UnpackError::Truncated);
+				CHECK(unpacked == std::vector<uint16_t>(17, 0));
+			}
+		}
+
+		SECTION("with bitwise packable structs") {
+			std::vector<Sample> vector = {{1, 2, 3}, {4, 5, 6}};
+			packer.pack(vector);
+
+			CHECK(string_to_hex(ss.str()) == "000000000000000200000001000200030000000400050006");
+
+			SECTION("and should unpack back") {
+				CHECK(unpacker.unpack<std::vector<Sample>>() == vector);
+			}
+		}
+	}
+
+	SECTION("vector of bool") {
+		PacketBuffer::Packer<std::ostream> packer(ss);
+		PacketBuffer::Unpacker<std::istream> unpacker(ss);
+
+		SECTION("should be correctly packed") {
+			std::vector<bool> vector = {true, false, true};
+			packer.pack(vector);
+
+			CHECK(string_to_hex(ss.str()) == "0300000000000000010001");
+
+			SECTION("and should unpack back") {
+				CHECK(unpacker.unpack<std::vector<bool>>() == vector);
+			}
+		}
+	}
+
+}
\ No newline at end of file
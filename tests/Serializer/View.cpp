@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+#include <sstream>
+
+#include <PacketBuffer/PacketBuffer.h>
+
+namespace {
+	std::string string_to_hex(const std::string& input) {
+		static const char* const lut = "0123456789ABCDEF";
+		size_t len = input.length();
+
+		std::string output;
+		output.reserve(2 * len);
+		for(size_t i = 0; i < len; ++i) {
+			const unsigned char c = input[i];
+			output.push_back(lut[c >> 4]);
+			output.push_back(lut[c & 15]);
+		}
+		return output;
+	}
+
+	struct Envelope {
+		PacketBuffer::StringView topic;
+		PacketBuffer::ByteSpan payload;
+
+		template<typename Packer>
+		void pack(Packer& packer) const {
+			packer(topic, payload);
+		}
+
+		template<typename Unpacker>
+		void unpack(Unpacker& unpacker) {
+			unpacker(topic, payload);
+		}
+	};
+}
+
+TEST_CASE("Serializer/View", "[serializer][view]") {
+
+	std::stringstream ss;
+	PacketBuffer::Packer<std::ostream> packer(ss);
+
+	SECTION("StringView should be packed as a std::string") {
+		packer.pack(PacketBuffer::StringView("Hello"));
+
+		CHECK(string_to_hex(ss.str()) == "050000000000000048656C6C6F");
+
+		SECTION("and should unpack back as a std::string") {
+			PacketBuffer::Unpacker<std::istream> unpacker(ss);
+			CHECK(unpacker.unpack<std::string>() == "Hello");
+		}
+	}
+
+	SECTION("ByteSpan should be packed as a std::vector<uint8_t>") {
+		const std::vector<uint8_t> bytes = {0xDE, 0xAD, 0xBE, 0xEF};
+		packer.pack(PacketBuffer::ByteSpan(bytes));
+
+		CHECK(string_to_hex(ss.str()) == "0400000000000000DEADBEEF");
+
+		SECTION("and should unpack back as a std::vector<uint8_t>") {
+			PacketBuffer::Unpacker<std::istream> unpacker(ss);
+			CHECK(unpacker.unpack<std::vector<uint8_t>>() == bytes);
+		}
+	}
+
+	SECTION("views should point into the input") {
+		const std::vector<uint8_t> bytes = {1, 2, 3};
+		packer.pack(std::string("orders"), bytes);
+		const std::string input = ss.str();
+
+		PacketBuffer::SpanReader reader(input.data(), input.size());
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader> unpacker(reader);
+		Envelope envelope;
+		unpacker.unpack(envelope);
+
+		CHECK(envelope.topic == "orders");
+		CHECK(envelope.topic.data() == input.data() + 8);
+		CHECK(envelope.payload == PacketBuffer::ByteSpan(bytes));
+		CHECK(reinterpret_cast<const char*>(envelope.payload.data()) == input.data() + 22);
+		CHECK(reader.remaining() == 0);
+	}
+
+	SECTION("truncated views should be empty") {
+		packer.pack(std::string("orders"));
+		const std::string input = ss.str();
+
+		PacketBuffer::SpanReader reader(input.data(), input.size() - 1);
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::little,
+				PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked> unpacker(reader);
+
+		CHECK(unpacker.unpack<PacketBuffer::StringView>().empty());
+		CHECK(unpacker.error() == PacketBuffer::UnpackError::Truncated);
+		CHECK(unpacker.missing() == 1);
+	}
+
+	SECTION("views longer than the input should be empty without bounds checking") {
+		packer.packLength(uint64_t(1000000));
+		packer.pack(uint32_t(0));
+		const std::string input = ss.str();
+
+		PacketBuffer::SpanReader reader(input.data(), input.size());
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader> unpacker(reader);
+
+		CHECK(unpacker.unpack<PacketBuffer::StringView>().empty());
+		CHECK(unpacker.error() == PacketBuffer::UnpackError::Truncated);
+
+		PacketBuffer::SpanReader vectorReader(input.data(), input.size());
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader> vectorUnpacker(vectorReader);
+		CHECK(vectorUnpacker.unpack<PacketBuffer::PackedVectorView<uint64_t>>().empty());
+		CHECK(vectorUnpacker.error() == PacketBuffer::UnpackError::Truncated);
+	}
+
+	SECTION("views should be unpacked from a BufferedUnpacker") {
+		packer.pack(std::string("orders"));
+		const std::string input = ss.str();
+
+		PacketBuffer::BufferedUnpacker<> stream;
+		PacketBuffer::StringView topic;
+		stream.feed(input.data(), 10);
+		CHECK(stream.unpack(topic) == PacketBuffer::UnpackStatus::NeedMoreData);
+		stream.feed(input.data() + 10, input.size() - 10);
+		CHECK(stream.unpack(topic) == PacketBuffer::UnpackStatus::Complete);
+		CHECK(topic == "orders");
+	}
+
+}
\ No newline at end of file
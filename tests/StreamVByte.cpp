@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+#include <vector>
+
+#include <PacketBuffer/PacketBuffer.h>
+
+namespace {
+	std::vector<uint32_t> makeValues(size_t count) {
+		std::vector<uint32_t> values(count);
+		for(size_t i = 0; i < count; i++) {
+			const uint32_t value = static_cast<uint32_t>(i * 2654435761u);
+			values[i] = value >> (8 * (i % 4));
+		}
+		return values;
+	}
+
+	void checkKernel(PacketBuffer::StreamVByte::Kernel kernel) {
+		for(size_t count = 0; count < 80; count++) {
+			const std::vector<uint32_t> values = makeValues(count);
+
+			std::vector<char> control(PacketBuffer::StreamVByte::controlLength(count));
+			std::vector<char> data(count * 4 + PacketBuffer::StreamVByte::Padding);
+			const size_t length = PacketBuffer::StreamVByte::encode(values.data(), count, control.data(), data.data());
+			REQUIRE(PacketBuffer::StreamVByte::dataLength(control.data(), count) == length);
+
+			std::vector<uint32_t> decoded(count);
+			kernel(decoded.data(), count, control.data(), data.data());
+			REQUIRE(decoded == values);
+		}
+	}
+}
+
+TEST_CASE("StreamVByte", "[streamvbyte]") {
+
+	SECTION("encoding") {
+		const uint32_t values[] = {0, 0x100, 0x10000, 0x1000000, 0xFF};
+		char control[2];
+		char data[16];
+
+		CHECK(PacketBuffer::StreamVByte::encode(values, 5, control, data) == 11);
+		CHECK(static_cast<uint8_t>(control[0]) == 0xE4);
+		CHECK(static_cast<uint8_t>(control[1]) == 0x00);
+		CHECK(std::string(data, 11) == std::string("\x00\x00\x01\x00\x00\x01\x00\x00\x00\x01\xFF", 11));
+	}
+
+	SECTION("scalar") {
+		checkKernel(&PacketBuffer::StreamVByte::decodeScalar);
+	}
+
+#if defined(PACKETBUFFER_BYTESWAP_X86)
+	SECTION("SSSE3") {
+		if(__builtin_cpu_supports("ssse3")) {
+			checkKernel(&PacketBuffer::StreamVByte::decodeSSSE3);
+		}
+	}
+
+	SECTION("AVX2") {
+		if(__builtin_cpu_supports("avx2")) {
+			checkKernel(&PacketBuffer::StreamVByte::decodeAVX2);
+		}
+	}
+#endif
+
+	SECTION("dispatched") {
+		checkKernel(&PacketBuffer::StreamVByte::decode);
+	}
+
+}
+
+TEST_CASE("StreamVByte/Vector", "[streamvbyte]") {
+
+	using VarintPacker = PacketBuffer::Packer<PacketBuffer::SpanWriter, boost::endian::order::little,
+			PacketBuffer::IntegerEncoding::Varint>;
+	using VarintUnpacker = PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::little,
+			PacketBuffer::IntegerEncoding::Varint, PacketBuffer::Bounds::Checked>;
+
+	const std::vector<uint32_t> values = makeValues(5000);
+	std::vector<char> storage(values.size() * 5 + 16);
+	PacketBuffer::SpanWriter writer(storage.data(), storage.size());
+	VarintPacker packer(writer);
+	packer.pack(values);
+
+	SECTION("should be smaller than fixed size integers") {
+		CHECK(writer.size() < values.size() * sizeof(uint32_t));
+	}
+
+	SECTION("should unpack back across blocks") {
+		PacketBuffer::SpanReader reader(storage.data(), writer.size());
+		VarintUnpacker unpacker(reader);
+
+		CHECK(unpacker.unpack<std::vector<uint32_t>>() == values);
+		CHECK(unpacker.good());
+		CHECK(reader.remaining() == 0);
+	}
+
+	SECTION("truncated input should fail") {
+		PacketBuffer::SpanReader reader(storage.data(), writer.size() - 1);
+		VarintUnpacker unpacker(reader);
+
+		unpacker.unpack<std::vector<uint32_t>>();
+		CHECK(unpacker.error() == PacketBuffer::UnpackError::Truncated);
+	}
+
+}
\ No newline at end of file
@@ -31,6 +31,7 @@
 #include <sstream>
 #include <algorithm>
 #include <stdexcept>
+#include <limits>
 
 #include <PacketBuffer/PacketBuffer.h>
 
@@ -55,359 +56,538 @@ std::string hex_to_string(const std::string& input) {
 	return output;
 }
 
-TEST_CASE("Unpacker", "[unpacker]") {
-
-	std::stringstream ss;
-
-	SECTION("little endian") {
-		PacketBuffer::Unpacker<std::istream, boost::endian::order::little> unpacker(ss);
+namespace {
+	/**
+	 * Unpacks from a std::stringstream.
+	 */
+	struct StreamInput {
+		using Buffer = std::istream;
 
-		SECTION("uint8_t") {
-			SECTION("min") {
-				ss.str(hex_to_string("00"));
-				CHECK(unpacker.unpack<uint8_t>() == 0);
-			}
-
-			SECTION("one") {
-				ss.str(hex_to_string("01"));
-				CHECK(unpacker.unpack<uint8_t>() == 1);
-			}
+		std::stringstream ss;
 
-			SECTION("max") {
-				ss.str(hex_to_string("FF"));
-				CHECK(unpacker.unpack<uint8_t>() == 255);
-			}
+		std::istream& buffer() {
+			return ss;
 		}
 
-		SECTION("int8_t") {
-			SECTION("min") {
-				ss.str(hex_to_string("80"));
-				CHECK(unpacker.unpack<int8_t>() == -128);
-			}
-
-			SECTION("zero") {
-				ss.str(hex_to_string("00"));
-				CHECK(unpacker.unpack<int8_t>() == 0);
-			}
-
-			SECTION("one") {
-				ss.str(hex_to_string("01"));
-				CHECK(unpacker.unpack<int8_t>() == 1);
-			}
-
-			SECTION("max") {
-				ss.str(hex_to_string("7F"));
-				CHECK(unpacker.unpack<int8_t>() == 127);
-			}
+		void feed(const std::string& hex) {
+			ss.str(hex_to_string(hex));
 		}
+	};
 
-		SECTION("uint16_t") {
-			SECTION("min") {
-				ss.str(hex_to_string("0000"));
-				CHECK(unpacker.unpack<uint16_t>() == 0);
-			}
+	/**
+	 * Unpacks from a SpanReader over a stack array.
+	 */
+	struct SpanInput {
+		using Buffer = PacketBuffer::SpanReader;
 
-			SECTION("one") {
-				ss.str(hex_to_string("0100"));
-				CHECK(unpacker.unpack<uint16_t>() == 1);
-			}
+		char storage[16];
+		PacketBuffer::SpanReader reader{storage, sizeof(storage)};
 
-			SECTION("max") {
-				ss.str(hex_to_string("FFFF"));
-				CHECK(unpacker.unpack<uint16_t>() == 65535);
-			}
+		PacketBuffer::SpanReader& buffer() {
+			return reader;
 		}
 
-		SECTION("int16_t") {
-			SECTION("min") {
-				ss.str(hex_to_string("0080"));
-				CHECK(unpacker.unpack<int16_t>() == -32768);
-			}
-
-			SECTION("zero") {
-				ss.str(hex_to_string("0000"));
-				CHECK(unpacker.unpack<int16_t>() == 0);
-			}
-
-			SECTION("one") {
-				ss.str(hex_to_string("0100"));
-				CHECK(unpacker.unpack<int16_t>() == 1);
-			}
-
-			SECTION("max") {
-				ss.str(hex_to_string("FF7F"));
-				CHECK(unpacker.unpack<int16_t>() == 32767);
-			}
+		void feed(const std::string& hex) {
+			const std::string input = hex_to_string(hex);
+			std::copy(input.begin(), input.end(), storage);
+			reader.reset();
 		}
+	};
+
+	/**
+	 * Checks the unpacked value of every arithmetic type in both byte orders
+	 * when unpacked from the buffer provided by <tt>Input</tt>.
+	 */
+	template<typename Input>
+	void checkUnpacker() {
+
+		Input input;
+
+		SECTION("little endian") {
+			PacketBuffer::Unpacker<typename Input::Buffer, boost::endian::order::little> unpacker(input.buffer());
+
+			SECTION("uint8_t") {
+				SECTION("min") {
+					input.feed("00");
+					CHECK(unpacker.template unpack<uint8_t>() == 0);
+				}
+
+				SECTION("one") {
+					input.feed("01");
+					CHECK(unpacker.template unpack<uint8_t>() == 1);
+				}
+
+				SECTION("max") {
+					input.feed("FF");
+					CHECK(unpacker.template unpack<uint8_t>() == 255);
+				}
+			}
+
+			SECTION("int8_t") {
+				SECTION("min") {
+					input.feed("80");
+					CHECK(unpacker.template unpack<int8_t>() == -128);
+				}
+
+				SECTION("zero") {
+					input.feed("00");
+					CHECK(unpacker.template unpack<int8_t>() == 0);
+				}
+
+				SECTION("one") {
+					input.feed("01");
+					CHECK(unpacker.template unpack<int8_t>() == 1);
+				}
+
+				SECTION("max") {
+					input.feed("7F");
+					CHECK(unpacker.template unpack<int8_t>() == 127);
+				}
+			}
+
+			SECTION("uint16_t") {
+				SECTION("min") {
+					input.feed("0000");
+					CHECK(unpacker.template unpack<uint16_t>() == 0);
+				}
+
+				SECTION("one") {
+					input.feed("0100");
+					CHECK(unpacker.template unpack<uint16_t>() == 1);
+				}
+
+				SECTION("max") {
+					input.feed("FFFF");
+					CHECK(unpacker.template unpack<uint16_t>() == 65535);
+				}
+			}
+
+			SECTION("int16_t") {
+				SECTION("min") {
+					input.feed("0080");
+					CHECK(unpacker.template unpack<int16_t>() == -32768);
+				}
+
+				SECTION("zero") {
+					input.feed("0000");
+					CHECK(unpacker.template unpack<int16_t>() == 0);
+				}
+
+				SECTION("one") {
+					input.feed("0100");
+					CHECK(unpacker.template unpack<int16_t>() == 1);
+				}
+
+				SECTION("max") {
+					input.feed("FF7F");
+					CHECK(unpacker.template unpack<int16_t>() == 32767);
+				}
+			}
+
+			SECTION("uint32_t") {
+				SECTION("min") {
+					input.feed("00000000");
+					CHECK(unpacker.template unpack<uint32_t>() == 0);
+				}
+
+				SECTION("one") {
+					input.feed("01000000");
+					CHECK(unpacker.template unpack<uint32_t>() == 1);
+				}
+
+				SECTION("max") {
+					input.feed("FFFFFFFF");
+					CHECK(unpacker.template unpack<uint32_t>() == 4294967295);
+				}
+			}
 
-		SECTION("uint32_t") {
-			SECTION("min") {
-				ss.str(hex_to_string("00000000"));
-				CHECK(unpacker.unpack<uint32_t>() == 0);
-			}
+			SECTION("int32_t") {
+				SECTION("min") {
+					input.feed("00000080");
+					CHECK(unpacker.template unpack<int32_t>() == -2147483648);
+				}
+
+				SECTION("zero") {
+					input.feed("00000000");
+					CHECK(unpacker.template unpack<int32_t>() == 0);
+				}
+
+				SECTION("one") {
+					input.feed("01000000");
+					CHECK(unpacker.template unpack<int32_t>() == 1);
+				}
 
-			SECTION("one") {
-				ss.str(hex_to_string("01000000"));
-				CHECK(unpacker.unpack<uint32_t>() == 1);
+				SECTION("max") {
+					input.feed("FFFFFF7F");
+					CHECK(unpacker.template unpack<int32_t>() == 2147483647);
+				}
 			}
 
-			SECTION("max") {
-				ss.str(hex_to_string("FFFFFFFF"));
-				CHECK(unpacker.unpack<uint32_t>() == 4294967295);
-			}
-		}
+			SECTION("uint64_t") {
+				SECTION("min") {
+					input.feed("0000000000000000");
+					CHECK(unpacker.template unpack<uint64_t>() == 0);
+				}
+
+				SECTION("one") {
+					input.feed("0100000000000000");
+					CHECK(unpacker.template unpack<uint64_t>() == 1);
+				}
 
-		SECTION("int32_t") {
-			SECTION("min") {
-				ss.str(hex_to_string("00000080"));
-				CHECK(unpacker.unpack<int32_t>() == -2147483648);
+				SECTION("max") {
+					input.feed("FFFFFFFFFFFFFFFF");
+					CHECK(unpacker.template unpack<uint64_t>() == 18446744073709551615UL);
+				}
 			}
 
-			SECTION("zero") {
-				ss.str(hex_to_string("00000000"));
-				CHECK(unpacker.unpack<int32_t>() == 0);
-			}
+			SECTION("int64_t") {
+				SECTION("min") {
+					input.feed("0000000000000080");
+					CHECK(unpacker.template unpack<int64_t>() == std::numeric_limits<int64_t>::min());
+				}
+
+				SECTION("zero") {
+					input.feed("0000000000000000");
+					CHECK(unpacker.template unpack<int64_t>() == 0);
+				}
+
+				SECTION("one") {
+					input.feed("0100000000000000");
+					CHECK(unpacker.template unpack<int64_t>() == 1);
+				}
 
-			SECTION("one") {
-				ss.str(hex_to_string("01000000"));
-				CHECK(unpacker.unpack<int32_t>() == 1);
+				SECTION("max") {
+					input.feed("FFFFFFFFFFFFFF7F");
+					CHECK(unpacker.template unpack<int64_t>() == std::numeric_limits<int64_t>::max());
+				}
 			}
 
-			SECTION("max") {
-				ss.str(hex_to_string("FFFFFF7F"));
-				CHECK(unpacker.unpack<int32_t>() == 2147483647);
-			}
-		}
+			SECTION("bool") {
+				SECTION("true") {
+					input.feed("01");
+					CHECK(unpacker.template unpack<bool>() == true);
+				}
 
-		SECTION("uint64_t") {
-			SECTION("min") {
-				ss.str(hex_to_string("0000000000000000"));
-				CHECK(unpacker.unpack<uint64_t>() == 0);
+				SECTION("false") {
+					input.feed("00");
+					CHECK(unpacker.template unpack<bool>() == false);
+				}
 			}
 
-			SECTION("one") {
-				ss.str(hex_to_string("0100000000000000"));
-				CHECK(unpacker.unpack<uint64_t>() == 1);
+			SECTION("float") {
+				input.feed("0000803F");
+				CHECK(unpacker.template unpack<float>() == 1.0f);
 			}
 
-			SECTION("max") {
-				ss.str(hex_to_string("FFFFFFFFFFFFFFFF"));
-				CHECK(unpacker.unpack<uint64_t>() == 18446744073709551615UL);
+			SECTION("double") {
+				input.feed("000000000000F0BF");
+				CHECK(unpacker.template unpack<double>() == -1.0);
 			}
 		}
 
-		SECTION("int64_t") {
-			SECTION("min") {
-				ss.str(hex_to_string("0000000000000080"));
-				CHECK(unpacker.unpack<int64_t>() == -9223372036854775808L);
-			}
+		SECTION("big endian") {
+			PacketBuffer::Unpacker<typename Input::Buffer, boost::endian::order::big> unpacker(input.buffer());
+
+			SECTION("uint8_t") {
+				SECTION("min") {
+					input.feed("00");
+					CHECK(unpacker.template unpack<uint8_t>() == 0);
+				}
+
+				SECTION("one") {
+					input.feed("01");
+					CHECK(unpacker.template unpack<uint8_t>() == 1);
+				}
+
+				SECTION("max") {
+					input.feed("FF");
+					CHECK(unpacker.template unpack<uint8_t>() == 255);
+				}
+			}
+
+			SECTION("int8_t") {
+				SECTION("min") {
+					input.feed("80");
+					CHECK(unpacker.template unpack<int8_t>() == -128);
+				}
+
+				SECTION("zero") {
+					input.feed("00");
+					CHECK(unpacker.template unpack<int8_t>() == 0);
+				}
+
+				SECTION("one") {
+					input.feed("01");
+					CHECK(unpacker.template unpack<int8_t>() == 1);
+				}
+
+				SECTION("max") {
+					input.feed("7F");
+					CHECK(unpacker.template unpack<int8_t>() == 127);
+				}
+			}
+
+			SECTION("uint16_t") {
+				SECTION("min") {
+					input.feed("0000");
+					CHECK(unpacker.template unpack<uint16_t>() == 0);
+				}
+
+				SECTION("one") {
+					input.feed("0001");
+					CHECK(unpacker.template unpack<uint16_t>() == 1);
+				}
+
+				SECTION("max") {
+					input.feed("FFFF");
+					CHECK(unpacker.template unpack<uint16_t>() == 65535);
+				}
+			}
+
+			SECTION("int16_t") {
+				SECTION("min") {
+					input.feed("8000");
+					CHECK(unpacker.template unpack<int16_t>() == -32768);
+				}
+
+				SECTION("zero") {
+					input.feed("0000");
+					CHECK(unpacker.template unpack<int16_t>() == 0);
+				}
+
+				SECTION("one") {
+					input.feed("0001");
+					CHECK(unpacker.template unpack<int16_t>() == 1);
+				}
+
+				SECTION("max") {
+					input.feed("7FFF");
+					CHECK(unpacker.template unpack<int16_t>() == 32767);
+				}
+			}
+
+			SECTION("uint32_t") {
+				SECTION("min") {
+					input.feed("00000000");
+					CHECK(unpacker.template unpack<uint32_t>() == 0);
+				}
+
+				SECTION("one") {
+					input.feed("00000001");
+					CHECK(unpacker.template unpack<uint32_t>() == 1);
+				}
+
+				SECTION("max") {
+					input.feed("FFFFFFFF");
+					CHECK(unpacker.template unpack<uint32_t>() == 4294967295);
+				}
+			}
+
+			SECTION("int32_t") {
+				SECTION("min") {
+					input.feed("80000000");
+					CHECK(unpacker.template unpack<int32_t>() == -2147483648);
+				}
+
+				SECTION("zero") {
+					input.feed("00000000");
+					CHECK(unpacker.template unpack<int32_t>() == 0);
+				}
+
+				SECTION("one") {
+					input.feed("00000001");
+					CHECK(unpacker.template unpack<int32_t>() == 1);
+				}
 
-			SECTION("zero") {
-				ss.str(hex_to_string("0000000000000000"));
-				CHECK(unpacker.unpack<int64_t>() == 0);
+				SECTION("max") {
+					input.feed("7FFFFFFF");
+					CHECK(unpacker.template unpack<int32_t>() == 2147483647);
+				}
 			}
 
-			SECTION("one") {
-				ss.str(hex_to_string("0100000000000000"));
-				CHECK(unpacker.unpack<int64_t>() == 1);
-			}
+			SECTION("uint64_t") {
+				SECTION("min") {
+					input.feed("0000000000000000");
+					CHECK(unpacker.template unpack<uint64_t>() == 0);
+				}
+
+				SECTION("one") {
+					input.feed("0000000000000001");
+					CHECK(unpacker.template unpack<uint64_t>() == 1);
+				}
 
-			SECTION("max") {
-				ss.str(hex_to_string("FFFFFFFFFFFFFF7F"));
-				CHECK(unpacker.unpack<int64_t>() == 9223372036854775807L);
+				SECTION("max") {
+					input.feed("FFFFFFFFFFFFFFFF");
+					CHECK(unpacker.template unpack<uint64_t>() == 18446744073709551615UL);
+				}
 			}
-		}
 
-		SECTION("bool") {
-			SECTION("true") {
-				ss.str(hex_to_string("01"));
-				CHECK(unpacker.unpack<bool>() == true);
-			}
+			SECTION("int64_t") {
+				SECTION("min") {
+					input.feed("8000000000000000");
+					CHECK(unpacker.template unpack<int64_t>() == std::numeric_limits<int64_t>::min());
+				}
+
+				SECTION("zero") {
+					input.feed("0000000000000000");
+					CHECK(unpacker.template unpack<int64_t>() == 0);
+				}
+
+				SECTION("one") {
+					input.feed("0000000000000001");
+					CHECK(unpacker.template unpack<int64_t>() == 1);
+				}
 
-			SECTION("false") {
-				ss.str(hex_to_string("00"));
-				CHECK(unpacker.unpack<bool>() == false);
+				SECTION("max") {
+					input.feed("7FFFFFFFFFFFFFFF");
+					CHECK(unpacker.template unpack<int64_t>() == std::numeric_limits<int64_t>::max());
+				}
 			}
-		}
-	}
 
-	SECTION("big endian") {
-		PacketBuffer::Unpacker<std::istream, boost::endian::order::big> unpacker(ss);
+			SECTION("bool") {
+				SECTION("true") {
+					input.feed("01");
+					CHECK(unpacker.template unpack<bool>() == true);
+				}
 
-		SECTION("uint8_t") {
-			SECTION("min") {
-				ss.str(hex_to_string("00"));
-				CHECK(unpacker.unpack<uint8_t>() == 0);
+				SECTION("false") {
+					input.feed("00");
+					CHECK(unpacker.template unpack<bool>() == false);
+				}
 			}
 
-			SECTION("one") {
-				ss.str(hex_to_string("01"));
-				CHECK(unpacker.unpack<uint8_t>() == 1);
+			SECTION("float") {
+				input.feed("3F800000");
+				CHECK(unpacker.template unpack<float>() == 1.0f);
 			}
 
-			SECTION("max") {
-				ss.str(hex_to_string("FF"));
-				CHECK(unpacker.unpack<uint8_t>() == 255);
+			SECTION("double") {
+				input.feed("BFF0000000000000");
+				CHECK(unpacker.template unpack<double>() == -1.0);
 			}
 		}
 
-		SECTION("int8_t") {
-			SECTION("min") {
-				ss.str(hex_to_string("80"));
-				CHECK(unpacker.unpack<int8_t>() == -128);
-			}
+		SECTION("should throw an error on overflow") {
+			PacketBuffer::Unpacker<typename Input::Buffer> unpacker(input.buffer());
 
-			SECTION("zero") {
-				ss.str(hex_to_string("00"));
-				CHECK(unpacker.unpack<int8_t>() == 0);
-			}
+//        REQUIRE_THROWS(unpacker.unpack<uint32_t>());
+		}
+	}
+}
 
-			SECTION("one") {
-				ss.str(hex_to_string("01"));
-				CHECK(unpacker.unpack<int8_t>() == 1);
-			}
+TEST_CASE("Unpacker", "[unpacker]") {
+	SECTION("std::istream") {
+		checkUnpacker<StreamInput>();
+	}
 
-			SECTION("max") {
-				ss.str(hex_to_string("7F"));
-				CHECK(unpacker.unpack<int8_t>() == 127);
-			}
-		}
+	SECTION("SpanReader") {
+		checkUnpacker<SpanInput>();
+	}
+}
 
-		SECTION("uint16_t") {
-			SECTION("min") {
-				ss.str(hex_to_string("0000"));
-				CHECK(unpacker.unpack<uint16_t>() == 0);
-			}
+TEST_CASE("Unpacker/Bounds", "[unpacker][bounds]") {
 
-			SECTION("one") {
-				ss.str(hex_to_string("0001"));
-				CHECK(unpacker.unpack<uint16_t>() == 1);
-			}
+	using Unpacker = PacketBuffer::Unpacker<PacketBuffer::SpanReader,
+			boost::endian::order::little, PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked>;
 
-			SECTION("max") {
-				ss.str(hex_to_string("FFFF"));
-				CHECK(unpacker.unpack<uint16_t>() == 65535);
-			}
-		}
+	SECTION("should unpack complete input") {
+		std::string input = hex_to_string("0100000002");
+		PacketBuffer::SpanReader reader(input.data(), input.size());
+		Unpacker unpacker(reader);
 
-		SECTION("int16_t") {
-			SECTION("min") {
-				ss.str(hex_to_string("8000"));
-				CHECK(unpacker.unpack<int16_t>() == -32768);
-			}
+		CHECK(unpacker.unpack<uint32_t>() == 1);
+		CHECK(unpacker.unpack<uint8_t>() == 2);
+		CHECK(unpacker.good());
+		CHECK(unpacker.remaining() == 0);
+	}
 
-			SECTION("zero") {
-				ss.str(hex_to_string("0000"));
-				CHECK(unpacker.unpack<int16_t>() == 0);
-			}
+	SECTION("should fail on truncated input") {
+		std::string input = hex_to_string("010000");
+		PacketBuffer::SpanReader reader(input.data(), input.size());
+		Unpacker unpacker(reader);
 
-			SECTION("one") {
-				ss.str(hex_to_string("0001"));
-				CHECK(unpacker.unpack<int16_t>() == 1);
-			}
+		CHECK(unpacker.unpack<uint32_t>() == 0);
+		CHECK(unpacker.error() == PacketBuffer::UnpackError::Truncated);
+		CHECK(reader.remaining() == 0);
 
-			SECTION("max") {
-				ss.str(hex_to_string("7FFF"));
-				CHECK(unpacker.unpack<int16_t>() == 32767);
-			}
+		SECTION("and should short-circuit further reads") {
+			CHECK(unpacker.unpack<uint8_t>() == 0);
+			CHECK(unpacker.error() == PacketBuffer::UnpackError::Truncated);
+			CHECK(reader.remaining() == 0);
 		}
+	}
 
-		SECTION("uint32_t") {
-			SECTION("min") {
-				ss.str(hex_to_string("00000000"));
-				CHECK(unpacker.unpack<uint32_t>() == 0);
-			}
+	SECTION("should honor an explicit input length") {
+		std::stringstream ss(hex_to_string("01000000020000000000"));
+		PacketBuffer::Unpacker<std::istream, boost::endian::order::little,
+				PacketBuffer::IntegerEncoding::Fixed, PacketBuffer::Bounds::Checked> unpacker(ss, 6);
 
-			SECTION("one") {
-				ss.str(hex_to_string("00000001"));
-				CHECK(unpacker.unpack<uint32_t>() == 1);
-			}
+		CHECK(unpacker.unpack<uint32_t>() == 1);
+		CHECK(unpacker.unpack<uint32_t>() == 0);
+		CHECK_FALSE(unpacker);
+	}
 
-			SECTION("max") {
-				ss.str(hex_to_string("FFFFFFFF"));
-				CHECK(unpacker.unpack<uint32_t>() == 4294967295);
-			}
-		}
+	SECTION("should reject a string longer than the input") {
+		std::string input = hex_to_string("FFFFFFFFFFFFFF7F41");
+		PacketBuffer::SpanReader reader(input.data(), input.size());
+		Unpacker unpacker(reader);
 
-		SECTION("int32_t") {
-			SECTION("min") {
-				ss.str(hex_to_string("80000000"));
-				CHECK(unpacker.unpack<int32_t>() == -2147483648);
-			}
+		CHECK(unpacker.unpack<std::string>().empty());
+		CHECK(unpacker.error() == PacketBuffer::UnpackError::LengthTooLarge);
+	}
 
-			SECTION("zero") {
-				ss.str(hex_to_string("00000000"));
-				CHECK(unpacker.unpack<int32_t>() == 0);
-			}
+	SECTION("should reject a vector longer than the input") {
+		std::string input = hex_to_string("0300000000000000010000000200000000");
+		PacketBuffer::SpanReader reader(input.data(), input.size());
+		Unpacker unpacker(reader);
 
-			SECTION("one") {
-				ss.str(hex_to_string("00000001"));
-				CHECK(unpacker.unpack<int32_t>() == 1);
-			}
+		CHECK(unpacker.unpack<std::vector<uint32_t>>().empty());
+		CHECK(unpacker.error() == PacketBuffer::UnpackError::LengthTooLarge);
+	}
 
-			SECTION("max") {
-				ss.str(hex_to_string("7FFFFFFF"));
-				CHECK(unpacker.unpack<int32_t>() == 2147483647);
-			}
-		}
+}
 
-		SECTION("uint64_t") {
-			SECTION("min") {
-				ss.str(hex_to_string("0000000000000000"));
-				CHECK(unpacker.unpack<uint64_t>() == 0);
-			}
+TEST_CASE("Unpacker/Limits", "[unpacker][limits]") {
 
-			SECTION("one") {
-				ss.str(hex_to_string("0000000000000001"));
-				CHECK(unpacker.unpack<uint64_t>() == 1);
-			}
+	SECTION("should reject containers longer than the input") {
+		std::string input = hex_to_string("00000000000000800102");
+		PacketBuffer::SpanReader reader(input.data(), input.size());
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader> unpacker(reader);
 
-			SECTION("max") {
-				ss.str(hex_to_string("FFFFFFFFFFFFFFFF"));
-				CHECK(unpacker.unpack<uint64_t>() == 18446744073709551615UL);
-			}
-		}
+		std::list<uint16_t> list;
+		unpacker.unpack(list);
 
-		SECTION("int64_t") {
-			SECTION("min") {
-				ss.str(hex_to_string("8000000000000000"));
-				CHECK(unpacker.unpack<int64_t>() == -9223372036854775808L);
-			}
+		CHECK(list.empty());
+		CHECK(unpacker.error() == PacketBuffer::UnpackError::LengthTooLarge);
+	}
 
-			SECTION("zero") {
-				ss.str(hex_to_string("0000000000000000"));
-				CHECK(unpacker.unpack<int64_t>() == 0);
-			}
+	SECTION("should reject containers with too many elements") {
+		std::string input = hex_to_string("0300000000000000010203");
+		PacketBuffer::Limits limits;
+		limits.maxElements = 2;
 
-			SECTION("one") {
-				ss.str(hex_to_string("0000000000000001"));
-				CHECK(unpacker.unpack<int64_t>() == 1);
-			}
+		PacketBuffer::SpanReader reader(input.data(), input.size());
+		PacketBuffer::Unpacker<PacketBuffer::SpanReader> unpacker(reader, limits);
 
-			SECTION("max") {
-				ss.str(hex_to_string("7FFFFFFFFFFFFFFF"));
-				CHECK(unpacker.unpack<int64_t>() == 9223372036854775807L);
-			}
-		}
+		CHECK(unpacker.unpack<std::vector<uint8_t>>().empty());
+		CHECK(unpacker.error() == PacketBuffer::UnpackError::LimitExceeded);
+	}
 
-		SECTION("bool") {
-			SECTION("true") {
-				ss.str(hex_to_string("01"));
-				CHECK(unpacker.unpack<bool>() == true);
-			}
+	SECTION("should charge every container against the allocation budget") {
+		std::string input = hex_to_string("0200000000000000010002000200000000000000030004000200000000000000");
+		PacketBuffer::Limits limits;
+		limits.allocationBudget = 8;
 
-			SECTION("false") {
-				ss.str(hex_to_string("00"));
-				CHECK(unpacker.unpack<bool>() == false);
-			}
-		}
-	}
+		std::stringstream ss(input);
+		PacketBuffer::Unpacker<std::istream> unpacker(ss, limits);
 
-	SECTION("should throw an error on overflow") {
-		PacketBuffer::Unpacker<std::istream> unpacker(ss);
+		CHECK(unpacker.unpack<std::vector<uint16_t>>().size() == 2);
+		CHECK(unpacker.unpack<std::set<uint16_t>>().size() == 2);
+		CHECK(unpacker.getLimits().allocationBudget == 0);
+		CHECK(unpacker.good());
 
-//        REQUIRE_THROWS(unpacker.unpack<uint32_t>());
+		CHECK(unpacker.unpack<std::vector<uint16_t>>().empty());
+		CHECK(unpacker.error() == PacketBuffer::UnpackError::LimitExceeded);
 	}
 
-
 }
\ No newline at end of file
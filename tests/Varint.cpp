@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2017, Rogiel Sulzbach
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of Rogiel Sulzbach nor the names of contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <catch.hpp>
+#include <sstream>
+
+#include <PacketBuffer/PacketBuffer.h>
+
+namespace {
+	std::string string_to_hex(const std::string& input) {
+		static const char* const lut = "0123456789ABCDEF";
+		size_t len = input.length();
+
+		std::string output;
+		output.reserve(2 * len);
+		for(size_t i = 0; i < len; ++i) {
+			const unsigned char c = input[i];
+			output.push_back(lut[c >> 4]);
+			output.push_back(lut[c & 15]);
+		}
+		return output;
+	}
+
+	using VarintPacker = PacketBuffer::Packer<std::ostream, boost::endian::order::little,
+			PacketBuffer::IntegerEncoding::Varint>;
+	using VarintUnpacker = PacketBuffer::Unpacker<std::istream, boost::endian::order::little,
+			PacketBuffer::IntegerEncoding::Varint, PacketBuffer::Bounds::Unchecked>;
+	using CheckedVarintUnpacker = PacketBuffer::Unpacker<PacketBuffer::SpanReader, boost::endian::order::little,
+			PacketBuffer::IntegerEncoding::Varint, PacketBuffer::Bounds::Checked>;
+}
+
+TEST_CASE("Varint", "[varint]") {
+
+	SECTION("encoding") {
+		char bytes[PacketBuffer::Varint::MaxLength];
+
+		CHECK(PacketBuffer::Varint::encode(0, bytes) == 1);
+		CHECK(PacketBuffer::Varint::encode(127, bytes) == 1);
+		CHECK(PacketBuffer::Varint::encode(300, bytes) == 2);
+		CHECK(string_to_hex(std::string(bytes, 2)) == "AC02");
+		CHECK(PacketBuffer::Varint::encode(UINT64_MAX, bytes) == 10);
+		CHECK(PacketBuffer::Varint::length(UINT64_MAX) == 10);
+		CHECK(PacketBuffer::Varint::length(16383) == 2);
+		CHECK(PacketBuffer::Varint::length(16384) == 3);
+	}
+
+	SECTION("zigzag") {
+		CHECK(PacketBuffer::Varint::zigzag(0) == 0);
+		CHECK(PacketBuffer::Varint::zigzag(-1) == 1);
+		CHECK(PacketBuffer::Varint::zigzag(1) == 2);
+		CHECK(PacketBuffer::Varint::zigzag(INT64_MIN) == UINT64_MAX);
+		CHECK(PacketBuffer::Varint::unzigzag(UINT64_MAX) == INT64_MIN);
+		CHECK(PacketBuffer::Varint::unzigzag(PacketBuffer::Varint::zigzag(INT64_MAX)) == INT64_MAX);
+	}
+
+}
+
+TEST_CASE("Varint/Length", "[varint]") {
+
+	std::stringstream ss;
+	PacketBuffer::Packer<std::ostream, boost::endian::order::little,
+			PacketBuffer::IntegerEncoding::VarintLength> packer(ss);
+	PacketBuffer::Unpacker<std::istream, boost::endian::order::little,
+			PacketBuffer::IntegerEncoding::VarintLength, PacketBuffer::Bounds::Unchecked> unpacker(ss);
+
+	SECTION("empty string should be correctly packed") {
+		packer.pack(std::string());
+
+		CHECK(string_to_hex(ss.str()) == "00");
+
+		SECTION("and should unpack back") {
+			CHECK(unpacker.unpack<std::string>().empty());
+		}
+	}
+
+	SECTION("integers should keep their fixed size") {
+		std::vector<uint32_t> vector = {1, 0xDEADBEEF};
+		packer.pack(vector);
+
+		CHECK(string_to_hex(ss.str()) == "0201000000EFBEADDE");
+
+		SECTION("and should unpack back") {
+			CHECK(unpacker.unpack<std::vector<uint32_t>>() == vector);
+		}
+	}
+
+}
+
+TEST_CASE("Varint/Integers", "[varint]") {
+
+	std::stringstream ss;
+	VarintPacker packer(ss);
+	VarintUnpacker unpacker(ss);
+
+	SECTION("unsigned integers should be correctly packed") {
+		packer.pack(uint16_t(1), uint32_t(300), uint64_t(UINT64_MAX));
+
+		CHECK(string_to_hex(ss.str()) == "01AC02FFFFFFFFFFFFFFFFFF01");
+
+		SECTION("and should unpack back") {
+			CHECK(unpacker.unpack<uint16_t>() == 1);
+			CHECK(unpacker.unpack<uint32_t>() == 300);
+			CHECK(unpacker.unpack<uint64_t>() == UINT64_MAX);
+		}
+	}
+
+	SECTION("signed integers should be ZigZag encoded") {
+		packer.pack(int16_t(-1), int32_t(1), int64_t(INT64_MIN));
+
+		CHECK(string_to_hex(ss.str()) == "0102FFFFFFFFFFFFFFFFFF01");
+
+		SECTION("and should unpack back") {
+			CHECK(unpacker.unpack<int16_t>() == -1);
+			CHECK(unpacker.unpack<int32_t>() == 1);
+			CHECK(unpacker.unpack<int64_t>() == INT64_MIN);
+		}
+	}
+
+	SECTION("bytes and floats should keep their fixed size") {
+		packer.pack(uint8_t(0xFF), 1.0f);
+
+		CHECK(string_to_hex(ss.str()) == "FF0000803F");
+	}
+
+	SECTION("vectors should be packed element by element") {
+		std::vector<uint64_t> vector = {1, 0xDEADBEEF};
+		packer.pack(vector);
+
+		CHECK(string_to_hex(ss.str()) == "0201EFFDB6F50D");
+
+		SECTION("and should unpack back") {
+			CHECK(unpacker.unpack<std::vector<uint64_t>>() == vector);
+		}
+	}
+
+	SECTION("uint32_t vectors should be packed with StreamVByte") {
+		std::vector<uint32_t> vector = {1, 0xDEADBEEF};
+		packer.pack(vector);
+
+		CHECK(string_to_hex(ss.str()) == "020C01EFBEADDE");
+
+		SECTION("and should unpack back") {
+			CHECK(unpacker.unpack<std::vector<uint32_t>>() == vector);
+		}
+	}
+
+}
+
+TEST_CASE("Varint/Errors", "[varint]") {
+
+	SECTION("values that do not fit the integer should fail") {
+		const unsigned char input[] = {0x80, 0x80, 0x04};
+		PacketBuffer::SpanReader reader(input, sizeof(input));
+		CheckedVarintUnpacker unpacker(reader);
+
+		CHECK(unpacker.unpack<uint16_t>() == 0);
+		CHECK(unpacker.error() == PacketBuffer::UnpackError::Overflow);
+	}
+
+	SECTION("varints longer than 10 bytes should fail") {
+		const unsigned char input[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0x01};
+		PacketBuffer::SpanReader reader(input, sizeof(input));
+		CheckedVarintUnpacker unpacker(reader);
+
+		CHECK(unpacker.unpack<uint64_t>() == 0);
+		CHECK(unpacker.error() == PacketBuffer::UnpackError::Overflow);
+	}
+
+	SECTION("varints with more than 64 bits should fail") {
+		const unsigned char input[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x02};
+		PacketBuffer::SpanReader reader(input, sizeof(input));
+		CheckedVarintUnpacker unpacker(reader);
+
+		CHECK(unpacker.unpack<uint64_t>() == 0);
+		CHECK(unpacker.error() == PacketBuffer::UnpackError::Overflow);
+	}
+
+	SECTION("truncated varints should fail") {
+		const unsigned char input[] = {0xAC};
+		PacketBuffer::SpanReader reader(input, sizeof(input));
+		CheckedVarintUnpacker unpacker(reader);
+
+		unpacker.unpack<uint32_t>();
+		CHECK(unpacker.error() == PacketBuffer::UnpackError::Truncated);
+	}
+
+	SECTION("container lengths should be checked against one byte per element") {
+		const unsigned char input[] = {0x03, 0x01, 0x02};
+		PacketBuffer::SpanReader reader(input, sizeof(input));
+		CheckedVarintUnpacker unpacker(reader);
+
+		CHECK(unpacker.unpack<std::vector<uint64_t>>().empty());
+		CHECK(unpacker.error() == PacketBuffer::UnpackError::LengthTooLarge);
+	}
+
+}
\ No newline at end of file